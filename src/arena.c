@@ -0,0 +1,273 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "arena.h"
+
+
+/* Arena */
+/* private */
+/* types */
+typedef struct _ArenaBlock ArenaBlock;
+
+struct _ArenaBlock
+{
+	ArenaBlock * next;
+	size_t size;
+	size_t used;
+};
+
+struct _Arena
+{
+	/* shared by every loader thread, so it limits how they scale; it is
+	 * only held for a few instructions per object or string though, far
+	 * less than reading and parsing a task. Blocks for each thread would
+	 * avoid it, but the threads of the pool outlive the arena */
+	GMutex mutex;
+
+	/* objects */
+	size_t size;
+	ArenaBlock * slabs;
+	void * available;
+	size_t count;
+
+	/* strings */
+	ArenaBlock * strings;
+
+	/* statistics */
+	size_t total;
+};
+
+
+/* constants */
+#define ARENA_ALIGN		(2 * sizeof(void *))
+#define ARENA_HEADER		((sizeof(ArenaBlock) + ARENA_ALIGN - 1) \
+		& ~(ARENA_ALIGN - 1))
+#define ARENA_SLAB_COUNT	256
+#define ARENA_STRINGS_SIZE	65536
+
+
+/* prototypes */
+static ArenaBlock * _arena_block_new(Arena * arena, size_t size);
+
+
+/* public */
+/* functions */
+/* arena_new */
+Arena * arena_new(size_t size)
+{
+	Arena * arena;
+
+	if((arena = object_new(sizeof(*arena))) == NULL)
+		return NULL;
+	g_mutex_init(&arena->mutex);
+	/* the objects available are linked through their first bytes */
+	if(size < sizeof(void *))
+		size = sizeof(void *);
+	arena->size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	arena->slabs = NULL;
+	arena->available = NULL;
+	arena->count = 0;
+	arena->strings = NULL;
+	arena->total = 0;
+	return arena;
+}
+
+
+/* arena_delete */
+static void _delete_blocks(ArenaBlock * block);
+
+void arena_delete(Arena * arena)
+{
+	/* the objects and strings are released all at once */
+	_delete_blocks(arena->slabs);
+	_delete_blocks(arena->strings);
+	g_mutex_clear(&arena->mutex);
+	object_delete(arena);
+}
+
+static void _delete_blocks(ArenaBlock * block)
+{
+	ArenaBlock * next;
+
+	for(; block != NULL; block = next)
+	{
+		next = block->next;
+		free(block);
+	}
+}
+
+
+/* accessors */
+/* arena_get_count */
+size_t arena_get_count(Arena * arena)
+{
+	size_t ret;
+
+	g_mutex_lock(&arena->mutex);
+	ret = arena->count;
+	g_mutex_unlock(&arena->mutex);
+	return ret;
+}
+
+
+/* arena_get_size */
+size_t arena_get_size(Arena * arena)
+{
+	size_t ret;
+
+	g_mutex_lock(&arena->mutex);
+	ret = arena->total;
+	g_mutex_unlock(&arena->mutex);
+	return ret;
+}
+
+
+/* useful */
+/* arena_alloc */
+void * arena_alloc(Arena * arena)
+{
+	void * ret;
+	ArenaBlock * slab;
+
+	g_mutex_lock(&arena->mutex);
+	if((ret = arena->available) != NULL)
+		/* re-use the objects freed first */
+		arena->available = *(void **)ret;
+	else
+	{
+		if((slab = arena->slabs) == NULL || slab->used == slab->size)
+		{
+			if((slab = _arena_block_new(arena, arena->size
+							* ARENA_SLAB_COUNT))
+					!= NULL)
+			{
+				slab->next = arena->slabs;
+				arena->slabs = slab;
+			}
+		}
+		if(slab != NULL)
+		{
+			ret = (char *)slab + ARENA_HEADER + slab->used;
+			slab->used += arena->size;
+		}
+	}
+	if(ret != NULL)
+		arena->count++;
+	g_mutex_unlock(&arena->mutex);
+	return ret;
+}
+
+
+/* arena_free */
+void arena_free(Arena * arena, void * object)
+{
+	if(object == NULL)
+		return;
+	g_mutex_lock(&arena->mutex);
+	*(void **)object = arena->available;
+	arena->available = object;
+	arena->count--;
+	g_mutex_unlock(&arena->mutex);
+}
+
+
+/* arena_strdup */
+static ArenaBlock * _strdup_block(Arena * arena, size_t len);
+
+char * arena_strdup(Arena * arena, char const * string)
+{
+	char * ret = NULL;
+	size_t len = strlen(string) + 1;
+	ArenaBlock * block;
+
+	g_mutex_lock(&arena->mutex);
+	/* the strings are only released with the arena */
+	if((block = arena->strings) == NULL
+			|| block->size - block->used < len)
+		block = _strdup_block(arena, len);
+	if(block != NULL)
+	{
+		ret = (char *)block + ARENA_HEADER + block->used;
+		memcpy(ret, string, len);
+		block->used += len;
+	}
+	g_mutex_unlock(&arena->mutex);
+	return ret;
+}
+
+static ArenaBlock * _strdup_block(Arena * arena, size_t len)
+{
+	ArenaBlock * block;
+
+	if(len <= ARENA_STRINGS_SIZE / 4)
+	{
+		if((block = _arena_block_new(arena, ARENA_STRINGS_SIZE))
+				!= NULL)
+		{
+			block->next = arena->strings;
+			arena->strings = block;
+		}
+	}
+	/* the large strings do not interrupt the current block */
+	else if((block = _arena_block_new(arena, len)) != NULL)
+	{
+		if(arena->strings != NULL)
+		{
+			block->next = arena->strings->next;
+			arena->strings->next = block;
+		}
+		else
+			arena->strings = block;
+	}
+	return block;
+}
+
+
+/* private */
+/* functions */
+/* arena_block_new */
+static ArenaBlock * _arena_block_new(Arena * arena, size_t size)
+{
+	ArenaBlock * block;
+
+	if((block = malloc(ARENA_HEADER + size)) == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		return NULL;
+	}
+	block->next = NULL;
+	block->size = size;
+	block->used = 0;
+	arena->total += ARENA_HEADER + size;
+	return block;
+}
@@ -32,9 +32,11 @@ static char const _license[] = "All rights reserved.\n"
 
 
 
+#include <sys/resource.h>
 #include <sys/stat.h>
 #include <dirent.h>
 #include <unistd.h>
+#include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -44,8 +46,19 @@ static char const _license[] = "All rights reserved.\n"
 #include <gtk/gtk.h>
 #include <System.h>
 #include <Desktop.h>
+#include "bulkedit.h"
+#include "datecache.h"
+#include "exchange.h"
+#include "filter.h"
+#include "journal.h"
+#include "loader.h"
 #include "priority.h"
+#include "snapshot.h"
+#include "taskstore.h"
 #include "taskedit.h"
+#include "trace.h"
+#include "viewedit.h"
+#include "writer.h"
 #include "auditor.h"
 #include "../config.h"
 #define _(string) gettext(string)
@@ -55,41 +68,191 @@ static char const _license[] = "All rights reserved.\n"
 # define PROGNAME_AUDITOR	"auditor"
 #endif
 
+/* constants */
+#define AUDITOR_DATECACHE_SIZE	1024
+#define AUDITOR_DELETE_INTERVAL	100
+#define AUDITOR_DELETE_PROGRESS	1024
+#define AUDITOR_IMPORT_BUDGET	8000
+#define AUDITOR_IMPORT_CHECK	16
+#define AUDITOR_INDEX_BUDGET	8000
+#define AUDITOR_INDEX_CHUNK	16
+#define AUDITOR_LOADER_BATCH	256
+#define AUDITOR_LOADER_INTERVAL	10
+#define AUDITOR_PERFORMANCE_INTERVAL	1
+#define AUDITOR_POPULATE_BUDGET	8000
+#define AUDITOR_POPULATE_CHECK	64
+#define AUDITOR_SEARCH_DELAY	250
+#define AUDITOR_SNAPSHOT_CHUNK	256
+#define AUDITOR_WRITER_DELAY	500
+
 
 /* Auditor */
 /* private */
 /* types */
-typedef enum _AuditorColumn { TD_COL_TASK, TD_COL_DONE, TD_COL_TITLE,
-	TD_COL_START, TD_COL_DISPLAY_START, TD_COL_END, TD_COL_DISPLAY_END,
-	TD_COL_PRIORITY, TD_COL_DISPLAY_PRIORITY, TD_COL_CATEGORY
+typedef enum _AuditorColumn
+{
+	TD_COL_TASK = TASKSTORE_COL_TASK,
+	TD_COL_DONE = TASKSTORE_COL_DONE,
+	TD_COL_TITLE = TASKSTORE_COL_TITLE,
+	TD_COL_START = TASKSTORE_COL_START,
+	TD_COL_END = TASKSTORE_COL_END,
+	TD_COL_PRIORITY = TASKSTORE_COL_PRIORITY,
+	TD_COL_DISPLAY_PRIORITY = TASKSTORE_COL_DISPLAY_PRIORITY,
+	TD_COL_CATEGORY = TASKSTORE_COL_CATEGORY
 } AuditorColumn;
 #define TD_COL_LAST TD_COL_CATEGORY
-#define TD_COL_COUNT (TD_COL_LAST + 1)
+#define TD_COL_COUNT TASKSTORE_COL_COUNT
+
+typedef enum _AuditorPerformance
+{
+	AP_TASKS = 0,
+	AP_VIEW,
+	AP_RELOAD,
+	AP_LOADS,
+	AP_SAVES,
+	AP_WRITES,
+	AP_MEMORY,
+	AP_FIELDS,
+	AP_PEAK
+} AuditorPerformance;
+#define AP_LAST AP_PEAK
+#define AP_COUNT (AP_LAST + 1)
+
+/* the state of a task file as written by this program */
+typedef struct _AuditorWrite
+{
+	struct timespec mtime;
+	off_t size;		/* or -1 while written in the background */
+} AuditorWrite;
 
 struct _Auditor
 {
 	GtkWidget * window;
 	GtkWidget * widget;
 	GtkWidget * scrolled;
-	GtkListStore * store;
+	TaskStore * store;
 	GtkListStore * priorities;
-	GtkTreeModel * filter;
-	GtkTreeModel * filter_sort;
+	GtkTreeModel * filters[AUDITOR_VIEW_COUNT];
+	gboolean filters_stale[AUDITOR_VIEW_COUNT];
 	AuditorView filter_view;
+	GtkToolItem * view_as;
+	GtkListStore * views;
+	GtkWidget * search;
+	guint search_source;
 	GtkWidget * view;
 	GtkTreeViewColumn * columns[TD_COL_COUNT];
+	DateCache * dates;
 	GtkWidget * about;
+	GtkWidget * statusbar;
+	guint statusbar_id;
+
+	/* performance */
+	GtkWidget * performance;
+	GtkWidget * performance_panel;
+	GtkWidget * performance_values[AP_COUNT];
+	guint performance_source;
+	gint64 reload_start;
+	gint64 reload_time;
+	guint reload_count;
+
+	/* population */
+	GPtrArray * pending;
+	guint pending_pos;
+	guint pending_source;
+	guint pending_count;
+
+	/* full-text search */
+	guint index_source;
+
+	/* deletion */
+	guint delete_source;
+	guint delete_count;
+
+	/* import */
+	guint import_source;
+	char * import_filename;
+	FILE * import_fp;
+	Exchange * import_exchange;
+	GPtrArray * import_files;
+	guint import_synced;
+	guint import_count;
+	unsigned long import_errors;
+	unsigned long import_line;
+	char * import_message;
+
+	/* storage */
+	Journal * journal;
+	GHashTable * rows;
+	Arena * arena;
+	GFileMonitor * monitor;
+	GHashTable * writes;
+	Writer * writer;
+	Snapshot * snapshot;
+	guint snapshot_source;
+	size_t snapshot_pos;
+	unsigned int threads;
+	Loader * loader;
+	guint loader_source;
 };
 
 
 /* prototypes */
 static int _auditor_confirm(GtkWidget * window, char const * message);
+static char * _auditor_exchange_get_filename(Auditor * auditor,
+		char const * title, GtkFileChooserAction action);
 static gboolean _auditor_get_iter(Auditor * auditor, GtkTreeIter * iter,
 		GtkTreePath * path);
 static char * _auditor_task_get_directory(void);
 static char * _auditor_task_get_filename(char const * filename);
 static char * _auditor_task_get_new_filename(void);
-static void _auditor_task_save(Auditor * auditor, GtkTreeIter * iter);
+static gboolean _auditor_task_get_iter(Auditor * auditor,
+		char const * filename, GtkTreeIter * iter);
+static gboolean _auditor_task_remove(Auditor * auditor, GtkTreeIter * iter);
+static int _auditor_task_save(Auditor * auditor, GtkTreeIter * iter);
+static void _auditor_task_save_queue(Auditor * auditor, Task * task);
+static void _auditor_task_set(Auditor * auditor, GtkTreeIter * iter,
+		Task * task);
+static void _auditor_task_written(Auditor * auditor, char const * filename,
+		gboolean pending);
+
+static void _auditor_snapshot_cancel(Auditor * auditor);
+static gboolean _auditor_snapshot_get_complete(Auditor * auditor);
+static char * _auditor_snapshot_get_filename(void);
+static int _auditor_snapshot_save(Auditor * auditor);
+
+static int _auditor_import_close(Auditor * auditor);
+static int _auditor_import_sync(Auditor * auditor, gint64 deadline);
+
+static void _auditor_index_cancel(Auditor * auditor);
+static void _auditor_index_start(Auditor * auditor);
+
+static void _auditor_loader_cancel(Auditor * auditor);
+
+static void _auditor_performance_duration(char * buf, size_t size,
+		unsigned long long duration);
+static unsigned long _auditor_performance_memory(void);
+static void _auditor_performance_update(Auditor * auditor);
+
+static void _auditor_populate_cancel(Auditor * auditor);
+static void _auditor_populate_queue(Auditor * auditor, Task * task);
+static void _auditor_populate_start(Auditor * auditor);
+
+static void _auditor_status(Auditor * auditor, char const * format, ...);
+
+static gint _auditor_column_get_sort(GtkTreeViewColumn * column);
+static void _auditor_column_set_sort(Auditor * auditor,
+		GtkTreeViewColumn * column, gint id);
+
+static void _auditor_view_attach(Auditor * auditor);
+static void _auditor_view_detach(Auditor * auditor);
+static GtkTreeModel * _auditor_view_get_model(Auditor * auditor);
+
+static char * _auditor_views_get_filename(void);
+static gboolean _auditor_views_get_iter(Auditor * auditor, char const * name,
+		GtkTreeIter * iter);
+static void _auditor_views_load(Auditor * auditor);
+static void _auditor_views_menu(Auditor * auditor);
+static int _auditor_views_save(Auditor * auditor);
 
 /* callbacks */
 /* toolbar */
@@ -101,8 +264,13 @@ static void _auditor_on_delete(gpointer data);
 static void _auditor_on_preferences(gpointer data);
 #endif
 static void _auditor_on_view_as(gpointer data);
+static void _auditor_on_search_activate(gpointer data);
+static void _auditor_on_search_changed(gpointer data);
+static gboolean _auditor_on_search_timeout(gpointer data);
 
 /* view */
+static void _auditor_on_column_clicked(GtkTreeViewColumn * column,
+		gpointer data);
 static void _auditor_on_task_activated(gpointer data);
 static void _auditor_on_task_cursor_changed(gpointer data);
 static void _auditor_on_task_done_toggled(GtkCellRendererToggle * renderer,
@@ -113,10 +281,35 @@ static void _auditor_on_task_title_edited(GtkCellRendererText * renderer,
 		gchar * path, gchar * title, gpointer data);
 static void _auditor_on_view_all_tasks(gpointer data);
 static void _auditor_on_view_completed_tasks(gpointer data);
+static void _auditor_on_view_custom(gpointer data);
 static void _auditor_on_view_remaining_tasks(gpointer data);
+static void _auditor_on_view_saved(GtkWidget * widget, gpointer data);
 
-static gboolean _auditor_on_filter_view(GtkTreeModel * model,
+static void _auditor_on_date_data(GtkTreeViewColumn * column,
+		GtkCellRenderer * renderer, GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data);
+static gboolean _auditor_on_filter_all(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data);
+static gboolean _auditor_on_filter_completed(GtkTreeModel * model,
 		GtkTreeIter * iter, gpointer data);
+static gboolean _auditor_on_filter_filtered(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data);
+static gboolean _auditor_on_filter_remaining(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data);
+
+static void _auditor_on_directory_changed(GFileMonitor * monitor,
+		GFile * file, GFile * other, GFileMonitorEvent event,
+		gpointer data);
+static void _auditor_on_write(char const * filename, char const * error,
+		void * data);
+
+static gboolean _auditor_on_delete_progress(gpointer data);
+static gboolean _auditor_on_import(gpointer data);
+static gboolean _auditor_on_index(gpointer data);
+static gboolean _auditor_on_loader_collect(gpointer data);
+static gboolean _auditor_on_performance(gpointer data);
+static gboolean _auditor_on_populate(gpointer data);
+static gboolean _auditor_on_snapshot_verify(gpointer data);
 
 
 /* constants */
@@ -126,15 +319,26 @@ static const struct
 	char const * title;
 	int sort;
 	GCallback callback;
+	GtkTreeCellDataFunc func;
 } _auditor_columns[] =
 {
 	{ TD_COL_DONE, N_("Done"), TD_COL_DONE, G_CALLBACK(
-			_auditor_on_task_done_toggled) },
+			_auditor_on_task_done_toggled), NULL },
 	{ TD_COL_TITLE, N_("Title"), TD_COL_TITLE, G_CALLBACK(
-			_auditor_on_task_title_edited) },
-	{ TD_COL_DISPLAY_START, N_("Beginning"), TD_COL_START, NULL },
-	{ TD_COL_DISPLAY_END, N_("Completion"), TD_COL_END, NULL },
-	{ 0, NULL, 0, NULL }
+			_auditor_on_task_title_edited), NULL },
+	{ TD_COL_START, N_("Beginning"), TD_COL_START, NULL,
+		_auditor_on_date_data },
+	{ TD_COL_END, N_("Completion"), TD_COL_END, NULL,
+		_auditor_on_date_data },
+	{ 0, NULL, 0, NULL, NULL }
+};
+
+
+static char const * _auditor_performance[AP_COUNT] =
+{
+	N_("Tasks:"), N_("In this view:"), N_("Last reload:"),
+	N_("Tasks loaded:"), N_("Tasks saved:"), N_("Pending writes:"),
+	N_("Memory:"), N_("Per task:"), N_("Peak memory:")
 };
 
 
@@ -173,6 +377,8 @@ static DesktopToolbar _toolbar[] =
 /* public */
 /* functions */
 /* auditor_new */
+static void _new_journal(Auditor * auditor);
+static GtkWidget * _new_performance(Auditor * auditor);
 static void _new_view(Auditor * auditor);
 static gboolean _new_idle(gpointer data);
 
@@ -182,8 +388,6 @@ Auditor * auditor_new(GtkWidget * window, GtkAccelGroup * group)
 	GtkWidget * vbox;
 	GtkWidget * widget;
 	GtkToolItem * toolitem;
-	GtkWidget * menu;
-	GtkWidget * menuitem;
 
 	if((auditor = object_new(sizeof(*auditor))) == NULL)
 		return NULL;
@@ -196,34 +400,149 @@ Auditor * auditor_new(GtkWidget * window, GtkAccelGroup * group)
 	toolitem = gtk_menu_tool_button_new(NULL, _("View..."));
 	g_signal_connect_swapped(toolitem, "clicked", G_CALLBACK(
 				_auditor_on_view_as), auditor);
-	menu = gtk_menu_new();
-	menuitem = gtk_menu_item_new_with_label(_("All tasks"));
-	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
-				_auditor_on_view_all_tasks), auditor);
-	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
-	menuitem = gtk_menu_item_new_with_label(_("Completed tasks"));
-	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
-				_auditor_on_view_completed_tasks), auditor);
-	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
-	menuitem = gtk_menu_item_new_with_label(_("Remaining tasks"));
-	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
-				_auditor_on_view_remaining_tasks), auditor);
-	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
-	gtk_widget_show_all(menu);
-	gtk_menu_tool_button_set_menu(GTK_MENU_TOOL_BUTTON(toolitem), menu);
+	auditor->view_as = toolitem;
+	/* the views saved are listed in the menu */
+	auditor->views = gtk_list_store_new(2, G_TYPE_STRING, G_TYPE_STRING);
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(auditor->views),
+			0, GTK_SORT_ASCENDING);
+	_auditor_views_load(auditor);
+	_auditor_views_menu(auditor);
+	gtk_toolbar_insert(GTK_TOOLBAR(widget), toolitem, -1);
+	/* search */
+	toolitem = gtk_separator_tool_item_new();
+	gtk_toolbar_insert(GTK_TOOLBAR(widget), toolitem, -1);
+	toolitem = gtk_tool_item_new();
+	auditor->search = gtk_entry_new();
+	auditor->search_source = 0;
+#if GTK_CHECK_VERSION(3, 2, 0)
+	gtk_entry_set_placeholder_text(GTK_ENTRY(auditor->search),
+			_("Search"));
+#endif
+#if GTK_CHECK_VERSION(2, 16, 0)
+	gtk_entry_set_icon_from_icon_name(GTK_ENTRY(auditor->search),
+			GTK_ENTRY_ICON_PRIMARY, "edit-find");
+#endif
+	g_signal_connect_swapped(auditor->search, "activate", G_CALLBACK(
+				_auditor_on_search_activate), auditor);
+	g_signal_connect_swapped(auditor->search, "changed", G_CALLBACK(
+				_auditor_on_search_changed), auditor);
+	gtk_container_add(GTK_CONTAINER(toolitem), auditor->search);
 	gtk_toolbar_insert(GTK_TOOLBAR(widget), toolitem, -1);
 	gtk_box_pack_start(GTK_BOX(vbox), widget, FALSE, TRUE, 0);
 	/* view */
 	auditor->scrolled = gtk_scrolled_window_new(NULL, NULL);
 	gtk_scrolled_window_set_policy(GTK_SCROLLED_WINDOW(auditor->scrolled),
 			GTK_POLICY_AUTOMATIC, GTK_POLICY_AUTOMATIC);
+	if((auditor->dates = datecache_new(AUDITOR_DATECACHE_SIZE)) == NULL)
+		auditor_error(NULL, error_get(NULL), 1);
 	_new_view(auditor);
 	gtk_box_pack_start(GTK_BOX(vbox), auditor->scrolled, TRUE, TRUE, 0);
+	/* performance */
+	widget = _new_performance(auditor);
+	gtk_box_pack_start(GTK_BOX(vbox), widget, FALSE, TRUE, 0);
 	auditor->about = NULL;
+	auditor->statusbar = NULL;
+	auditor->statusbar_id = 0;
+	auditor->pending = g_ptr_array_new();
+	auditor->pending_pos = 0;
+	auditor->pending_source = 0;
+	auditor->pending_count = 0;
+	auditor->index_source = 0;
+	auditor->delete_source = 0;
+	auditor->delete_count = 0;
+	auditor->import_source = 0;
+	auditor->import_filename = NULL;
+	auditor->import_fp = NULL;
+	auditor->import_exchange = NULL;
+	auditor->import_files = NULL;
+	auditor->import_synced = 0;
+	auditor->import_count = 0;
+	auditor->import_errors = 0;
+	auditor->import_line = 0;
+	auditor->import_message = NULL;
+	auditor->snapshot = NULL;
+	auditor->snapshot_source = 0;
+	auditor->rows = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+			g_free);
+	auditor->arena = NULL;
+	auditor->monitor = NULL;
+	auditor->writes = g_hash_table_new_full(g_str_hash, g_str_equal,
+			g_free, g_free);
+	if((auditor->writer = writer_new(AUDITOR_WRITER_DELAY,
+					_auditor_on_write, auditor)) == NULL)
+		auditor_error(NULL, error_get(NULL), 1);
+	auditor->threads = 0;
+	auditor->loader = NULL;
+	auditor->loader_source = 0;
+	auditor->reload_start = 0;
+	auditor->reload_time = 0;
+	auditor->reload_count = 0;
+	/* refreshed from the counters, whatever happened meanwhile */
+	auditor->performance_source = g_timeout_add_seconds(
+			AUDITOR_PERFORMANCE_INTERVAL, _auditor_on_performance,
+			auditor);
+	_new_journal(auditor);
 	g_idle_add(_new_idle, auditor);
 	return auditor;
 }
 
+static void _new_journal(Auditor * auditor)
+{
+	char * filename;
+
+	auditor->journal = NULL;
+	if((filename = _auditor_task_get_filename("journal")) == NULL)
+		return;
+	if(journal_is_enabled(filename)
+			&& (auditor->journal = journal_new(filename)) == NULL)
+		auditor_error(NULL, error_get(NULL), 1);
+	free(filename);
+}
+
+static GtkWidget * _new_performance(Auditor * auditor)
+{
+	GtkSizeGroup * group;
+	GtkWidget * vbox;
+	GtkWidget * hbox;
+	GtkWidget * widget;
+	size_t i;
+
+	/* the label is only packed once the statusbar is known */
+	auditor->performance = gtk_label_new(NULL);
+	g_object_ref_sink(auditor->performance);
+	/* detailed panel, hidden by default */
+	auditor->performance_panel = gtk_frame_new(_("Performance"));
+	gtk_widget_set_no_show_all(auditor->performance_panel, TRUE);
+	group = gtk_size_group_new(GTK_SIZE_GROUP_HORIZONTAL);
+	vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 0);
+	gtk_container_set_border_width(GTK_CONTAINER(vbox), 4);
+	for(i = 0; i < AP_COUNT; i++)
+	{
+		hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+		widget = gtk_label_new(_(_auditor_performance[i]));
+#if GTK_CHECK_VERSION(3, 0, 0)
+		g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+		gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+		gtk_size_group_add_widget(group, widget);
+		gtk_box_pack_start(GTK_BOX(hbox), widget, FALSE, TRUE, 0);
+		widget = gtk_label_new(NULL);
+#if GTK_CHECK_VERSION(3, 0, 0)
+		g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+		gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+		auditor->performance_values[i] = widget;
+		gtk_box_pack_start(GTK_BOX(hbox), widget, TRUE, TRUE, 0);
+		gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, TRUE, 0);
+	}
+	g_object_unref(group);
+	gtk_widget_show_all(vbox);
+	gtk_container_add(GTK_CONTAINER(auditor->performance_panel), vbox);
+	return auditor->performance_panel;
+}
+
 static void _new_view(Auditor * auditor)
 {
 	size_t i;
@@ -232,34 +551,21 @@ static void _new_view(Auditor * auditor)
 	GtkCellRenderer * renderer;
 	GtkTreeViewColumn * column;
 
-	auditor->store = gtk_list_store_new(TD_COL_COUNT,
-			G_TYPE_POINTER, /* task */
-			G_TYPE_BOOLEAN, /* done */
-			G_TYPE_STRING,	/* title */
-			G_TYPE_UINT64,	/* start */
-			G_TYPE_STRING,	/* display start */
-			G_TYPE_UINT64,	/* end */
-			G_TYPE_STRING,	/* display end */
-			G_TYPE_UINT,	/* priority */
-			G_TYPE_STRING,	/* display priority */
-			G_TYPE_STRING);	/* category */
+	auditor->store = taskstore_new();
 	auditor->priorities = gtk_list_store_new(2, G_TYPE_UINT, G_TYPE_STRING);
 	for(i = 0; priorities[i].title != NULL; i++)
 	{
 		gtk_list_store_append(auditor->priorities, &iter);
 		gtk_list_store_set(auditor->priorities, &iter,
 				0, priorities[i].priority,
-				1, _(priorities[i].title), -1);
+				1, priority_get_title(priorities[i].priority),
+				-1);
 	}
-	auditor->filter = gtk_tree_model_filter_new(GTK_TREE_MODEL(auditor->store),
-			NULL);
+	memset(&auditor->filters, 0, sizeof(auditor->filters));
+	memset(&auditor->filters_stale, 0, sizeof(auditor->filters_stale));
 	auditor->filter_view = AUDITOR_VIEW_ALL_TASKS;
-	gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(
-				auditor->filter), _auditor_on_filter_view, auditor,
-			NULL);
-	auditor->filter_sort = gtk_tree_model_sort_new_with_model(auditor->filter);
-	auditor->view = gtk_tree_view_new_with_model(GTK_TREE_MODEL(
-				auditor->filter_sort));
+	auditor->view = gtk_tree_view_new();
+	_auditor_view_attach(auditor);
 	gtk_tree_view_set_rules_hint(GTK_TREE_VIEW(auditor->view), TRUE);
 	if((sel = gtk_tree_view_get_selection(GTK_TREE_VIEW(auditor->view)))
 			!= NULL)
@@ -281,7 +587,7 @@ static void _new_view(Auditor * auditor)
 	gtk_tree_view_column_set_sizing(GTK_TREE_VIEW_COLUMN(column),
 			GTK_TREE_VIEW_COLUMN_FIXED);
 	gtk_tree_view_column_set_fixed_width(GTK_TREE_VIEW_COLUMN(column), 50);
-	gtk_tree_view_column_set_sort_column_id(column, TD_COL_DONE);
+	_auditor_column_set_sort(auditor, column, TD_COL_DONE);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(auditor->view), column);
 	/* other columns */
 	for(i = 1; _auditor_columns[i].title != NULL; i++)
@@ -295,15 +601,27 @@ static void _new_view(Auditor * auditor)
 						_auditor_columns[i].callback),
 					auditor);
 		}
-		column = gtk_tree_view_column_new_with_attributes(
-				_(_auditor_columns[i].title), renderer, "text",
-				_auditor_columns[i].col, NULL);
+		if(_auditor_columns[i].func != NULL)
+		{
+			/* only format the rows displayed */
+			column = gtk_tree_view_column_new();
+			gtk_tree_view_column_set_title(column,
+					_(_auditor_columns[i].title));
+			gtk_tree_view_column_pack_start(column, renderer, TRUE);
+			gtk_tree_view_column_set_cell_data_func(column,
+					renderer, _auditor_columns[i].func,
+					auditor, NULL);
+		}
+		else
+			column = gtk_tree_view_column_new_with_attributes(
+					_(_auditor_columns[i].title), renderer,
+					"text", _auditor_columns[i].col, NULL);
 		auditor->columns[_auditor_columns[i].col] = column;
 #if GTK_CHECK_VERSION(2, 4, 0)
 		gtk_tree_view_column_set_expand(column, TRUE);
 #endif
 		gtk_tree_view_column_set_resizable(column, TRUE);
-		gtk_tree_view_column_set_sort_column_id(column,
+		_auditor_column_set_sort(auditor, column,
 				_auditor_columns[i].sort);
 		gtk_tree_view_append_column(GTK_TREE_VIEW(auditor->view), column);
 	}
@@ -311,7 +629,7 @@ static void _new_view(Auditor * auditor)
 	renderer = gtk_cell_renderer_combo_new();
 	g_object_set(renderer, "ellipsize", PANGO_ELLIPSIZE_END,
 			"model", auditor->priorities, "text-column", 1,
-			"editable", TRUE, NULL);
+			"has-entry", FALSE, "editable", TRUE, NULL);
 	g_signal_connect(renderer, "edited", G_CALLBACK(
 				_auditor_on_task_priority_edited), auditor);
 	column = gtk_tree_view_column_new_with_attributes(_("Priority"),
@@ -321,7 +639,7 @@ static void _new_view(Auditor * auditor)
 	gtk_tree_view_column_set_expand(column, TRUE);
 #endif
 	gtk_tree_view_column_set_resizable(column, TRUE);
-	gtk_tree_view_column_set_sort_column_id(column, TD_COL_PRIORITY);
+	_auditor_column_set_sort(auditor, column, TD_COL_PRIORITY);
 	gtk_container_add(GTK_CONTAINER(auditor->scrolled), auditor->view);
 	gtk_tree_view_append_column(GTK_TREE_VIEW(auditor->view), column);
 }
@@ -338,14 +656,96 @@ static gboolean _new_idle(gpointer data)
 /* auditor_delete */
 void auditor_delete(Auditor * auditor)
 {
+	gboolean snapshot;
+
+	if(auditor->monitor != NULL)
+	{
+		g_file_monitor_cancel(auditor->monitor);
+		g_object_unref(auditor->monitor);
+		auditor->monitor = NULL;
+	}
+	if(auditor->search_source != 0)
+		g_source_remove(auditor->search_source);
+	if(auditor->performance_source != 0)
+		g_source_remove(auditor->performance_source);
+	if(auditor->delete_source != 0)
+		g_source_remove(auditor->delete_source);
+	/* the tasks imported so far are kept */
+	if(auditor->import_source != 0)
+	{
+		g_source_remove(auditor->import_source);
+		_auditor_import_close(auditor);
+		g_free(auditor->import_message);
+		g_free(auditor->import_filename);
+	}
+	g_object_unref(auditor->performance);
+	/* a snapshot of a partial or unverified list would be trusted */
+	snapshot = (auditor->journal == NULL && _auditor_snapshot_get_complete(
+				auditor));
+	_auditor_index_cancel(auditor);
+	_auditor_loader_cancel(auditor);
+	_auditor_populate_cancel(auditor);
+	g_ptr_array_free(auditor->pending, TRUE);
+	_auditor_snapshot_cancel(auditor);
+	/* complete the pending writes first */
+	if(auditor->writer != NULL)
+		writer_delete(auditor->writer);
+	auditor->writer = NULL;
+	/* only the tasks modified are written */
 	auditor_task_save_all(auditor);
+	if(snapshot)
+		_auditor_snapshot_save(auditor);
 	auditor_task_remove_all(auditor);
+	g_hash_table_destroy(auditor->rows);
+	g_hash_table_destroy(auditor->writes);
+	if(auditor->journal != NULL)
+		journal_delete(auditor->journal);
+	if(auditor->dates != NULL)
+		datecache_delete(auditor->dates);
+	g_object_unref(auditor->views);
 	free(auditor);
 	object_delete(auditor);
 }
 
 
 /* accessors */
+/* auditor_get_count */
+unsigned int auditor_get_count(Auditor * auditor, AuditorView view)
+{
+	unsigned int count;
+	unsigned int done;
+
+	count = taskstore_get_count(auditor->store);
+	done = taskstore_get_count_done(auditor->store);
+	switch(view)
+	{
+		case AUDITOR_VIEW_COMPLETED_TASKS:
+			return done;
+		case AUDITOR_VIEW_REMAINING_TASKS:
+			return count - done;
+		case AUDITOR_VIEW_FILTERED_TASKS:
+			return taskstore_get_count_filtered(auditor->store);
+		case AUDITOR_VIEW_ALL_TASKS:
+		default:
+			return count;
+	}
+}
+
+
+/* auditor_get_filter */
+char const * auditor_get_filter(Auditor * auditor)
+{
+	return taskstore_get_filter(auditor->store);
+}
+
+
+/* auditor_get_show_performance */
+gboolean auditor_get_show_performance(Auditor * auditor)
+{
+	return gtk_widget_get_visible(auditor->performance_panel);
+}
+
+
 /* auditor_get_view */
 AuditorView auditor_get_view(Auditor * auditor)
 {
@@ -360,11 +760,127 @@ GtkWidget * auditor_get_widget(Auditor * auditor)
 }
 
 
+/* auditor_set_filter */
+int auditor_set_filter(Auditor * auditor, char const * filter)
+{
+	Filter * f = NULL;
+	AuditorView view = auditor->filter_view;
+	gint64 start;
+
+	/* compiled once, then evaluated for every task */
+	if(filter != NULL && filter[0] != '\0'
+			&& (f = filter_new(filter)) == NULL)
+		return auditor_error(auditor, error_get(NULL), -1);
+	start = trace_begin();
+	taskstore_set_filter(auditor->store, f);
+	trace_end(start, "view", "taskstore_set_filter", filter);
+	auditor->filters_stale[AUDITOR_VIEW_FILTERED_TASKS] = TRUE;
+	if(f != NULL)
+		view = AUDITOR_VIEW_FILTERED_TASKS;
+	else if(view == AUDITOR_VIEW_FILTERED_TASKS)
+		view = AUDITOR_VIEW_ALL_TASKS;
+	auditor_set_view(auditor, view);
+	return 0;
+}
+
+
+/* auditor_set_search */
+void auditor_set_search(Auditor * auditor, char const * query)
+{
+	size_t i;
+
+	if(taskstore_set_search(auditor->store, query) != 0)
+	{
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	/* otherwise applied once the tasks are loaded */
+	if(auditor->filters[AUDITOR_VIEW_COMPLETED_TASKS] == NULL)
+		return;
+	/* only filter the rows again for the current view */
+	for(i = 0; i < AUDITOR_VIEW_COUNT; i++)
+		auditor->filters_stale[i] = TRUE;
+	auditor_set_view(auditor, auditor->filter_view);
+}
+
+
+/* auditor_set_statusbar */
+void auditor_set_statusbar(Auditor * auditor, GtkWidget * statusbar)
+{
+	GtkWidget * parent;
+
+	if((parent = gtk_widget_get_parent(auditor->performance)) != NULL)
+		gtk_container_remove(GTK_CONTAINER(parent),
+				auditor->performance);
+	auditor->statusbar = statusbar;
+	auditor->statusbar_id = (statusbar != NULL)
+		? gtk_statusbar_get_context_id(GTK_STATUSBAR(statusbar),
+				PROGNAME_AUDITOR) : 0;
+	if(statusbar == NULL)
+		return;
+	/* the counters are displayed next to the messages */
+	gtk_box_pack_end(GTK_BOX(statusbar), auditor->performance, FALSE, TRUE,
+			4);
+	gtk_widget_show(auditor->performance);
+	_auditor_performance_update(auditor);
+}
+
+
+/* auditor_set_threads */
+void auditor_set_threads(Auditor * auditor, unsigned int threads)
+{
+	auditor->threads = threads;
+	taskstore_set_threads(auditor->store, threads);
+}
+
+
 /* auditor_set_view */
 void auditor_set_view(Auditor * auditor, AuditorView view)
 {
+	GtkTreeModel * model;
+	gint64 start;
+
 	auditor->filter_view = view;
-	gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(auditor->filter));
+	/* otherwise applied once the tasks are loaded */
+	if(auditor->filters[AUDITOR_VIEW_COMPLETED_TASKS] == NULL)
+		return;
+	/* every view is kept up to date: no need to filter again, unless
+	 * the search changed meanwhile */
+	model = _auditor_view_get_model(auditor);
+	if(model == auditor->filters[view] && auditor->filters_stale[view])
+	{
+		start = trace_begin();
+		gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view), NULL);
+		gtk_tree_model_filter_refilter(GTK_TREE_MODEL_FILTER(model));
+		auditor->filters_stale[view] = FALSE;
+		trace_end(start, "view", "refilter", NULL);
+	}
+	gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view), model);
+	if(taskstore_get_search(auditor->store) != NULL)
+		_auditor_status(auditor, _("%d task(s) found"),
+				gtk_tree_model_iter_n_children(model, NULL));
+	else if(view == AUDITOR_VIEW_FILTERED_TASKS)
+		_auditor_status(auditor, _("%u task(s) in this view (out of"
+					" %u)"), auditor_get_count(auditor,
+					AUDITOR_VIEW_FILTERED_TASKS),
+				auditor_get_count(auditor,
+					AUDITOR_VIEW_ALL_TASKS));
+	else
+		_auditor_status(auditor, _("%u task(s) (%u completed,"
+					" %u remaining)"), auditor_get_count(
+					auditor, AUDITOR_VIEW_ALL_TASKS),
+				auditor_get_count(auditor,
+					AUDITOR_VIEW_COMPLETED_TASKS),
+				auditor_get_count(auditor,
+					AUDITOR_VIEW_REMAINING_TASKS));
+}
+
+
+/* auditor_set_write_delay */
+void auditor_set_write_delay(Auditor * auditor, unsigned int delay)
+{
+	if(auditor->writer != NULL)
+		writer_set_delay(auditor->writer, delay);
 }
 
 
@@ -441,6 +957,135 @@ static int _error_text(char const * message, int ret)
 }
 
 
+/* auditor_export */
+void auditor_export(Auditor * auditor)
+{
+	int ret = 0;
+	char * filename;
+	ExchangeFormat format = EXCHANGE_FORMAT_CSV;
+	FILE * fp;
+	Exchange * exchange;
+	GtkTreeModel * model;
+	GtkTreeIter iter;
+	gboolean valid;
+	Task * task;
+	char const * id;
+	unsigned int count = 0;
+
+	if((filename = _auditor_exchange_get_filename(auditor, _("Export..."),
+					GTK_FILE_CHOOSER_ACTION_SAVE)) == NULL)
+		return;
+	/* CSV unless the extension tells otherwise */
+	exchange_parse_format(filename, &format);
+	if((fp = fopen(filename, "w")) == NULL)
+	{
+		error_set("%s: %s", filename, strerror(errno));
+		g_free(filename);
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	if((exchange = exchange_new(fp, format)) == NULL)
+	{
+		fclose(fp);
+		g_free(filename);
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	/* the tasks must not be written meanwhile */
+	if(auditor->writer != NULL)
+		writer_flush(auditor->writer);
+	/* the tasks of the current view, as displayed */
+	model = gtk_tree_view_get_model(GTK_TREE_VIEW(auditor->view));
+	for(valid = gtk_tree_model_get_iter_first(model, &iter);
+			ret == 0 && valid;
+			valid = gtk_tree_model_iter_next(model, &iter))
+	{
+		gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
+		if(task == NULL || (id = task_get_filename(task)) == NULL)
+			continue;
+		if(strrchr(id, '/') != NULL)
+			id = strrchr(id, '/') + 1;
+		if((ret = exchange_write(exchange, id, task)) == 0)
+			count++;
+		/* the descriptions are not kept in memory */
+		task_unload_description(task);
+	}
+	exchange_delete(exchange);
+	if(fclose(fp) != 0 && ret == 0)
+		ret = -error_set_code(1, "%s: %s", filename, strerror(errno));
+	g_free(filename);
+	if(ret != 0)
+		auditor_error(auditor, error_get(NULL), 1);
+	else
+		_auditor_status(auditor, _("%u task(s) exported"), count);
+}
+
+
+/* auditor_import */
+void auditor_import(Auditor * auditor)
+{
+	char * filename;
+	ExchangeFormat format = EXCHANGE_FORMAT_CSV;
+	FILE * fp;
+	Exchange * exchange;
+
+	if(auditor->import_source != 0)
+	{
+		error_set("%s: %s", auditor->import_filename,
+				_("Import already in progress"));
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	if((filename = _auditor_exchange_get_filename(auditor, _("Import..."),
+					GTK_FILE_CHOOSER_ACTION_OPEN)) == NULL)
+		return;
+	exchange_parse_format(filename, &format);
+	if((fp = fopen(filename, "r")) == NULL)
+	{
+		error_set("%s: %s", filename, strerror(errno));
+		g_free(filename);
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	if((exchange = exchange_new(fp, format)) == NULL)
+	{
+		fclose(fp);
+		g_free(filename);
+		auditor_error(auditor, error_get(NULL), 1);
+		return;
+	}
+	auditor->import_filename = filename;
+	auditor->import_fp = fp;
+	auditor->import_exchange = exchange;
+	/* the files written are only synchronized once imported */
+	auditor->import_files = (auditor->journal == NULL)
+		? g_ptr_array_new_with_free_func(free) : NULL;
+	auditor->import_synced = 0;
+	auditor->import_count = 0;
+	auditor->import_errors = 0;
+	auditor->import_line = 0;
+	auditor->import_message = NULL;
+	/* the rows are inserted progressively with the view detached */
+	_auditor_view_detach(auditor);
+	auditor->import_source = g_idle_add(_auditor_on_import, auditor);
+}
+
+
+/* auditor_show_performance */
+void auditor_show_performance(Auditor * auditor, gboolean show)
+{
+	/* the loads and saves are only timed while displayed */
+	task_stats_set_timing(show);
+	if(show)
+	{
+		_auditor_performance_update(auditor);
+		gtk_widget_show(auditor->performance_panel);
+	}
+	else
+		gtk_widget_hide(auditor->performance_panel);
+}
+
+
 /* auditor_show_preferences */
 void auditor_show_preferences(Auditor * auditor, gboolean show)
 {
@@ -453,74 +1098,68 @@ void auditor_show_preferences(Auditor * auditor, gboolean show)
 Task * auditor_task_add(Auditor * auditor, Task * task)
 {
 	GtkTreeIter iter;
+	GtkTreeIter * row;
 	char * filename;
-	time_t start;
-	struct tm t;
-	char beginning[32] = "";
-	time_t end;
-	char completion[32] = "";
-	char const * priority;
-	AuditorPriority tp = AUDITOR_PRIORITY_UNKNOWN;
-	size_t i;
+	char const * p;
+	gboolean created = (task == NULL) ? TRUE : FALSE;
+	gint64 start = trace_begin();
 
-	if(task == NULL)
+	if(created)
 	{
 		if((task = task_new()) == NULL)
 			return NULL;
-		if((filename = _auditor_task_get_new_filename()) == NULL)
+		if((filename = (auditor->journal != NULL)
+					? journal_new_id(auditor->journal)
+					: _auditor_task_get_new_filename()) == NULL)
 		{
 			auditor_error(auditor, error_get(NULL), 0);
 			task_delete(task);
 			return NULL;
 		}
 		task_set_filename(task, filename);
+		task_set_journal(task, auditor->journal);
 		free(filename);
 		task_set_title(task, _("New task"));
-		task_save(task);
+		if(task_save(task) == 0)
+			_auditor_task_written(auditor, task_get_filename(task),
+					FALSE);
 	}
-	gtk_list_store_insert(auditor->store, &iter, 0);
-	if((start = task_get_start(task)) != 0)
+	if(taskstore_insert(auditor->store, &iter, 0, task) != 0)
 	{
-		localtime_r(&start, &t);
-		strftime(beginning, sizeof(beginning), "%c", &t);
+		auditor_error(NULL, error_get(NULL), 1);
+		/* the tasks given remain with the caller */
+		if(created)
+			task_delete(task);
+		return NULL;
 	}
-	if((end = task_get_end(task)) != 0)
+	/* the iterators of the task store persist */
+	if((p = task_get_filename(task)) != NULL)
 	{
-		localtime_r(&end, &t);
-		strftime(completion, sizeof(completion), "%c", &t);
+		row = g_new(GtkTreeIter, 1);
+		*row = iter;
+		g_hash_table_insert(auditor->rows, g_strdup(p), row);
 	}
-	priority = task_get_priority(task);
-	for(i = 0; priority != NULL && priorities[i].title != NULL; i++)
-		if(strcmp(_(priorities[i].title), priority) == 0)
-		{
-			tp = priorities[i].priority;
-			break;
-		}
-	gtk_list_store_set(auditor->store, &iter, TD_COL_TASK, task,
-			TD_COL_DONE, task_get_done(task) > 0 ? TRUE : FALSE,
-			TD_COL_TITLE, task_get_title(task),
-			TD_COL_START, start,
-			TD_COL_DISPLAY_START, beginning,
-			TD_COL_END, end,
-			TD_COL_DISPLAY_END, completion,
-			TD_COL_PRIORITY, tp,
-			TD_COL_DISPLAY_PRIORITY, priority, -1);
+	/* otherwise indexed once the tasks are loaded */
+	if(auditor->filters[AUDITOR_VIEW_COMPLETED_TASKS] != NULL)
+		_auditor_index_start(auditor);
+	trace_end(start, "auditor", "auditor_task_add", p);
 	return task;
 }
 
 
 /* auditor_task_delete_selected */
-static void _task_delete_selected_foreach(GtkTreeRowReference * reference,
-		Auditor * auditor);
-
 void auditor_task_delete_selected(Auditor * auditor)
 {
 	GtkTreeSelection * treesel;
 	GList * selected;
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
-	GtkTreeRowReference * reference;
 	GList * s;
-	GtkTreePath * path;
+	GArray * iters;
+	GtkTreeIter iter;
+	gboolean attached;
+	guint i;
+	Task * task;
+	guint errors = 0;
+	gint64 start;
 
 	if((treesel = gtk_tree_view_get_selection(GTK_TREE_VIEW(auditor->view)))
 			== NULL)
@@ -530,39 +1169,60 @@ void auditor_task_delete_selected(Auditor * auditor)
 		return;
 	if(_auditor_confirm(auditor->window, _("Are you sure you want to delete the"
 					" selected task(s)?")) != 0)
+	{
+		g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
 		return;
+	}
+	start = trace_begin();
+	/* the iterators of the store persist, unlike the paths */
+	iters = g_array_sized_new(FALSE, FALSE, sizeof(iter),
+			g_list_length(selected));
 	for(s = g_list_first(selected); s != NULL; s = g_list_next(s))
+		if(_auditor_get_iter(auditor, &iter, s->data) == TRUE)
+			g_array_append_val(iters, iter);
+	g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+	/* remove the rows in one sweep, without any view to notify */
+	attached = (auditor->filters[AUDITOR_VIEW_COMPLETED_TASKS] != NULL);
+	_auditor_view_detach(auditor);
+	gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view), NULL);
+	for(i = 0; i < iters->len; i++)
 	{
-		if((path = s->data) == NULL)
-			continue;
-		reference = gtk_tree_row_reference_new(model, path);
-		s->data = reference;
-		gtk_tree_path_free(path);
+		iter = g_array_index(iters, GtkTreeIter, i);
+		task = taskstore_get_task(auditor->store, &iter);
+		/* the files are removed in the background, in order */
+		if(((auditor->writer != NULL)
+					? writer_remove(auditor->writer, task)
+					: task_unlink(task)) != 0 && errors++ == 0)
+			auditor_error(NULL, error_get(NULL), 1);
+		_auditor_task_remove(auditor, &iter);
 	}
-	g_list_foreach(selected, (GFunc)_task_delete_selected_foreach, auditor);
-	g_list_free(selected);
-}
-
-static void _task_delete_selected_foreach(GtkTreeRowReference * reference,
-		Auditor * auditor)
-{
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
-	GtkTreePath * path;
-	GtkTreeIter iter;
-	Task * task;
-
-	if(reference == NULL)
-		return;
-	if((path = gtk_tree_row_reference_get_path(reference)) == NULL)
-		return;
-	if(_auditor_get_iter(auditor, &iter, path) == TRUE)
+	if(attached)
+		_auditor_view_attach(auditor);
+	else
+		gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view),
+				GTK_TREE_MODEL(auditor->store));
+	/* a single durability barrier for the whole deletion, once done */
+	if(auditor->journal != NULL && ((auditor->writer != NULL)
+				? writer_sync(auditor->writer)
+				: journal_sync(auditor->journal)) != 0)
+		auditor_error(NULL, error_get(NULL), 1);
+	auditor->delete_count = iters->len - errors;
+	g_array_free(iters, TRUE);
+	trace_end(start, "auditor", "auditor_task_delete_selected", NULL);
+	/* follow the removal of the files if it takes a while */
+	if(auditor->delete_count >= AUDITOR_DELETE_PROGRESS
+			&& auditor->writer != NULL
+			&& writer_get_pending(auditor->writer) > 0)
 	{
-		gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
-		task_unlink(task);
-		task_delete(task);
+		if(auditor->delete_source == 0)
+			auditor->delete_source = g_timeout_add(
+					AUDITOR_DELETE_INTERVAL,
+					_auditor_on_delete_progress, auditor);
+		_auditor_on_delete_progress(auditor);
 	}
-	gtk_list_store_remove(auditor->store, &iter);
-	gtk_tree_path_free(path);
+	else
+		_auditor_status(auditor, _("%u task(s) deleted"),
+				auditor->delete_count);
 }
 
 
@@ -575,10 +1235,13 @@ static void _task_cursor_changed_min_end(GtkWidget * widget, gpointer data);
 static void _task_cursor_changed_min_start(GtkWidget * widget, gpointer data);
 static void _task_cursor_changed_sec_end(GtkWidget * widget, gpointer data);
 static void _task_cursor_changed_sec_start(GtkWidget * widget, gpointer data);
+static Task * _task_cursor_changed_get_task(Auditor * auditor,
+		GtkWidget * widget);
+static void _task_cursor_changed_set_task(GtkWidget * widget, Task * task);
+static void _task_cursor_changed_update(Auditor * auditor, Task * task);
 
 void auditor_task_cursor_changed(Auditor * auditor)
 {
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GtkTreePath * path = NULL;
 	GtkTreeViewColumn * column = NULL;
 	GtkTreeIter iter;
@@ -598,11 +1261,16 @@ void auditor_task_cursor_changed(Auditor * auditor)
 	gtk_tree_view_get_cursor(GTK_TREE_VIEW(auditor->view), &path, &column);
 	if(path == NULL)
 		return;
-	gtk_tree_model_get_iter(model, &iter, path);
-	gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
+	if(_auditor_get_iter(auditor, &iter, path) != TRUE)
+	{
+		gtk_tree_path_free(path);
+		return;
+	}
+	task = taskstore_get_task(auditor->store, &iter);
 	if(column != NULL)
-		id = gtk_tree_view_column_get_sort_column_id(column);
-	if(id == TD_COL_END || id == TD_COL_START)
+		id = _auditor_column_get_sort(column);
+	if((id == TD_COL_END || id == TD_COL_START)
+			&& task_get_filename(task) != NULL)
 	{
 		/* window */
 		popup = gtk_window_new(GTK_WINDOW_POPUP);
@@ -624,7 +1292,8 @@ void auditor_task_cursor_changed(Auditor * auditor)
 		g_signal_connect(button, "value-changed", G_CALLBACK(
 					(id == TD_COL_START)
 					? _task_cursor_changed_hour_start
-					: _task_cursor_changed_hour_end), task);
+					: _task_cursor_changed_hour_end), auditor);
+		_task_cursor_changed_set_task(button, task);
 		gtk_box_pack_start(GTK_BOX(hbox), button, FALSE, TRUE, 0);
 		label = gtk_label_new(_(":"));
 		gtk_box_pack_start(GTK_BOX(hbox), label, FALSE, TRUE, 0);
@@ -633,7 +1302,8 @@ void auditor_task_cursor_changed(Auditor * auditor)
 		g_signal_connect(button, "value-changed", G_CALLBACK(
 					(id == TD_COL_START)
 					? _task_cursor_changed_min_start
-					: _task_cursor_changed_min_end), task);
+					: _task_cursor_changed_min_end), auditor);
+		_task_cursor_changed_set_task(button, task);
 		gtk_box_pack_start(GTK_BOX(hbox), button, FALSE, TRUE, 0);
 		label = gtk_label_new(_(":"));
 		gtk_box_pack_start(GTK_BOX(hbox), label, FALSE, TRUE, 0);
@@ -642,7 +1312,8 @@ void auditor_task_cursor_changed(Auditor * auditor)
 		g_signal_connect(button, "value-changed", G_CALLBACK(
 					(id == TD_COL_START)
 					? _task_cursor_changed_sec_start
-					: _task_cursor_changed_sec_end), task);
+					: _task_cursor_changed_sec_end), auditor);
+		_task_cursor_changed_set_task(button, task);
 		gtk_box_pack_start(GTK_BOX(hbox), button, FALSE, TRUE, 0);
 		/* close button */
 		button = gtk_button_new();
@@ -662,7 +1333,8 @@ void auditor_task_cursor_changed(Auditor * auditor)
 		g_signal_connect(calendar, "day-selected-double-click",
 				G_CALLBACK((id == TD_COL_START)
 					? _task_cursor_changed_date_start
-					: _task_cursor_changed_date_end), task);
+					: _task_cursor_changed_date_end), auditor);
+		_task_cursor_changed_set_task(calendar, task);
 		gtk_box_pack_start(GTK_BOX(vbox), calendar, FALSE, TRUE, 0);
 		gtk_container_add(GTK_CONTAINER(popup), vbox);
 		gtk_tree_view_get_cell_area(GTK_TREE_VIEW(auditor->view), path,
@@ -676,6 +1348,38 @@ void auditor_task_cursor_changed(Auditor * auditor)
 	gtk_tree_path_free(path);
 }
 
+static Task * _task_cursor_changed_get_task(Auditor * auditor,
+		GtkWidget * widget)
+{
+	char const * filename;
+	GtkTreeIter iter;
+	Task * task;
+
+	/* the task may have been removed meanwhile */
+	filename = g_object_get_data(G_OBJECT(widget), "filename");
+	if(filename == NULL || _auditor_task_get_iter(auditor, filename, &iter)
+			!= TRUE)
+		return NULL;
+	task = taskstore_get_task(auditor->store, &iter);
+	return task;
+}
+
+static void _task_cursor_changed_set_task(GtkWidget * widget, Task * task)
+{
+	g_object_set_data_full(G_OBJECT(widget), "filename",
+			g_strdup(task_get_filename(task)), g_free);
+}
+
+static void _task_cursor_changed_update(Auditor * auditor, Task * task)
+{
+	GtkTreeIter iter;
+
+	/* the dates are not part of the search index */
+	if(_auditor_task_get_iter(auditor, task_get_filename(task), &iter)
+			== TRUE)
+		_auditor_task_set(auditor, &iter, task);
+}
+
 static time_t _task_cursor_changed_date_get(GtkWidget * widget, time_t time)
 {
 	struct tm t;
@@ -693,116 +1397,140 @@ static time_t _task_cursor_changed_date_get(GtkWidget * widget, time_t time)
 
 static void _task_cursor_changed_date_end(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_end(task);
 	time = _task_cursor_changed_date_get(widget, time);
 	task_set_end(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_date_start(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_start(task);
 	time = _task_cursor_changed_date_get(widget, time);
 	task_set_start(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_hour_end(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_end(task);
 	localtime_r(&time, &t);
 	t.tm_hour = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_end(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_hour_start(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_start(task);
 	localtime_r(&time, &t);
 	t.tm_hour = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_start(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_min_end(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_end(task);
 	localtime_r(&time, &t);
 	t.tm_min = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_end(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_min_start(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_start(task);
 	localtime_r(&time, &t);
 	t.tm_min = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_start(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_sec_end(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_end(task);
 	localtime_r(&time, &t);
 	t.tm_sec = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_end(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 static void _task_cursor_changed_sec_start(GtkWidget * widget, gpointer data)
 {
-	Task * task = data;
+	Auditor * auditor = data;
+	Task * task;
 	time_t time;
 	struct tm t;
 
+	if((task = _task_cursor_changed_get_task(auditor, widget)) == NULL)
+		return;
 	time = task_get_start(task);
 	localtime_r(&time, &t);
 	t.tm_sec = gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget));
 	time = mktime(&t);
 	task_set_start(task, time);
-	task_save(task);
-	/* FIXME actually reflect this in the GtkTreeView */
+	_task_cursor_changed_update(auditor, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 
@@ -811,8 +1539,8 @@ void auditor_task_edit(Auditor * auditor)
 {
 	GtkTreeSelection * treesel;
 	GList * selected;
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GList * s;
+	guint count;
 	GtkTreePath * path;
 	GtkTreeIter iter;
 	Task * task;
@@ -823,31 +1551,77 @@ void auditor_task_edit(Auditor * auditor)
 	if((selected = gtk_tree_selection_get_selected_rows(treesel, NULL))
 			== NULL)
 		return;
+	/* a single window for the whole selection */
+	if((count = g_list_length(selected)) > 1)
+	{
+		g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+		bulkedit_new(auditor, count);
+		return;
+	}
 	for(s = g_list_first(selected); s != NULL; s = g_list_next(s))
 	{
 		if((path = s->data) == NULL)
 			continue;
 		if(_auditor_get_iter(auditor, &iter, path) != TRUE)
 			continue;
-		gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
-		if(task != NULL)
-			taskedit_new(auditor, task);
+		task = taskstore_get_task(auditor->store, &iter);
+		if(task != NULL && taskedit_new(auditor, task) == NULL)
+			auditor_error(NULL, error_get(NULL), 1);
 	}
 	g_list_free(selected);
 }
 
 
-/* auditor_task_reload_all */
+/* auditor_task_get */
+Task * auditor_task_get(Auditor * auditor, char const * filename)
+{
+	GtkTreeIter iter;
+
+	if(_auditor_task_get_iter(auditor, filename, &iter) != TRUE)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(ENOENT));
+		return NULL;
+	}
+	return taskstore_get_task(auditor->store, &iter);
+}
+
+
+/* auditor_task_reload_all */
+static int _reload_all_foreach(char const * id, char const * data, size_t size,
+		void * priv);
+static int _reload_all_import(Auditor * auditor, GSList ** imported);
+static void _reload_all_monitor(Auditor * auditor, char const * directory);
+static size_t _reload_all_count(DIR * dir);
+static int _reload_all_push(Auditor * auditor, char const * filename);
+static void _reload_all_snapshot(Auditor * auditor, Snapshot * snapshot);
+
 int auditor_task_reload_all(Auditor * auditor)
 {
 	int ret = 0;
 	char * filename;
 	DIR * dir;
 	struct dirent * de;
+	struct stat st;
 	Task * task;
-
+	GSList * imported = NULL;
+	char * cache;
+	Snapshot * snapshot = NULL;
+	struct timespec mtime;
+	ssize_t i;
+	gint64 start = trace_begin();
+
+	_auditor_index_cancel(auditor);
+	_auditor_loader_cancel(auditor);
+	_auditor_populate_cancel(auditor);
+	_auditor_snapshot_cancel(auditor);
+	/* the files being removed must not be read again */
+	if(auditor->writer != NULL)
+		writer_flush(auditor->writer);
 	if((filename = _auditor_task_get_directory()) == NULL)
 		return auditor_error(auditor, error_get(NULL), 1);
+	auditor->reload_start = g_get_monotonic_time();
+	/* the rows are inserted progressively with the view detached */
+	_auditor_view_detach(auditor);
 	if((dir = opendir(filename)) == NULL)
 	{
 		if(errno != ENOENT)
@@ -859,6 +1633,35 @@ int auditor_task_reload_all(Auditor * auditor)
 	else
 	{
 		auditor_task_remove_all(auditor);
+		/* the tasks loaded in bulk belong to this generation */
+		if((auditor->arena = task_arena_new()) == NULL)
+			auditor_error(NULL, error_get(NULL), 1);
+		if(auditor->journal == NULL && auditor->monitor == NULL)
+			_reload_all_monitor(auditor, filename);
+		if(auditor->journal == NULL
+				&& (cache = _auditor_snapshot_get_filename())
+				!= NULL)
+		{
+			snapshot = snapshot_new(cache);
+			free(cache);
+		}
+		if(snapshot != NULL)
+			mtime = snapshot_get_mtime(snapshot);
+		if(snapshot != NULL && stat(filename, &st) == 0
+				&& st.st_mtim.tv_sec == mtime.tv_sec
+				&& st.st_mtim.tv_nsec == mtime.tv_nsec
+				&& _reload_all_count(dir)
+				== snapshot_get_count(snapshot))
+		{
+			/* no task was added or removed since the snapshot */
+			_reload_all_snapshot(auditor, snapshot);
+			closedir(dir);
+			free(filename);
+			_auditor_populate_start(auditor);
+			trace_end(start, "auditor", "auditor_task_reload_all",
+					"snapshot");
+			return 0;
+		}
 		while((de = readdir(dir)) != NULL)
 		{
 			if(strncmp(de->d_name, "task.", 5) != 0)
@@ -867,22 +1670,161 @@ int auditor_task_reload_all(Auditor * auditor)
 			if((filename = _auditor_task_get_filename(de->d_name))
 					== NULL)
 				continue; /* XXX report error */
-			if((task = task_new_from_file(filename)) == NULL)
+			task = NULL;
+			if(snapshot != NULL && stat(filename, &st) == 0
+					&& (i = snapshot_lookup(snapshot,
+							filename, &st)) >= 0)
+				task = snapshot_get_task(snapshot, i,
+						auditor->arena);
+			if(task == NULL && auditor->journal == NULL
+					&& _reload_all_push(auditor, filename)
+					== 0)
+				continue;
+			if(task == NULL
+					&& (task = task_new_from_file(filename))
+					== NULL)
 			{
 				auditor_error(NULL, error_get(NULL), 1);
 				continue;
 			}
-			if(auditor_task_add(auditor, task) == NULL)
+			if(auditor->journal != NULL)
 			{
-				task_delete(task);
-				continue; /* XXX report error */
+				/* migrate the task to the journal */
+				task_set_filename(task, de->d_name);
+				task_set_journal(task, auditor->journal);
+				if(task_save(task) == 0)
+				{
+					imported = g_slist_prepend(imported,
+							filename);
+					filename = NULL;
+					task_delete(task);
+					continue;
+				}
+				/* still listed from its file otherwise */
+				auditor_error(NULL, error_get(NULL), 1);
+				task_set_journal(task, NULL);
+				task_set_filename(task, filename);
+				task_set_dirty(task, 0);
 			}
+			_auditor_populate_queue(auditor, task);
 		}
+		closedir(dir);
+		if(snapshot != NULL)
+			snapshot_delete(snapshot);
+		/* insert the tasks parsed in the background */
+		if(auditor->loader != NULL
+				&& loader_get_pending(auditor->loader) > 0)
+			auditor->loader_source = g_timeout_add(
+					AUDITOR_LOADER_INTERVAL,
+					_auditor_on_loader_collect, auditor);
 	}
 	free(filename);
+	if(auditor->journal != NULL)
+	{
+		if(_reload_all_import(auditor, &imported) != 0)
+			ret = auditor_error(NULL, error_get(NULL), 1);
+		journal_foreach(auditor->journal, _reload_all_foreach, auditor);
+	}
+	_auditor_populate_start(auditor);
+	trace_end(start, "auditor", "auditor_task_reload_all", NULL);
+	return ret;
+}
+
+static int _reload_all_foreach(char const * id, char const * data, size_t size,
+		void * priv)
+{
+	Auditor * auditor = priv;
+	Task * task;
+
+	if((task = task_new_arena(auditor->arena)) == NULL)
+		return -1;
+	if(task_set_filename(task, id) != 0
+			|| task_load_header_data(task, data, size) != 0)
+	{
+		task_delete(task);
+		return 0; /* XXX report error */
+	}
+	task_set_journal(task, auditor->journal);
+	_auditor_populate_queue(auditor, task);
+	return 0;
+}
+
+static int _reload_all_import(Auditor * auditor, GSList ** imported)
+{
+	int ret = 0;
+	GSList * s;
+
+	/* only remove the original files once the journal is on disk */
+	if(*imported != NULL && (ret = journal_sync(auditor->journal)) == 0)
+		for(s = *imported; s != NULL; s = s->next)
+			if(unlink(s->data) != 0)
+				error_set("%s: %s", (char const *)s->data,
+						strerror(errno));
+	g_slist_free_full(*imported, free);
+	*imported = NULL;
+	return ret;
+}
+
+static void _reload_all_monitor(Auditor * auditor, char const * directory)
+{
+	GFile * file;
+	GError * error = NULL;
+
+	/* follow the changes made by other programs */
+	file = g_file_new_for_path(directory);
+	if((auditor->monitor = g_file_monitor_directory(file,
+					G_FILE_MONITOR_NONE, NULL, &error)) == NULL)
+	{
+		error_set("%s: %s", directory, error->message);
+		g_error_free(error);
+		auditor_error(NULL, error_get(NULL), 1);
+	}
+	else
+		g_signal_connect(auditor->monitor, "changed", G_CALLBACK(
+					_auditor_on_directory_changed), auditor);
+	g_object_unref(file);
+}
+
+static size_t _reload_all_count(DIR * dir)
+{
+	size_t ret = 0;
+	struct dirent * de;
+
+	while((de = readdir(dir)) != NULL)
+		if(strncmp(de->d_name, "task.", 5) == 0)
+			ret++;
+	rewinddir(dir);
 	return ret;
 }
 
+static int _reload_all_push(Auditor * auditor, char const * filename)
+{
+	if(auditor->loader == NULL
+			&& (auditor->loader = loader_new(auditor->threads))
+			== NULL)
+		return -1;
+	loader_set_arena(auditor->loader, auditor->arena);
+	/* the descriptions are not read again to be indexed */
+	loader_set_keywords(auditor->loader, 1);
+	return loader_push(auditor->loader, filename);
+}
+
+static void _reload_all_snapshot(Auditor * auditor, Snapshot * snapshot)
+{
+	size_t i;
+	size_t count;
+	Task * task;
+
+	count = snapshot_get_count(snapshot);
+	for(i = 0; i < count; i++)
+		if((task = snapshot_get_task(snapshot, i, auditor->arena))
+				!= NULL)
+			_auditor_populate_queue(auditor, task);
+	/* catch up with the tasks modified since, once populated */
+	auditor->snapshot = snapshot;
+	auditor->snapshot_pos = 0;
+}
+
 
 /* auditor_task_remove_all */
 void auditor_task_remove_all(Auditor * auditor)
@@ -890,28 +1832,42 @@ void auditor_task_remove_all(Auditor * auditor)
 	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GtkTreeIter iter;
 	gboolean valid;
-	Task * task;
+	GPtrArray * tasks;
 
+	if(auditor->writer != NULL)
+		writer_flush(auditor->writer);
+	tasks = g_ptr_array_sized_new(taskstore_get_count(auditor->store));
 	valid = gtk_tree_model_get_iter_first(model, &iter);
 	for(; valid == TRUE; valid = gtk_tree_model_iter_next(model, &iter))
-	{
-		gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
-		task_delete(task);
-	}
-	gtk_list_store_clear(auditor->store);
+		g_ptr_array_add(tasks, taskstore_get_task(auditor->store,
+					&iter));
+	g_hash_table_remove_all(auditor->rows);
+	taskstore_clear(auditor->store);
+	/* the tasks loaded in bulk and their strings are released at once */
+	task_delete_all((Task **)tasks->pdata, tasks->len, auditor->arena);
+	auditor->arena = NULL;
+	g_ptr_array_free(tasks, TRUE);
 }
 
 
 /* auditor_task_save_all */
-void auditor_task_save_all(Auditor * auditor)
+int auditor_task_save_all(Auditor * auditor)
 {
+	int ret = 0;
 	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GtkTreeIter iter;
 	gboolean valid;
+	int res;
 
 	valid = gtk_tree_model_get_iter_first(model, &iter);
 	for(; valid == TRUE; valid = gtk_tree_model_iter_next(model, &iter))
-		_auditor_task_save(auditor, &iter);
+		if((res = _auditor_task_save(auditor, &iter)) < 0)
+			auditor_error(NULL, error_get(NULL), 1);
+		else
+			ret += res;
+	if(ret > 0)
+		_auditor_status(auditor, _("%d task(s) saved"), ret);
+	return ret;
 }
 
 
@@ -927,41 +1883,30 @@ void auditor_task_select_all(Auditor * auditor)
 
 /* auditor_task_set_priority */
 void auditor_task_set_priority(Auditor * auditor, GtkTreePath * path,
-		char const * priority)
+		AuditorPriority priority)
 {
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GtkTreeIter iter;
 	Task * task;
-	size_t i;
-	AuditorPriority tp = AUDITOR_PRIORITY_UNKNOWN;
 
 	_auditor_get_iter(auditor, &iter, path);
-	gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
+	task = taskstore_get_task(auditor->store, &iter);
 	task_set_priority(task, priority);
-	for(i = 0; priorities[i].title != NULL; i++)
-		if(strcmp(_(priorities[i].title), priority) == 0)
-		{
-			tp = priorities[i].priority;
-			break;
-		}
-	gtk_list_store_set(auditor->store, &iter, TD_COL_PRIORITY, tp,
-			TD_COL_DISPLAY_PRIORITY, priority, -1);
-	task_save(task);
+	_auditor_task_set(auditor, &iter, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 
 /* auditor_task_set_title */
 void auditor_task_set_title(Auditor * auditor, GtkTreePath * path, char const * title)
 {
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
 	GtkTreeIter iter;
 	Task * task;
 
 	_auditor_get_iter(auditor, &iter, path);
-	gtk_tree_model_get(model, &iter, TD_COL_TASK, &task, -1);
+	task = taskstore_get_task(auditor->store, &iter);
 	task_set_title(task, title);
-	gtk_list_store_set(auditor->store, &iter, TD_COL_TITLE, title, -1);
-	task_save(task);
+	_auditor_task_set(auditor, &iter, task);
+	_auditor_task_save_queue(auditor, task);
 }
 
 
@@ -970,29 +1915,227 @@ void auditor_task_toggle_done(Auditor * auditor, GtkTreePath * path)
 {
 	GtkTreeIter iter;
 	Task * task;
-	gboolean done;
-	time_t end;
-	struct tm t;
-	char completion[32] = "";
 
 	_auditor_get_iter(auditor, &iter, path);
-	gtk_tree_model_get(GTK_TREE_MODEL(auditor->store), &iter,
-			TD_COL_TASK, &task, TD_COL_DONE, &done, -1);
-	done = !done;
-	task_set_done(task, done);
-	if((end = task_get_end(task)) != 0) /* XXX code duplication */
+	task = taskstore_get_task(auditor->store, &iter);
+	task_set_done(task, (task_get_done(task) > 0) ? 0 : 1);
+	_auditor_task_set(auditor, &iter, task);
+	_auditor_task_save_queue(auditor, task);
+}
+
+
+/* auditor_task_update */
+int auditor_task_update(Auditor * auditor, Task * task)
+{
+	char const * filename;
+	GtkTreeIter iter;
+	gint64 start = trace_begin();
+
+	/* only the row of this task is refreshed */
+	if((filename = task_get_filename(task)) == NULL
+			|| _auditor_task_get_iter(auditor, filename, &iter)
+			!= TRUE
+			|| taskstore_get_task(auditor->store, &iter) != task)
+		return -error_set_code(1, "%s: %s", (filename != NULL)
+				? filename : _("New task"), strerror(ENOENT));
+	/* the description may have changed as well */
+	if(taskstore_reindex(auditor->store, &iter) != 0)
+		auditor_error(NULL, error_get(NULL), 1);
+	_auditor_task_set(auditor, &iter, task);
+	trace_end(start, "auditor", "auditor_task_update", filename);
+	return 0;
+}
+
+
+/* auditor_task_update_selected */
+static int _update_selected_task(Task * task, AuditorBulk const * bulk);
+
+void auditor_task_update_selected(Auditor * auditor, AuditorBulk const * bulk)
+{
+	GtkTreeSelection * treesel;
+	GList * selected;
+	GList * s;
+	GArray * iters;
+	GtkTreeIter iter;
+	guint i;
+	Task * task;
+	int res;
+	guint changed = 0;
+	guint errors = 0;
+	gint64 start;
+
+	if((treesel = gtk_tree_view_get_selection(GTK_TREE_VIEW(auditor->view)))
+			== NULL)
+		return;
+	if((selected = gtk_tree_selection_get_selected_rows(treesel, NULL))
+			== NULL)
+		return;
+	start = trace_begin();
+	/* the iterators of the store persist, unlike the paths */
+	iters = g_array_sized_new(FALSE, FALSE, sizeof(iter),
+			g_list_length(selected));
+	for(s = g_list_first(selected); s != NULL; s = g_list_next(s))
+		if(_auditor_get_iter(auditor, &iter, s->data) == TRUE)
+			g_array_append_val(iters, iter);
+	g_list_free_full(selected, (GDestroyNotify)gtk_tree_path_free);
+	/* the rows are moved and saved all at once afterwards */
+	taskstore_freeze(auditor->store);
+	if(auditor->writer != NULL)
+		writer_freeze(auditor->writer);
+	for(i = 0; i < iters->len; i++)
+	{
+		iter = g_array_index(iters, GtkTreeIter, i);
+		task = taskstore_get_task(auditor->store, &iter);
+		if((res = _update_selected_task(task, bulk)) < 0)
+		{
+			if(errors++ == 0)
+				auditor_error(NULL, error_get(NULL), 1);
+			continue;
+		}
+		/* the tasks already as requested are left untouched */
+		if(res == 0)
+			continue;
+		changed++;
+		_auditor_task_set(auditor, &iter, task);
+		if(auditor->writer != NULL)
+			_auditor_task_written(auditor, task_get_filename(task),
+					TRUE);
+		if(((auditor->writer != NULL)
+					? writer_queue(auditor->writer, task)
+					: task_save(task)) != 0)
+		{
+			if(errors++ == 0)
+				auditor_error(NULL, error_get(NULL), 1);
+			continue;
+		}
+		if(auditor->writer == NULL)
+			_auditor_task_written(auditor, task_get_filename(task),
+					FALSE);
+	}
+	if(taskstore_thaw(auditor->store) != 0)
+		auditor_error(NULL, error_get(NULL), 1);
+	/* queued at once, without waiting for the writes to complete */
+	if(auditor->writer != NULL)
+		writer_thaw(auditor->writer);
+	if(auditor->journal != NULL && ((auditor->writer != NULL)
+				? writer_sync(auditor->writer)
+				: journal_sync(auditor->journal)) != 0)
+		auditor_error(NULL, error_get(NULL), 1);
+	_auditor_status(auditor, _("%u task(s) changed"), changed);
+	g_array_free(iters, TRUE);
+	trace_end(start, "auditor", "auditor_task_update_selected", NULL);
+}
+
+static int _update_selected_task(Task * task, AuditorBulk const * bulk)
+{
+	int ret = 0;
+	char const * category;
+	time_t t;
+
+	/* only what differs is set, the end date of a task done included */
+	if((bulk->fields & AUDITOR_BULK_DONE)
+			&& (task_get_done(task) > 0) != (bulk->done != 0))
+	{
+		if(task_set_done(task, bulk->done) != 0)
+			return -1;
+		ret = 1;
+	}
+	if((bulk->fields & AUDITOR_BULK_PRIORITY)
+			&& task_get_priority(task) != bulk->priority)
+	{
+		if(task_set_priority(task, bulk->priority) != 0)
+			return -1;
+		ret = 1;
+	}
+	category = (bulk->category != NULL) ? bulk->category : "";
+	if((bulk->fields & AUDITOR_BULK_CATEGORY)
+			&& strcmp(task_get_category(task), category) != 0)
+	{
+		if(task_set_category(task, category) != 0)
+			return -1;
+		ret = 1;
+	}
+	if((bulk->fields & AUDITOR_BULK_SHIFT) == 0 || bulk->shift == 0)
+		return ret;
+	/* the dates not set remain so */
+	if((t = task_get_start(task)) != 0)
+	{
+		if(task_set_start(task, t + bulk->shift) != 0)
+			return -1;
+		ret = 1;
+	}
+	if((t = task_get_end(task)) != 0)
 	{
-		localtime_r(&end, &t);
-		strftime(completion, sizeof(completion), "%c", &t);
+		if(task_set_end(task, t + bulk->shift) != 0)
+			return -1;
+		ret = 1;
 	}
-	gtk_list_store_set(auditor->store, &iter, TD_COL_DONE, done,
-			TD_COL_END, end, TD_COL_DISPLAY_END, completion, -1);
-	task_save(task);
+	return ret;
+}
+
+
+/* views */
+/* auditor_view_edit */
+void auditor_view_edit(Auditor * auditor)
+{
+	viewedit_new(auditor, GTK_TREE_MODEL(auditor->views));
+}
+
+
+/* auditor_view_remove */
+int auditor_view_remove(Auditor * auditor, char const * name)
+{
+	GtkTreeIter iter;
+
+	if(_auditor_views_get_iter(auditor, name, &iter) != TRUE)
+		return -error_set_code(1, "%s: %s", name, _("No such view"));
+	gtk_list_store_remove(auditor->views, &iter);
+	_auditor_views_menu(auditor);
+	return _auditor_views_save(auditor);
+}
+
+
+/* auditor_view_save */
+int auditor_view_save(Auditor * auditor, char const * name,
+		char const * filter)
+{
+	GtkTreeIter iter;
+
+	/* the views are saved as configuration variables */
+	if(name[0] == '\0' || name[0] == '[' || name[0] == '#'
+			|| strpbrk(name, "=\n") != NULL
+			|| strchr(filter, '\n') != NULL)
+		return -error_set_code(1, "%s: %s", name,
+				_("Invalid name for a view"));
+	if(_auditor_views_get_iter(auditor, name, &iter) != TRUE)
+		gtk_list_store_append(auditor->views, &iter);
+	gtk_list_store_set(auditor->views, &iter, 0, name, 1, filter, -1);
+	_auditor_views_menu(auditor);
+	return _auditor_views_save(auditor);
 }
 
 
 /* private */
 /* functions */
+/* auditor_column_get_sort */
+static gint _auditor_column_get_sort(GtkTreeViewColumn * column)
+{
+	return GPOINTER_TO_INT(g_object_get_data(G_OBJECT(column), "sort"));
+}
+
+
+/* auditor_column_set_sort */
+static void _auditor_column_set_sort(Auditor * auditor,
+		GtkTreeViewColumn * column, gint id)
+{
+	/* sorted by the store itself, even when filtered */
+	g_object_set_data(G_OBJECT(column), "sort", GINT_TO_POINTER(id));
+	gtk_tree_view_column_set_clickable(column, TRUE);
+	g_signal_connect(column, "clicked", G_CALLBACK(
+				_auditor_on_column_clicked), auditor);
+}
+
+
 /* auditor_confirm */
 static int _auditor_confirm(GtkWidget * window, char const * message)
 {
@@ -1017,125 +2160,902 @@ static int _auditor_confirm(GtkWidget * window, char const * message)
 }
 
 
+/* auditor_exchange_get_filename */
+static char * _auditor_exchange_get_filename(Auditor * auditor,
+		char const * title, GtkFileChooserAction action)
+{
+	char * ret = NULL;
+	GtkWidget * dialog;
+	GtkFileFilter * filter;
+
+	dialog = gtk_file_chooser_dialog_new(title,
+			GTK_WINDOW(auditor->window), action,
+			GTK_STOCK_CANCEL, GTK_RESPONSE_CANCEL,
+			(action == GTK_FILE_CHOOSER_ACTION_SAVE)
+			? GTK_STOCK_SAVE : GTK_STOCK_OPEN, GTK_RESPONSE_ACCEPT,
+			NULL);
+#if GTK_CHECK_VERSION(2, 8, 0)
+	gtk_file_chooser_set_do_overwrite_confirmation(GTK_FILE_CHOOSER(
+				dialog), TRUE);
+#endif
+	filter = gtk_file_filter_new();
+	gtk_file_filter_set_name(filter, _("CSV files"));
+	gtk_file_filter_add_pattern(filter, "*.csv");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+	filter = gtk_file_filter_new();
+	gtk_file_filter_set_name(filter, _("JSON Lines files"));
+	gtk_file_filter_add_pattern(filter, "*.jsonl");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+	filter = gtk_file_filter_new();
+	gtk_file_filter_set_name(filter, _("todo.txt files"));
+	gtk_file_filter_add_pattern(filter, "*.txt");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+	filter = gtk_file_filter_new();
+	gtk_file_filter_set_name(filter, _("All files"));
+	gtk_file_filter_add_pattern(filter, "*");
+	gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+	if(gtk_dialog_run(GTK_DIALOG(dialog)) == GTK_RESPONSE_ACCEPT)
+		ret = gtk_file_chooser_get_filename(GTK_FILE_CHOOSER(dialog));
+	gtk_widget_destroy(dialog);
+	return ret;
+}
+
+
 /* auditor_get_iter */
 static gboolean _auditor_get_iter(Auditor * auditor, GtkTreeIter * iter,
 		GtkTreePath * path)
 {
+	GtkTreeModel * model;
 	GtkTreeIter p;
 
-	if(gtk_tree_model_get_iter(GTK_TREE_MODEL(auditor->filter_sort), iter,
-				path) == FALSE)
+	/* the view may be set on the store directly */
+	model = gtk_tree_view_get_model(GTK_TREE_VIEW(auditor->view));
+	if(model == GTK_TREE_MODEL(auditor->store))
+		return gtk_tree_model_get_iter(model, iter, path);
+	if(gtk_tree_model_get_iter(model, &p, path) == FALSE)
 		return FALSE;
-	gtk_tree_model_sort_convert_iter_to_child_iter(GTK_TREE_MODEL_SORT(
-				auditor->filter_sort), &p, iter);
 	gtk_tree_model_filter_convert_iter_to_child_iter(GTK_TREE_MODEL_FILTER(
-				auditor->filter), iter, &p);
+				model), iter, &p);
 	return TRUE;
 }
 
 
-/* auditor_task_get_directory */
-static char * _auditor_task_get_directory(void)
+/* auditor_view_attach */
+static void _auditor_view_attach(Auditor * auditor)
 {
-	char const * homedir;
-	size_t len;
-	char const directory[] = ".auditor";
-	char * filename;
+	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
+	GtkTreeModel ** filters = auditor->filters;
 
-	if((homedir = getenv("HOME")) == NULL)
-		homedir = g_get_home_dir();
-	len = strlen(homedir) + 1 + sizeof(directory);
-	if((filename = malloc(len)) == NULL)
-		return NULL;
-	snprintf(filename, len, "%s/%s", homedir, directory);
-	return filename;
+	if(filters[AUDITOR_VIEW_COMPLETED_TASKS] != NULL)
+		return;
+	/* the store keeps the rows sorted, and the filters are kept up to
+	 * date so that switching views does not filter the rows again */
+	filters[AUDITOR_VIEW_ALL_TASKS] = gtk_tree_model_filter_new(model,
+			NULL);
+	gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(
+				filters[AUDITOR_VIEW_ALL_TASKS]),
+			_auditor_on_filter_all, auditor, NULL);
+	filters[AUDITOR_VIEW_COMPLETED_TASKS] = gtk_tree_model_filter_new(
+			model, NULL);
+	gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(
+				filters[AUDITOR_VIEW_COMPLETED_TASKS]),
+			_auditor_on_filter_completed, auditor, NULL);
+	filters[AUDITOR_VIEW_REMAINING_TASKS] = gtk_tree_model_filter_new(
+			model, NULL);
+	gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(
+				filters[AUDITOR_VIEW_REMAINING_TASKS]),
+			_auditor_on_filter_remaining, auditor, NULL);
+	filters[AUDITOR_VIEW_FILTERED_TASKS] = gtk_tree_model_filter_new(
+			model, NULL);
+	gtk_tree_model_filter_set_visible_func(GTK_TREE_MODEL_FILTER(
+				filters[AUDITOR_VIEW_FILTERED_TASKS]),
+			_auditor_on_filter_filtered, auditor, NULL);
+	memset(&auditor->filters_stale, 0, sizeof(auditor->filters_stale));
+	gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view),
+			_auditor_view_get_model(auditor));
 }
 
 
-/* auditor_task_get_filename */
-static char * _auditor_task_get_filename(char const * filenam)
+/* auditor_view_detach */
+static void _auditor_view_detach(Auditor * auditor)
 {
-	char const * homedir;
-	int len;
-	char const directory[] = ".auditor";
-	char * pathname;
+	size_t i;
 
-	if((homedir = getenv("HOME")) == NULL)
-		homedir = g_get_home_dir();
-	len = strlen(homedir) + 1 + sizeof(directory) + 1 + strlen(filenam) + 1;
-	if((pathname = malloc(len)) == NULL)
-		return NULL;
-	snprintf(pathname, len, "%s/%s/%s", homedir, directory, filenam);
-	return pathname;
+	if(auditor->filters[AUDITOR_VIEW_COMPLETED_TASKS] == NULL)
+		return;
+	/* do not filter the rows while populating */
+	gtk_tree_view_set_model(GTK_TREE_VIEW(auditor->view),
+			GTK_TREE_MODEL(auditor->store));
+	for(i = 0; i < AUDITOR_VIEW_COUNT; i++)
+		if(auditor->filters[i] != NULL)
+		{
+			g_object_unref(auditor->filters[i]);
+			auditor->filters[i] = NULL;
+		}
 }
 
 
-/* auditor_task_get_new_filename */
-static char * _auditor_task_get_new_filename(void)
+/* auditor_view_get_model */
+static GtkTreeModel * _auditor_view_get_model(Auditor * auditor)
 {
-	char const * homedir;
-	int len;
-	char const directory[] = ".auditor";
-	char template[] = "task.XXXXXX";
+	/* every task is displayed unless searching */
+	if(auditor->filter_view == AUDITOR_VIEW_ALL_TASKS
+			&& taskstore_get_search(auditor->store) == NULL)
+		return GTK_TREE_MODEL(auditor->store);
+	if(auditor->filters[auditor->filter_view] != NULL)
+		return auditor->filters[auditor->filter_view];
+	return GTK_TREE_MODEL(auditor->store);
+}
+
+
+/* auditor_views_get_filename */
+static char * _auditor_views_get_filename(void)
+{
+	gchar * directory;
+	size_t len;
+	char const views[] = "views";
 	char * filename;
-	int fd;
 
-	if((homedir = getenv("HOME")) == NULL)
-		homedir = g_get_home_dir();
-	len = strlen(homedir) + 1 + sizeof(directory) + 1 + sizeof(template);
-	if((filename = malloc(len)) == NULL)
-		return NULL;
-	snprintf(filename, len, "%s/%s", homedir, directory);
-	if((mkdir(filename, 0777) != 0 && errno != EEXIST)
-			|| snprintf(filename, len, "%s/%s/%s", homedir,
-				directory, template) >= len
-			|| (fd = mkstemp(filename)) < 0)
+	directory = g_build_filename(g_get_user_config_dir(), PROGNAME_AUDITOR,
+			NULL);
+	if(g_mkdir_with_parents(directory, 0700) != 0)
 	{
-		error_set("%s: %s", filename, strerror(errno));
-		free(filename);
+		error_set("%s: %s", directory, strerror(errno));
+		g_free(directory);
 		return NULL;
 	}
-	close(fd);
+	len = strlen(directory) + 1 + sizeof(views);
+	if((filename = malloc(len)) != NULL)
+		snprintf(filename, len, "%s/%s", directory, views);
+	g_free(directory);
 	return filename;
 }
 
 
-/* auditor_task_save */
-static void _auditor_task_save(Auditor * auditor, GtkTreeIter * iter)
+/* auditor_views_get_iter */
+static gboolean _auditor_views_get_iter(Auditor * auditor, char const * name,
+		GtkTreeIter * iter)
 {
-	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
-	Task * task;
+	GtkTreeModel * model = GTK_TREE_MODEL(auditor->views);
+	gboolean valid;
+	gchar * p;
+	int res;
 
-	gtk_tree_model_get(model, iter, TD_COL_TASK, &task, -1);
-	task_save(task);
+	valid = gtk_tree_model_get_iter_first(model, iter);
+	for(; valid == TRUE; valid = gtk_tree_model_iter_next(model, iter))
+	{
+		gtk_tree_model_get(model, iter, 0, &p, -1);
+		res = (p != NULL) ? strcmp(p, name) : -1;
+		g_free(p);
+		if(res == 0)
+			return TRUE;
+	}
+	return FALSE;
 }
 
 
-/* callbacks */
-/* auditor_on_view_all_tasks */
-static void _auditor_on_view_all_tasks(gpointer data)
+/* auditor_views_load */
+static void _views_load_foreach(String const * variable, String const * value,
+		void * data);
+
+static void _auditor_views_load(Auditor * auditor)
 {
-	Auditor * auditor = data;
+	char * filename;
+	Config * config;
 
-	auditor_set_view(auditor, AUDITOR_VIEW_ALL_TASKS);
+	if((filename = _auditor_views_get_filename()) == NULL)
+	{
+		auditor_error(NULL, error_get(NULL), 1);
+		return;
+	}
+	if(access(filename, F_OK) == 0 && (config = config_new()) != NULL)
+	{
+		if(config_load(config, filename) == 0)
+			config_foreach_section(config, "", _views_load_foreach,
+					auditor);
+		else
+			auditor_error(NULL, error_get(NULL), 1);
+		config_delete(config);
+	}
+	free(filename);
 }
 
-
-/* auditor_on_view_completed_tasks */
-static void _auditor_on_view_completed_tasks(gpointer data)
+static void _views_load_foreach(String const * variable, String const * value,
+		void * data)
 {
 	Auditor * auditor = data;
+	GtkTreeIter iter;
 
-	auditor_set_view(auditor, AUDITOR_VIEW_COMPLETED_TASKS);
+	if(value == NULL)
+		return;
+	gtk_list_store_append(auditor->views, &iter);
+	gtk_list_store_set(auditor->views, &iter, 0, variable, 1, value, -1);
 }
 
 
-/* auditor_on_view_remaining_tasks */
-static void _auditor_on_view_remaining_tasks(gpointer data)
+/* auditor_views_menu */
+static void _auditor_views_menu(Auditor * auditor)
 {
-	Auditor * auditor = data;
-
-	auditor_set_view(auditor, AUDITOR_VIEW_REMAINING_TASKS);
+	GtkTreeModel * model = GTK_TREE_MODEL(auditor->views);
+	GtkWidget * menu;
+	GtkWidget * menuitem;
+	GtkTreeIter iter;
+	gboolean valid;
+	gchar * name;
+	gchar * filter;
+
+	menu = gtk_menu_new();
+	menuitem = gtk_menu_item_new_with_label(_("All tasks"));
+	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
+				_auditor_on_view_all_tasks), auditor);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	menuitem = gtk_menu_item_new_with_label(_("Completed tasks"));
+	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
+				_auditor_on_view_completed_tasks), auditor);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	menuitem = gtk_menu_item_new_with_label(_("Remaining tasks"));
+	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
+				_auditor_on_view_remaining_tasks), auditor);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	menuitem = gtk_separator_menu_item_new();
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	/* views saved */
+	valid = gtk_tree_model_get_iter_first(model, &iter);
+	for(; valid == TRUE; valid = gtk_tree_model_iter_next(model, &iter))
+	{
+		gtk_tree_model_get(model, &iter, 0, &name, 1, &filter, -1);
+		menuitem = gtk_menu_item_new_with_label(name);
+		g_object_set_data_full(G_OBJECT(menuitem), "filter", filter,
+				g_free);
+		g_signal_connect(menuitem, "activate", G_CALLBACK(
+					_auditor_on_view_saved), auditor);
+		gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+		g_free(name);
+	}
+	if(gtk_tree_model_iter_n_children(model, NULL) > 0)
+	{
+		menuitem = gtk_separator_menu_item_new();
+		gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	}
+	menuitem = gtk_menu_item_new_with_label(_("Custom view..."));
+	g_signal_connect_swapped(menuitem, "activate", G_CALLBACK(
+				_auditor_on_view_custom), auditor);
+	gtk_menu_shell_append(GTK_MENU_SHELL(menu), menuitem);
+	gtk_widget_show_all(menu);
+	gtk_menu_tool_button_set_menu(GTK_MENU_TOOL_BUTTON(auditor->view_as),
+			menu);
+}
+
+
+/* auditor_views_save */
+static int _auditor_views_save(Auditor * auditor)
+{
+	int ret;
+	GtkTreeModel * model = GTK_TREE_MODEL(auditor->views);
+	GtkTreeIter iter;
+	gboolean valid;
+	gchar * name;
+	gchar * filter;
+	char * filename;
+	Config * config;
+
+	if((filename = _auditor_views_get_filename()) == NULL)
+		return -1;
+	if((config = config_new()) == NULL)
+	{
+		free(filename);
+		return -1;
+	}
+	valid = gtk_tree_model_get_iter_first(model, &iter);
+	for(ret = 0; valid == TRUE && ret == 0;
+			valid = gtk_tree_model_iter_next(model, &iter))
+	{
+		gtk_tree_model_get(model, &iter, 0, &name, 1, &filter, -1);
+		ret = config_set(config, NULL, name, filter);
+		g_free(name);
+		g_free(filter);
+	}
+	if(ret == 0)
+		ret = config_save(config, filename);
+	config_delete(config);
+	free(filename);
+	return ret;
+}
+
+
+/* auditor_task_get_iter */
+static gboolean _auditor_task_get_iter(Auditor * auditor,
+		char const * filename, GtkTreeIter * iter)
+{
+	GtkTreeIter * p;
+
+	if((p = g_hash_table_lookup(auditor->rows, filename)) == NULL)
+		return FALSE;
+	*iter = *p;
+	return TRUE;
+}
+
+
+/* auditor_task_get_directory */
+static char * _auditor_task_get_directory(void)
+{
+	char const * homedir;
+	size_t len;
+	char const directory[] = ".auditor";
+	char * filename;
+
+	if((homedir = getenv("HOME")) == NULL)
+		homedir = g_get_home_dir();
+	len = strlen(homedir) + 1 + sizeof(directory);
+	if((filename = malloc(len)) == NULL)
+		return NULL;
+	snprintf(filename, len, "%s/%s", homedir, directory);
+	return filename;
+}
+
+
+/* auditor_task_get_filename */
+static char * _auditor_task_get_filename(char const * filenam)
+{
+	char const * homedir;
+	int len;
+	char const directory[] = ".auditor";
+	char * pathname;
+
+	if((homedir = getenv("HOME")) == NULL)
+		homedir = g_get_home_dir();
+	len = strlen(homedir) + 1 + sizeof(directory) + 1 + strlen(filenam) + 1;
+	if((pathname = malloc(len)) == NULL)
+		return NULL;
+	snprintf(pathname, len, "%s/%s/%s", homedir, directory, filenam);
+	return pathname;
+}
+
+
+/* auditor_task_get_new_filename */
+static char * _auditor_task_get_new_filename(void)
+{
+	char const * homedir;
+	int len;
+	char const directory[] = ".auditor";
+	char template[] = "task.XXXXXX";
+	char * filename;
+	int fd;
+
+	if((homedir = getenv("HOME")) == NULL)
+		homedir = g_get_home_dir();
+	len = strlen(homedir) + 1 + sizeof(directory) + 1 + sizeof(template);
+	if((filename = malloc(len)) == NULL)
+		return NULL;
+	snprintf(filename, len, "%s/%s", homedir, directory);
+	if((mkdir(filename, 0777) != 0 && errno != EEXIST)
+			|| snprintf(filename, len, "%s/%s/%s", homedir,
+				directory, template) >= len
+			|| (fd = mkstemp(filename)) < 0)
+	{
+		error_set("%s: %s", filename, strerror(errno));
+		free(filename);
+		return NULL;
+	}
+	close(fd);
+	return filename;
+}
+
+
+/* auditor_task_save */
+static int _auditor_task_save(Auditor * auditor, GtkTreeIter * iter)
+{
+	Task * task;
+
+	task = taskstore_get_task(auditor->store, iter);
+	if(task_get_dirty(task) == 0)
+		return 0;
+	if(task_save(task) != 0)
+		return -1;
+	_auditor_task_written(auditor, task_get_filename(task), FALSE);
+	return 1;
+}
+
+
+/* auditor_task_save_queue */
+static void _auditor_task_save_queue(Auditor * auditor, Task * task)
+{
+	if(auditor->writer == NULL)
+	{
+		if(task_save(task) != 0)
+			auditor_error(auditor, error_get(NULL), 1);
+		else
+			_auditor_task_written(auditor, task_get_filename(task),
+					FALSE);
+		return;
+	}
+	/* possibly written already once queued */
+	_auditor_task_written(auditor, task_get_filename(task), TRUE);
+	if(writer_queue(auditor->writer, task) != 0)
+		auditor_error(auditor, error_get(NULL), 1);
+}
+
+
+/* auditor_task_remove */
+static gboolean _auditor_task_remove(Auditor * auditor, GtkTreeIter * iter)
+{
+	Task * task;
+	char const * filename;
+
+	task = taskstore_get_task(auditor->store, iter);
+	if((filename = task_get_filename(task)) != NULL)
+		g_hash_table_remove(auditor->rows, filename);
+	if(auditor->writer != NULL)
+		writer_cancel(auditor->writer, task);
+	task_delete(task);
+	return taskstore_remove(auditor->store, iter);
+}
+
+
+/* auditor_task_set */
+static void _auditor_task_set(Auditor * auditor, GtkTreeIter * iter,
+		Task * task)
+{
+	GtkTreeModel * model;
+	GtkTreeSelection * treesel;
+	GtkTreeIter p;
+	gboolean selected = FALSE;
+
+	/* the row is removed and inserted again if moved, unselecting it */
+	model = gtk_tree_view_get_model(GTK_TREE_VIEW(auditor->view));
+	treesel = gtk_tree_view_get_selection(GTK_TREE_VIEW(auditor->view));
+	if(model == GTK_TREE_MODEL(auditor->store))
+		selected = gtk_tree_selection_iter_is_selected(treesel, iter);
+	else if(model != NULL
+			&& gtk_tree_model_filter_convert_child_iter_to_iter(
+				GTK_TREE_MODEL_FILTER(model), &p, iter))
+		selected = gtk_tree_selection_iter_is_selected(treesel, &p);
+	if(taskstore_set(auditor->store, iter, task) != 0)
+	{
+		auditor_error(NULL, error_get(NULL), 1);
+		return;
+	}
+	if(selected == FALSE)
+		return;
+	if(model == GTK_TREE_MODEL(auditor->store))
+		gtk_tree_selection_select_iter(treesel, iter);
+	else if(gtk_tree_model_filter_convert_child_iter_to_iter(
+				GTK_TREE_MODEL_FILTER(model), &p, iter))
+		gtk_tree_selection_select_iter(treesel, &p);
+}
+
+
+/* auditor_task_written */
+static void _auditor_task_written(Auditor * auditor, char const * filename,
+		gboolean pending)
+{
+	AuditorWrite * write;
+	struct stat st;
+
+	/* only the changes to the files monitored are told apart */
+	if(auditor->monitor == NULL || filename == NULL)
+		return;
+	if(!pending && stat(filename, &st) != 0)
+	{
+		g_hash_table_remove(auditor->writes, filename);
+		return;
+	}
+	if((write = g_hash_table_lookup(auditor->writes, filename)) == NULL)
+	{
+		write = g_new(AuditorWrite, 1);
+		g_hash_table_insert(auditor->writes, g_strdup(filename),
+				write);
+	}
+	if(pending)
+		write->size = -1;
+	else
+	{
+		write->mtime = st.st_mtim;
+		write->size = st.st_size;
+	}
+}
+
+
+/* auditor_import_close */
+static int _auditor_import_close(Auditor * auditor)
+{
+	int ret = 0;
+
+	if(auditor->import_exchange != NULL)
+		exchange_delete(auditor->import_exchange);
+	auditor->import_exchange = NULL;
+	if(auditor->import_fp != NULL)
+		fclose(auditor->import_fp);
+	auditor->import_fp = NULL;
+	/* a single durability barrier for the whole import */
+	if(auditor->journal != NULL)
+		ret = journal_sync(auditor->journal);
+	else if(_auditor_import_sync(auditor, 0) != 0)
+		ret = -1;
+	if(auditor->import_files != NULL)
+		g_ptr_array_free(auditor->import_files, TRUE);
+	auditor->import_files = NULL;
+	return ret;
+}
+
+
+/* auditor_import_sync */
+static int _auditor_import_sync(Auditor * auditor, gint64 deadline)
+{
+	int ret = 0;
+	GPtrArray * files = auditor->import_files;
+	char * directory;
+
+	if(files == NULL)
+		return 0;
+	while(auditor->import_synced < files->len)
+	{
+		if(deadline != 0 && g_get_monotonic_time() >= deadline)
+			return 1;
+		if(task_sync_file(g_ptr_array_index(files,
+						auditor->import_synced++)) != 0)
+			ret = -1;
+	}
+	/* the new entries in the directory as well */
+	if(files->len == 0)
+		return ret;
+	g_ptr_array_set_size(files, 0);
+	auditor->import_synced = 0;
+	if((directory = _auditor_task_get_directory()) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	if(task_sync_directory(directory) != 0)
+		ret = -1;
+	free(directory);
+	return ret;
+}
+
+
+/* auditor_index_cancel */
+static void _auditor_index_cancel(Auditor * auditor)
+{
+	if(auditor->index_source != 0)
+		g_source_remove(auditor->index_source);
+	auditor->index_source = 0;
+}
+
+
+/* auditor_index_start */
+static void _auditor_index_start(Auditor * auditor)
+{
+	if(auditor->index_source == 0)
+		auditor->index_source = g_idle_add(_auditor_on_index, auditor);
+}
+
+
+/* auditor_loader_cancel */
+static void _auditor_loader_cancel(Auditor * auditor)
+{
+	if(auditor->loader_source != 0)
+		g_source_remove(auditor->loader_source);
+	auditor->loader_source = 0;
+	/* waits for the pending tasks and discards them */
+	if(auditor->loader != NULL)
+		loader_delete(auditor->loader);
+	auditor->loader = NULL;
+}
+
+
+/* auditor_performance_duration */
+static void _auditor_performance_duration(char * buf, size_t size,
+		unsigned long long duration)
+{
+	if(duration < 1000)
+		snprintf(buf, size, _("%llu us"), duration);
+	else if(duration < 1000000)
+		snprintf(buf, size, _("%.1f ms"), duration / 1000.0);
+	else
+		snprintf(buf, size, _("%.2f s"), duration / 1000000.0);
+}
+
+
+/* auditor_performance_memory */
+static unsigned long _auditor_performance_memory(void)
+{
+	struct rusage ru;
+
+	/* in kilobytes */
+	if(getrusage(RUSAGE_SELF, &ru) != 0)
+		return 0;
+#ifdef __APPLE__
+	return ru.ru_maxrss / 1024;
+#else
+	return ru.ru_maxrss;
+#endif
+}
+
+
+/* auditor_performance_update */
+static void _auditor_performance_update(Auditor * auditor)
+{
+	TaskStats stats;
+	unsigned int count;
+	size_t pending;
+	unsigned long long latency;
+	TaskStoreMemory store;
+	size_t memory;
+	size_t i;
+	unsigned long tasks;
+	char reload[32];
+	char save[32];
+	char average[32];
+	char buf[128];
+
+	task_stats_get(&stats);
+	count = auditor_get_count(auditor, AUDITOR_VIEW_ALL_TASKS);
+	pending = (auditor->writer != NULL)
+		? writer_get_pending(auditor->writer) : 0;
+	/* the background writes if any, the last save otherwise */
+	latency = (auditor->writer != NULL
+			&& writer_get_latency(auditor->writer) > 0)
+		? writer_get_latency(auditor->writer) : stats.save_last;
+	/* as accounted by the tasks and the store */
+	taskstore_get_memory(auditor->store, &store);
+	memory = store.rows + store.indexes + store.titles + store.search;
+	for(i = 0; i < TASK_MEMORY_COUNT; i++)
+		memory += stats.memory[i];
+	tasks = (stats.tasks > 0) ? stats.tasks : 1;
+	_auditor_performance_duration(reload, sizeof(reload),
+			auditor->reload_time);
+	_auditor_performance_duration(save, sizeof(save), latency);
+	if(auditor->statusbar != NULL)
+	{
+		if(pending > 0)
+			snprintf(buf, sizeof(buf), _("%u tasks | loaded in %s |"
+						" %zu write(s) pending | %.1f MiB"),
+					count, reload, pending,
+					memory / 1048576.0);
+		else
+			snprintf(buf, sizeof(buf), _("%u tasks | loaded in %s |"
+						" saved in %s | %.1f MiB"), count,
+					reload, save, memory / 1048576.0);
+		gtk_label_set_text(GTK_LABEL(auditor->performance), buf);
+	}
+	if(!gtk_widget_get_visible(auditor->performance_panel))
+		return;
+	snprintf(buf, sizeof(buf), _("%u (%u completed, %u remaining)"),
+			count, auditor_get_count(auditor,
+				AUDITOR_VIEW_COMPLETED_TASKS),
+			auditor_get_count(auditor,
+				AUDITOR_VIEW_REMAINING_TASKS));
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_TASKS]),
+			buf);
+	snprintf(buf, sizeof(buf), "%d", (auditor->filters[
+				AUDITOR_VIEW_COMPLETED_TASKS] != NULL)
+			? gtk_tree_model_iter_n_children(
+				_auditor_view_get_model(auditor), NULL) : 0);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_VIEW]),
+			buf);
+	if(auditor->reload_start != 0)
+		snprintf(buf, sizeof(buf), "%s", _("In progress"));
+	else
+		snprintf(buf, sizeof(buf), _("%u task(s) in %s"),
+				auditor->reload_count, reload);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_RELOAD]),
+			buf);
+	_auditor_performance_duration(average, sizeof(average),
+			(stats.loads > 0) ? stats.load_time / stats.loads : 0);
+	snprintf(buf, sizeof(buf), _("%lu (%s on average)"), stats.loads,
+			average);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_LOADS]),
+			buf);
+	_auditor_performance_duration(average, sizeof(average),
+			(stats.saves > 0) ? stats.save_time / stats.saves : 0);
+	snprintf(buf, sizeof(buf), _("%lu (%s on average)"), stats.saves,
+			average);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_SAVES]),
+			buf);
+	snprintf(buf, sizeof(buf), _("%zu (last in %s)"), pending, save);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_WRITES]),
+			buf);
+	snprintf(buf, sizeof(buf), _("%zu kB (tasks %zu kB, list %zu kB,"
+				" search %zu kB)"), memory / 1024,
+			(memory - store.rows - store.indexes - store.titles
+			 - store.search) / 1024,
+			(store.rows + store.indexes + store.titles) / 1024,
+			store.search / 1024);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_MEMORY]),
+			buf);
+	snprintf(buf, sizeof(buf), _("%zu bytes (title %zu, description %zu,"
+				" other %zu, list %zu)"), memory / tasks,
+			stats.memory[TASK_MEMORY_TITLE] / tasks,
+			(stats.memory[TASK_MEMORY_DESCRIPTION]
+			 + stats.memory[TASK_MEMORY_DESCRIPTION_TEXT]) / tasks,
+			(stats.memory[TASK_MEMORY_OBJECT]
+			 + stats.memory[TASK_MEMORY_FILENAME]
+			 + stats.memory[TASK_MEMORY_OTHER]) / tasks,
+			(store.rows + store.indexes + store.titles) / tasks);
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_FIELDS]),
+			buf);
+	snprintf(buf, sizeof(buf), _("%lu kB"), _auditor_performance_memory());
+	gtk_label_set_text(GTK_LABEL(auditor->performance_values[AP_PEAK]),
+			buf);
+}
+
+
+/* auditor_populate_cancel */
+static void _auditor_populate_cancel(Auditor * auditor)
+{
+	guint i;
+
+	if(auditor->pending_source != 0)
+		g_source_remove(auditor->pending_source);
+	auditor->pending_source = 0;
+	for(i = auditor->pending_pos; i < auditor->pending->len; i++)
+		task_delete(g_ptr_array_index(auditor->pending, i));
+	g_ptr_array_set_size(auditor->pending, 0);
+	auditor->pending_pos = 0;
+	auditor->pending_count = 0;
+}
+
+
+/* auditor_populate_queue */
+static void _auditor_populate_queue(Auditor * auditor, Task * task)
+{
+	g_ptr_array_add(auditor->pending, task);
+}
+
+
+/* auditor_populate_start */
+static void _auditor_populate_start(Auditor * auditor)
+{
+	if(auditor->pending_source == 0)
+		auditor->pending_source = g_idle_add(_auditor_on_populate,
+				auditor);
+}
+
+
+/* auditor_status */
+static void _auditor_status(Auditor * auditor, char const * format, ...)
+{
+	va_list ap;
+	char buf[80];
+
+	if(auditor->statusbar == NULL)
+		return;
+	va_start(ap, format);
+	vsnprintf(buf, sizeof(buf), format, ap);
+	va_end(ap);
+	gtk_statusbar_pop(GTK_STATUSBAR(auditor->statusbar),
+			auditor->statusbar_id);
+	gtk_statusbar_push(GTK_STATUSBAR(auditor->statusbar),
+			auditor->statusbar_id, buf);
+}
+
+
+/* auditor_snapshot_cancel */
+static void _auditor_snapshot_cancel(Auditor * auditor)
+{
+	if(auditor->snapshot_source != 0)
+		g_source_remove(auditor->snapshot_source);
+	auditor->snapshot_source = 0;
+	if(auditor->snapshot != NULL)
+		snapshot_delete(auditor->snapshot);
+	auditor->snapshot = NULL;
+}
+
+
+/* auditor_snapshot_get_complete */
+static gboolean _auditor_snapshot_get_complete(Auditor * auditor)
+{
+	/* every task loaded and inserted, and the snapshot verified */
+	return (auditor->pending_pos >= auditor->pending->len
+			&& auditor->loader_source == 0
+			&& (auditor->loader == NULL
+				|| loader_get_pending(auditor->loader) == 0)
+			&& auditor->reload_start == 0
+			&& auditor->snapshot == NULL) ? TRUE : FALSE;
+}
+
+
+/* auditor_snapshot_get_filename */
+static char * _auditor_snapshot_get_filename(void)
+{
+	gchar * directory;
+	size_t len;
+	char const snapshot[] = "snapshot";
+	char * filename;
+
+	directory = g_build_filename(g_get_user_cache_dir(), PROGNAME_AUDITOR,
+			NULL);
+	if(g_mkdir_with_parents(directory, 0700) != 0)
+	{
+		error_set("%s: %s", directory, strerror(errno));
+		g_free(directory);
+		return NULL;
+	}
+	len = strlen(directory) + 1 + sizeof(snapshot);
+	if((filename = malloc(len)) != NULL)
+		snprintf(filename, len, "%s/%s", directory, snapshot);
+	g_free(directory);
+	return filename;
+}
+
+
+/* auditor_snapshot_save */
+static int _auditor_snapshot_save(Auditor * auditor)
+{
+	int ret;
+	GtkTreeModel * model = GTK_TREE_MODEL(auditor->store);
+	GtkTreeIter iter;
+	gboolean valid;
+	Task * task;
+	char * filename;
+	struct stat st;
+	GPtrArray * tasks;
+
+	if((filename = _auditor_task_get_directory()) == NULL)
+		return -1;
+	if(stat(filename, &st) != 0)
+	{
+		free(filename);
+		return 0;
+	}
+	free(filename);
+	if((filename = _auditor_snapshot_get_filename()) == NULL)
+		return -1;
+	tasks = g_ptr_array_new();
+	valid = gtk_tree_model_get_iter_first(model, &iter);
+	for(; valid == TRUE; valid = gtk_tree_model_iter_next(model, &iter))
+	{
+		task = taskstore_get_task(auditor->store, &iter);
+		g_ptr_array_add(tasks, task);
+	}
+	ret = snapshot_write(filename, &st, (Task **)tasks->pdata, tasks->len);
+	g_ptr_array_free(tasks, TRUE);
+	free(filename);
+	return ret;
+}
+
+
+/* callbacks */
+/* auditor_on_view_all_tasks */
+static void _auditor_on_view_all_tasks(gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor_set_view(auditor, AUDITOR_VIEW_ALL_TASKS);
+}
+
+
+/* auditor_on_view_completed_tasks */
+static void _auditor_on_view_completed_tasks(gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor_set_view(auditor, AUDITOR_VIEW_COMPLETED_TASKS);
+}
+
+
+/* auditor_on_view_custom */
+static void _auditor_on_view_custom(gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor_view_edit(auditor);
+}
+
+
+/* auditor_on_view_remaining_tasks */
+static void _auditor_on_view_remaining_tasks(gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor_set_view(auditor, AUDITOR_VIEW_REMAINING_TASKS);
+}
+
+
+/* auditor_on_view_saved */
+static void _auditor_on_view_saved(GtkWidget * widget, gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor_set_filter(auditor, g_object_get_data(G_OBJECT(widget),
+				"filter"));
 }
 
 
@@ -1186,6 +3106,10 @@ static void _auditor_on_view_as(gpointer data)
 
 	view = auditor_get_view(auditor);
 	view = (view + 1) % AUDITOR_VIEW_COUNT;
+	/* only with a filter set */
+	if(view == AUDITOR_VIEW_FILTERED_TASKS
+			&& auditor_get_filter(auditor) == NULL)
+		view = (view + 1) % AUDITOR_VIEW_COUNT;
 	auditor_set_view(auditor, view);
 }
 
@@ -1199,7 +3123,77 @@ static void _auditor_on_select_all(gpointer data)
 }
 
 
+/* auditor_on_search_activate */
+static void _auditor_on_search_activate(gpointer data)
+{
+	Auditor * auditor = data;
+
+	if(auditor->search_source != 0)
+		g_source_remove(auditor->search_source);
+	auditor->search_source = 0;
+	auditor_set_search(auditor, gtk_entry_get_text(GTK_ENTRY(
+					auditor->search)));
+}
+
+
+/* auditor_on_search_changed */
+static void _auditor_on_search_changed(gpointer data)
+{
+	Auditor * auditor = data;
+
+	/* wait for the user to stop typing */
+	if(auditor->search_source != 0)
+		g_source_remove(auditor->search_source);
+	auditor->search_source = g_timeout_add(AUDITOR_SEARCH_DELAY,
+			_auditor_on_search_timeout, auditor);
+}
+
+
+/* auditor_on_search_timeout */
+static gboolean _auditor_on_search_timeout(gpointer data)
+{
+	Auditor * auditor = data;
+
+	auditor->search_source = 0;
+	auditor_set_search(auditor, gtk_entry_get_text(GTK_ENTRY(
+					auditor->search)));
+	return FALSE;
+}
+
+
 /* view */
+/* auditor_on_column_clicked */
+static void _auditor_on_column_clicked(GtkTreeViewColumn * column,
+		gpointer data)
+{
+	Auditor * auditor = data;
+	GtkTreeSortable * sortable = GTK_TREE_SORTABLE(auditor->store);
+	gint id;
+	gint current;
+	GtkSortType order;
+	size_t i;
+
+	id = _auditor_column_get_sort(column);
+	if(gtk_tree_sortable_get_sort_column_id(sortable, &current, &order)
+			!= TRUE || current != id)
+		order = GTK_SORT_ASCENDING;
+	else
+		order = (order == GTK_SORT_ASCENDING) ? GTK_SORT_DESCENDING
+			: GTK_SORT_ASCENDING;
+	gtk_tree_sortable_set_sort_column_id(sortable, id, order);
+	for(i = 0; i < TD_COL_COUNT; i++)
+		if(auditor->columns[i] != NULL)
+		{
+			gtk_tree_view_column_set_sort_indicator(
+					auditor->columns[i],
+					_auditor_column_get_sort(
+						auditor->columns[i]) == id);
+			gtk_tree_view_column_set_sort_order(
+					auditor->columns[i], order);
+		}
+}
+
+
 /* auditor_on_task_activated */
 static void _auditor_on_task_activated(gpointer data)
 {
@@ -1241,7 +3235,7 @@ static void _auditor_on_task_priority_edited(GtkCellRendererText * renderer,
 	(void) renderer;
 
 	treepath = gtk_tree_path_new_from_string(path);
-	auditor_task_set_priority(auditor, treepath, priority);
+	auditor_task_set_priority(auditor, treepath, priority_get(priority));
 	gtk_tree_path_free(treepath);
 }
 
@@ -1260,23 +3254,505 @@ static void _auditor_on_task_title_edited(GtkCellRendererText * renderer,
 }
 
 
-/* auditor_on_filter_view */
-static gboolean _auditor_on_filter_view(GtkTreeModel * model,
+/* auditor_on_date_data */
+static void _auditor_on_date_data(GtkTreeViewColumn * column,
+		GtkCellRenderer * renderer, GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data)
+{
+	Auditor * auditor = data;
+	guint64 date;
+
+	gtk_tree_model_get(model, iter, _auditor_column_get_sort(column), &date,
+			-1);
+	g_object_set(renderer, "text", (auditor->dates != NULL)
+			? datecache_format(auditor->dates, date) : "", NULL);
+}
+
+
+/* auditor_on_filter_all */
+static gboolean _auditor_on_filter_all(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data)
+{
+	(void) data;
+
+	return taskstore_get_match(TASKSTORE(model), iter);
+}
+
+
+/* auditor_on_filter_completed */
+static gboolean _auditor_on_filter_completed(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data)
+{
+	(void) data;
+
+	/* a single bit to test, and one more when searching */
+	return taskstore_get_done(TASKSTORE(model), iter)
+		&& taskstore_get_match(TASKSTORE(model), iter);
+}
+
+
+/* auditor_on_filter_filtered */
+static gboolean _auditor_on_filter_filtered(GtkTreeModel * model,
+		GtkTreeIter * iter, gpointer data)
+{
+	(void) data;
+
+	/* evaluated beforehand by the store */
+	return taskstore_get_filtered(TASKSTORE(model), iter)
+		&& taskstore_get_match(TASKSTORE(model), iter);
+}
+
+
+/* auditor_on_filter_remaining */
+static gboolean _auditor_on_filter_remaining(GtkTreeModel * model,
 		GtkTreeIter * iter, gpointer data)
+{
+	(void) data;
+
+	return !taskstore_get_done(TASKSTORE(model), iter)
+		&& taskstore_get_match(TASKSTORE(model), iter);
+}
+
+
+/* auditor_on_directory_changed */
+static void _directory_changed_update(Auditor * auditor,
+		char const * filename);
+static gboolean _directory_changed_written(Auditor * auditor,
+		char const * filename);
+
+static void _auditor_on_directory_changed(GFileMonitor * monitor,
+		GFile * file, GFile * other, GFileMonitorEvent event,
+		gpointer data)
 {
 	Auditor * auditor = data;
-	gboolean done = FALSE;
+	char * basename;
+	char * filename;
+	GtkTreeIter iter;
+	(void) monitor;
+	(void) other;
 
-	switch(auditor->filter_view)
+	if((basename = g_file_get_basename(file)) == NULL)
+		return;
+	if(strncmp(basename, "task.", 5) != 0
+			|| (filename = _auditor_task_get_filename(basename))
+			== NULL)
 	{
-		case AUDITOR_VIEW_COMPLETED_TASKS:
-			gtk_tree_model_get(model, iter, TD_COL_DONE, &done, -1);
-			return done ? TRUE : FALSE;
-		case AUDITOR_VIEW_REMAINING_TASKS:
-			gtk_tree_model_get(model, iter, TD_COL_DONE, &done, -1);
-			return done ? FALSE : TRUE;
+		g_free(basename);
+		return;
+	}
+	g_free(basename);
+	switch(event)
+	{
+		case G_FILE_MONITOR_EVENT_CHANGES_DONE_HINT:
+			/* also emitted once new files are complete */
+			if(_directory_changed_written(auditor, filename)
+					!= TRUE)
+				_directory_changed_update(auditor, filename);
+			break;
+		case G_FILE_MONITOR_EVENT_DELETED:
+			g_hash_table_remove(auditor->writes, filename);
+			if(_auditor_task_get_iter(auditor, filename, &iter)
+					== TRUE)
+				_auditor_task_remove(auditor, &iter);
+			break;
 		default:
-		case AUDITOR_VIEW_ALL_TASKS:
+			break;
+	}
+	free(filename);
+}
+
+static void _directory_changed_update(Auditor * auditor,
+		char const * filename)
+{
+	GtkTreeIter iter;
+	Task * task;
+
+	if(_auditor_task_get_iter(auditor, filename, &iter) == TRUE)
+	{
+		task = taskstore_get_task(auditor->store, &iter);
+		/* keep the changes not written yet */
+		if(task_get_dirty(task) != 0)
+			return;
+		if(task_load_header(task) == 0)
+			_auditor_task_set(auditor, &iter, task);
+		else
+			auditor_error(NULL, error_get(NULL), 1);
+	}
+	else if((task = task_new()) == NULL
+			|| task_set_filename(task, filename) != 0
+			|| task_load_header(task) != 0)
+	{
+		auditor_error(NULL, error_get(NULL), 1);
+		if(task != NULL)
+			task_delete(task);
+	}
+	else if(auditor_task_add(auditor, task) == NULL)
+		task_delete(task);
+}
+
+static gboolean _directory_changed_written(Auditor * auditor,
+		char const * filename)
+{
+	AuditorWrite * write;
+	struct stat st;
+
+	if((write = g_hash_table_lookup(auditor->writes, filename)) == NULL)
+		return FALSE;
+	/* the file is written by this program, possibly more than once */
+	if(write->size < 0 || (stat(filename, &st) == 0
+				&& st.st_size == write->size
+				&& st.st_mtim.tv_sec == write->mtime.tv_sec
+				&& st.st_mtim.tv_nsec == write->mtime.tv_nsec))
+		return TRUE;
+	/* modified by another program since */
+	g_hash_table_remove(auditor->writes, filename);
+	return FALSE;
+}
+
+
+/* auditor_on_write */
+static void _auditor_on_write(char const * filename, char const * error,
+		void * data)
+{
+	Auditor * auditor = data;
+	GtkTreeIter iter;
+	Task * task;
+
+	if(error == NULL)
+	{
+		_auditor_task_written(auditor, filename, FALSE);
+		return;
+	}
+	g_hash_table_remove(auditor->writes, filename);
+	/* the task still has to be saved */
+	if(_auditor_task_get_iter(auditor, filename, &iter) == TRUE)
+	{
+		task = taskstore_get_task(auditor->store, &iter);
+		task_set_dirty(task, 1);
+	}
+	error_set("%s: %s", filename, error);
+	auditor_error(auditor, error_get(NULL), 1);
+}
+
+
+/* auditor_on_delete_progress */
+static gboolean _auditor_on_delete_progress(gpointer data)
+{
+	Auditor * auditor = data;
+	size_t pending;
+
+	/* the other writes pending are counted as well */
+	pending = writer_get_pending(auditor->writer);
+	if(pending > 0)
+	{
+		_auditor_status(auditor, _("Deleting tasks (%u/%u)..."),
+				(pending < auditor->delete_count)
+				? auditor->delete_count - (guint)pending : 0,
+				auditor->delete_count);
+		return TRUE;
+	}
+	_auditor_status(auditor, _("%u task(s) deleted"),
+			auditor->delete_count);
+	auditor->delete_source = 0;
+	return FALSE;
+}
+
+
+/* auditor_on_import */
+static int _on_import_task(Auditor * auditor);
+
+static gboolean _auditor_on_import(gpointer data)
+{
+	Auditor * auditor = data;
+	int ret = 0;
+	int res = 1;
+	gint64 deadline;
+	guint i;
+	gint64 start = trace_begin();
+
+	/* import as many records as possible within the time budget */
+	deadline = g_get_monotonic_time() + AUDITOR_IMPORT_BUDGET;
+	for(i = 1; auditor->import_exchange != NULL
+			&& (res = _on_import_task(auditor)) > 0; i++)
+		if((i % AUDITOR_IMPORT_CHECK) == 0
+				&& g_get_monotonic_time() >= deadline)
+			break;
+	trace_end(start, "auditor", "import", auditor->import_filename);
+	_auditor_populate_start(auditor);
+	if(res > 0 && auditor->import_exchange != NULL)
+	{
+		_auditor_status(auditor, _("Importing tasks (%u)..."),
+				auditor->import_count);
+		return TRUE;
+	}
+	if(res < 0)
+		ret = -1;
+	else if(auditor->import_exchange != NULL)
+	{
+		/* the file has been read, synchronize the tasks written */
+		exchange_delete(auditor->import_exchange);
+		auditor->import_exchange = NULL;
+	}
+	if(ret == 0 && (res = _auditor_import_sync(auditor, deadline)) > 0)
+	{
+		_auditor_status(auditor, _("Synchronizing tasks (%u/%u)..."),
+				auditor->import_synced,
+				auditor->import_files->len);
+		return TRUE;
+	}
+	if(_auditor_import_close(auditor) != 0 || res < 0)
+		ret = -1;
+	auditor->import_source = 0;
+	if(ret != 0)
+		auditor_error(auditor, error_get(NULL), 1);
+	else if(auditor->import_errors > 0)
+	{
+		error_set("%s:%lu: %s\n%lu record(s) could not be imported",
+				auditor->import_filename, auditor->import_line,
+				auditor->import_message,
+				auditor->import_errors);
+		auditor_error(auditor, error_get(NULL), 1);
+	}
+	g_free(auditor->import_message);
+	auditor->import_message = NULL;
+	g_free(auditor->import_filename);
+	auditor->import_filename = NULL;
+	return FALSE;
+}
+
+static int _on_import_task(Auditor * auditor)
+{
+	Task * task;
+	int res;
+	char * p;
+
+	if(ferror(auditor->import_fp))
+		return 0;
+	if((task = task_new()) == NULL)
+		return -1;
+	if((res = exchange_read(auditor->import_exchange, task)) <= 0)
+	{
+		task_delete(task);
+		if(res == 0)
+			return 0;
+		/* only the first error is reported */
+		if(auditor->import_errors++ == 0)
+		{
+			auditor->import_line = exchange_get_line(
+					auditor->import_exchange);
+			auditor->import_message = g_strdup(error_get(NULL));
+		}
+		return 1;
+	}
+	if((p = (auditor->journal != NULL)
+				? journal_new_id(auditor->journal)
+				: _auditor_task_get_new_filename()) == NULL
+			|| task_set_filename(task, p) != 0
+			|| task_set_journal(task, auditor->journal) != 0
+			|| task_save(task) != 0)
+	{
+		free(p);
+		task_delete(task);
+		return -1;
+	}
+	_auditor_task_written(auditor, p, FALSE);
+	if(auditor->import_files != NULL)
+		g_ptr_array_add(auditor->import_files, p);
+	else
+		free(p);
+	/* only the header is kept until displayed */
+	task_unload_description(task);
+	auditor->import_count++;
+	_auditor_populate_queue(auditor, task);
+	return 1;
+}
+
+
+/* auditor_on_index */
+static gboolean _auditor_on_index(gpointer data)
+{
+	Auditor * auditor = data;
+	gint64 deadline;
+	int more;
+
+	/* index as many tasks as possible within the time budget */
+	deadline = g_get_monotonic_time() + AUDITOR_INDEX_BUDGET;
+	do
+		if((more = taskstore_index(auditor->store,
+						AUDITOR_INDEX_CHUNK)) < 0)
+			auditor_error(NULL, error_get(NULL), 1);
+	while(more != 0 && g_get_monotonic_time() < deadline);
+	/* the search is only complete once every task is indexed */
+	if(more != 0)
+	{
+		if(taskstore_get_search(auditor->store) != NULL)
+			_auditor_status(auditor, _("Indexing tasks"
+						" (%u/%u)..."),
+					taskstore_get_count_indexed(
+						auditor->store),
+					taskstore_get_count(auditor->store));
+		return TRUE;
+	}
+	auditor->index_source = 0;
+	if(taskstore_get_search(auditor->store) != NULL)
+		auditor_set_view(auditor, auditor->filter_view);
+	return FALSE;
+}
+
+
+/* auditor_on_loader_collect */
+static void _on_loader_collect_task(Task * task, char const * filename,
+		void * data);
+
+static gboolean _auditor_on_loader_collect(gpointer data)
+{
+	Auditor * auditor = data;
+	gint64 start = trace_begin();
+
+	loader_collect(auditor->loader, AUDITOR_LOADER_BATCH, 0,
+			_on_loader_collect_task, auditor);
+	trace_end(start, "auditor", "loader_collect", NULL);
+	_auditor_populate_start(auditor);
+	if(loader_get_pending(auditor->loader) > 0)
+		return TRUE;
+	auditor->loader_source = 0;
+	return FALSE;
+}
+
+static void _on_loader_collect_task(Task * task, char const * filename,
+		void * data)
+{
+	Auditor * auditor = data;
+	(void) filename;
+
+	if(task == NULL)
+		auditor_error(NULL, error_get(NULL), 1);
+	else
+		_auditor_populate_queue(auditor, task);
+}
+
+
+/* auditor_on_performance */
+static gboolean _auditor_on_performance(gpointer data)
+{
+	Auditor * auditor = data;
+
+	_auditor_performance_update(auditor);
+	return TRUE;
+}
+
+
+/* auditor_on_populate */
+static gboolean _auditor_on_populate(gpointer data)
+{
+	Auditor * auditor = data;
+	gint64 deadline;
+	guint i;
+	Task * task;
+	gint64 start = trace_begin();
+
+	/* insert as many rows as possible within the time budget */
+	deadline = g_get_monotonic_time() + AUDITOR_POPULATE_BUDGET;
+	for(i = 0; auditor->pending_pos < auditor->pending->len; i++)
+	{
+		if(i > 0 && (i % AUDITOR_POPULATE_CHECK) == 0
+				&& g_get_monotonic_time() >= deadline)
+			break;
+		task = g_ptr_array_index(auditor->pending,
+				auditor->pending_pos++);
+		/* the task may have been added meanwhile if it was modified */
+		if(g_hash_table_lookup(auditor->rows, task_get_filename(task))
+				!= NULL || auditor_task_add(auditor, task)
+				== NULL)
+			task_delete(task);
+		else
+			auditor->pending_count++;
+	}
+	trace_end(start, "auditor", "populate", NULL);
+	if(auditor->pending_pos < auditor->pending->len
+			|| (auditor->loader != NULL
+				&& loader_get_pending(auditor->loader) > 0)
+			|| auditor->import_exchange != NULL)
+	{
+		_auditor_status(auditor, _("Loading tasks (%u/%u)..."),
+				auditor->pending_count, auditor->pending_count
+				+ auditor->pending->len - auditor->pending_pos
+				+ ((auditor->loader != NULL)
+					? loader_get_pending(auditor->loader)
+					: 0));
+		if(auditor->pending_pos < auditor->pending->len)
 			return TRUE;
+		/* wait for the worker threads */
+		g_ptr_array_set_size(auditor->pending, 0);
+		auditor->pending_pos = 0;
+		auditor->pending_source = 0;
+		return FALSE;
+	}
+	g_ptr_array_set_size(auditor->pending, 0);
+	auditor->pending_pos = 0;
+	auditor->pending_source = 0;
+	_auditor_view_attach(auditor);
+	if(auditor->reload_start != 0)
+	{
+		/* until the last row is inserted */
+		trace_end(auditor->reload_start, "auditor", "reload", NULL);
+		auditor->reload_time = g_get_monotonic_time()
+			- auditor->reload_start;
+		auditor->reload_count = auditor->pending_count;
+		auditor->reload_start = 0;
+		_auditor_performance_update(auditor);
+	}
+	_auditor_status(auditor, _("%u task(s) loaded"),
+			auditor->pending_count);
+	_auditor_index_start(auditor);
+	if(auditor->snapshot != NULL && auditor->snapshot_source == 0)
+		auditor->snapshot_source = g_idle_add(
+				_auditor_on_snapshot_verify, auditor);
+	return FALSE;
+}
+
+
+/* auditor_on_snapshot_verify */
+static gboolean _auditor_on_snapshot_verify(gpointer data)
+{
+	Auditor * auditor = data;
+	size_t count;
+	size_t i;
+	char const * filename;
+	GtkTreeIter iter;
+	Task * task;
+	struct stat st;
+
+	/* the snapshot lists the tasks in a stable order, unlike the view */
+	count = snapshot_get_count(auditor->snapshot);
+	for(i = 0; auditor->snapshot_pos < count && i < AUDITOR_SNAPSHOT_CHUNK;
+			i++)
+	{
+		filename = snapshot_get_filename(auditor->snapshot,
+				auditor->snapshot_pos++);
+		if(_auditor_task_get_iter(auditor, filename, &iter) != TRUE)
+			continue;
+		task = taskstore_get_task(auditor->store, &iter);
+		if(stat(filename, &st) != 0)
+		{
+			/* the task was removed meanwhile */
+			if(errno == ENOENT)
+				_auditor_task_remove(auditor, &iter);
+			continue;
+		}
+		/* keep the changes not written yet */
+		if(task_get_dirty(task) != 0 || snapshot_lookup(
+					auditor->snapshot, filename, &st) >= 0)
+			continue;
+		if(task_load_header(task) == 0)
+			_auditor_task_set(auditor, &iter, task);
+		else
+			auditor_error(NULL, error_get(NULL), 1);
 	}
+	if(auditor->snapshot_pos < count)
+		return TRUE;
+	auditor->snapshot_source = 0;
+	snapshot_delete(auditor->snapshot);
+	auditor->snapshot = NULL;
+	return FALSE;
 }
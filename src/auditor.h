@@ -31,6 +31,7 @@
 #ifndef AUDITOR_AUDITOR_H
 # define AUDITOR_AUDITOR_H
 
+# include "priority.h"
 # include "task.h"
 # include <gtk/gtk.h>
 
@@ -39,22 +40,31 @@
 /* types */
 typedef struct _Auditor Auditor;
 
-typedef enum _AuditorPriority
+typedef enum _AuditorBulkField
 {
-	AUDITOR_PRIORITY_UNKNOWN,
-	AUDITOR_PRIORITY_LOW,
-	AUDITOR_PRIORITY_MEDIUM,
-	AUDITOR_PRIORITY_HIGH,
-	AUDITOR_PRIORITY_URGENT
-} AuditorPriority;
+	AUDITOR_BULK_DONE	= 0x1,
+	AUDITOR_BULK_PRIORITY	= 0x2,
+	AUDITOR_BULK_CATEGORY	= 0x4,
+	AUDITOR_BULK_SHIFT	= 0x8
+} AuditorBulkField;
+
+typedef struct _AuditorBulk
+{
+	unsigned int fields;	/* the AuditorBulkField to change */
+	int done;
+	AuditorPriority priority;
+	char const * category;
+	time_t shift;		/* seconds added to the start and end dates */
+} AuditorBulk;
 
 typedef enum _AuditorView
 {
 	AUDITOR_VIEW_ALL_TASKS = 0,
 	AUDITOR_VIEW_COMPLETED_TASKS,
-	AUDITOR_VIEW_REMAINING_TASKS
+	AUDITOR_VIEW_REMAINING_TASKS,
+	AUDITOR_VIEW_FILTERED_TASKS
 } AuditorView;
-# define AUDITOR_VIEW_LAST AUDITOR_VIEW_REMAINING_TASKS
+# define AUDITOR_VIEW_LAST AUDITOR_VIEW_FILTERED_TASKS
 # define AUDITOR_VIEW_COUNT (AUDITOR_VIEW_LAST + 1)
 
 
@@ -63,32 +73,53 @@ Auditor * auditor_new(GtkWidget * window, GtkAccelGroup * group);
 void auditor_delete(Auditor * auditor);
 
 /* accessors */
+unsigned int auditor_get_count(Auditor * auditor, AuditorView view);
+char const * auditor_get_filter(Auditor * auditor);
+gboolean auditor_get_show_performance(Auditor * auditor);
 AuditorView auditor_get_view(Auditor * auditor);
 GtkWidget * auditor_get_widget(Auditor * auditor);
+int auditor_set_filter(Auditor * auditor, char const * filter);
+void auditor_set_search(Auditor * auditor, char const * query);
+void auditor_set_statusbar(Auditor * auditor, GtkWidget * statusbar);
+void auditor_set_threads(Auditor * auditor, unsigned int threads);
 void auditor_set_view(Auditor * auditor, AuditorView view);
+void auditor_set_write_delay(Auditor * auditor, unsigned int delay);
 
 /* useful */
 void auditor_about(Auditor * auditor);
 int auditor_error(Auditor * auditor, char const * message, int ret);
+void auditor_export(Auditor * auditor);
+void auditor_import(Auditor * auditor);
 
+void auditor_show_performance(Auditor * auditor, gboolean show);
 void auditor_show_preferences(Auditor * auditor, gboolean show);
 
 /* tasks */
 Task * auditor_task_add(Auditor * auditor, Task * task);
 void auditor_task_delete_selected(Auditor * auditor);
+Task * auditor_task_get(Auditor * auditor, char const * filename);
 void auditor_task_remove_all(Auditor * auditor);
 
 /* accessors */
 void auditor_task_set_priority(Auditor * auditor, GtkTreePath * path,
-		char const * priority);
+		AuditorPriority priority);
 void auditor_task_set_title(Auditor * auditor, GtkTreePath * path,
 		char const * title);
 
 void auditor_task_cursor_changed(Auditor * auditor);
 void auditor_task_edit(Auditor * auditor);
 int auditor_task_reload_all(Auditor * auditor);
-void auditor_task_save_all(Auditor * auditor);
+int auditor_task_save_all(Auditor * auditor);
 void auditor_task_select_all(Auditor * auditor);
 void auditor_task_toggle_done(Auditor * auditor, GtkTreePath * path);
+int auditor_task_update(Auditor * auditor, Task * task);
+void auditor_task_update_selected(Auditor * auditor,
+		AuditorBulk const * bulk);
+
+/* views */
+void auditor_view_edit(Auditor * auditor);
+int auditor_view_remove(Auditor * auditor, char const * name);
+int auditor_view_save(Auditor * auditor, char const * name,
+		char const * filter);
 
 #endif /* !AUDITOR_AUDITOR_H */
@@ -0,0 +1,257 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <libintl.h>
+#include <gtk/gtk.h>
+#include "priority.h"
+#include "bulkedit.h"
+#define _(string) gettext(string)
+
+
+/* BulkEdit */
+/* private */
+/* types */
+struct _BulkEdit
+{
+	Auditor * auditor;
+
+	/* widgets */
+	GtkWidget * window;
+	GtkWidget * done_check;
+	GtkWidget * done;
+	GtkWidget * priority_check;
+	GtkWidget * priority;
+	GtkWidget * category_check;
+	GtkWidget * category;
+	GtkWidget * shift_check;
+	GtkWidget * shift;
+};
+
+
+/* constants */
+/* the dates can be shifted by up to ten years either way */
+#define BULKEDIT_SHIFT_DAYS	3650
+
+
+/* public */
+/* functions */
+/* bulkedit_new */
+static GtkWidget * _bulkedit_new_check(BulkEdit * bulkedit,
+		GtkSizeGroup * group, GtkWidget * vbox, char const * label,
+		GtkWidget * widget);
+static void _on_bulkedit_cancel(gpointer data);
+static void _on_bulkedit_ok(gpointer data);
+static void _on_bulkedit_toggled(gpointer data);
+
+BulkEdit * bulkedit_new(Auditor * auditor, unsigned int count)
+{
+	BulkEdit * bulkedit;
+	char buf[80];
+	size_t i;
+	GtkSizeGroup * group;
+	GtkWidget * vbox;
+	GtkWidget * widget;
+	GtkWidget * bbox;
+
+	if((bulkedit = malloc(sizeof(*bulkedit))) == NULL)
+		return NULL;
+	bulkedit->auditor = auditor;
+	bulkedit->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+	snprintf(buf, sizeof(buf), _("Edit %u tasks"), count);
+	gtk_window_set_default_size(GTK_WINDOW(bulkedit->window), 300, -1);
+	gtk_window_set_title(GTK_WINDOW(bulkedit->window), buf);
+	g_signal_connect_swapped(bulkedit->window, "delete-event", G_CALLBACK(
+				_on_bulkedit_cancel), bulkedit);
+	group = gtk_size_group_new(GTK_SIZE_GROUP_HORIZONTAL);
+	vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+	/* only the fields checked are changed */
+	widget = gtk_label_new(_("Change the selected tasks as follows:"));
+#if GTK_CHECK_VERSION(3, 0, 0)
+	g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+	gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+	gtk_box_pack_start(GTK_BOX(vbox), widget, FALSE, TRUE, 0);
+	/* done */
+#if GTK_CHECK_VERSION(3, 0, 0)
+	bulkedit->done = gtk_combo_box_text_new();
+	gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(bulkedit->done),
+			_("Completed"));
+	gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(bulkedit->done),
+			_("Not completed"));
+#else
+	bulkedit->done = gtk_combo_box_new_text();
+	gtk_combo_box_append_text(GTK_COMBO_BOX(bulkedit->done),
+			_("Completed"));
+	gtk_combo_box_append_text(GTK_COMBO_BOX(bulkedit->done),
+			_("Not completed"));
+#endif
+	gtk_combo_box_set_active(GTK_COMBO_BOX(bulkedit->done), 0);
+	bulkedit->done_check = _bulkedit_new_check(bulkedit, group, vbox,
+			_("Done:"), bulkedit->done);
+	/* priority */
+#if GTK_CHECK_VERSION(3, 0, 0)
+	bulkedit->priority = gtk_combo_box_text_new();
+	for(i = 0; priorities[i].title != NULL; i++)
+		gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(
+					bulkedit->priority),
+				priority_get_title(priorities[i].priority));
+#else
+	bulkedit->priority = gtk_combo_box_new_text();
+	for(i = 0; priorities[i].title != NULL; i++)
+		gtk_combo_box_append_text(GTK_COMBO_BOX(bulkedit->priority),
+				priority_get_title(priorities[i].priority));
+#endif
+	gtk_combo_box_set_active(GTK_COMBO_BOX(bulkedit->priority), 0);
+	bulkedit->priority_check = _bulkedit_new_check(bulkedit, group, vbox,
+			_("Priority:"), bulkedit->priority);
+	/* category */
+	bulkedit->category = gtk_entry_new();
+	g_signal_connect_swapped(bulkedit->category, "activate", G_CALLBACK(
+				_on_bulkedit_ok), bulkedit);
+	bulkedit->category_check = _bulkedit_new_check(bulkedit, group, vbox,
+			_("Category:"), bulkedit->category);
+	/* shift the dates, in days */
+	bulkedit->shift = gtk_spin_button_new_with_range(-BULKEDIT_SHIFT_DAYS,
+			BULKEDIT_SHIFT_DAYS, 1.0);
+	gtk_spin_button_set_value(GTK_SPIN_BUTTON(bulkedit->shift), 0.0);
+	bulkedit->shift_check = _bulkedit_new_check(bulkedit, group, vbox,
+			_("Shift dates (days):"), bulkedit->shift);
+	_on_bulkedit_toggled(bulkedit);
+	bbox = gtk_button_box_new(GTK_ORIENTATION_HORIZONTAL);
+	gtk_button_box_set_layout(GTK_BUTTON_BOX(bbox), GTK_BUTTONBOX_END);
+	gtk_box_set_spacing(GTK_BOX(bbox), 4);
+	widget = gtk_button_new_from_stock(GTK_STOCK_CANCEL);
+	g_signal_connect_swapped(widget, "clicked", G_CALLBACK(
+				_on_bulkedit_cancel), bulkedit);
+	gtk_container_add(GTK_CONTAINER(bbox), widget);
+	widget = gtk_button_new_from_stock(GTK_STOCK_OK);
+	g_signal_connect_swapped(widget, "clicked", G_CALLBACK(_on_bulkedit_ok),
+			bulkedit);
+	gtk_container_add(GTK_CONTAINER(bbox), widget);
+	gtk_box_pack_end(GTK_BOX(vbox), bbox, FALSE, TRUE, 0);
+	gtk_container_set_border_width(GTK_CONTAINER(bulkedit->window), 4);
+	gtk_container_add(GTK_CONTAINER(bulkedit->window), vbox);
+	gtk_widget_show_all(bulkedit->window);
+	return bulkedit;
+}
+
+static GtkWidget * _bulkedit_new_check(BulkEdit * bulkedit,
+		GtkSizeGroup * group, GtkWidget * vbox, char const * label,
+		GtkWidget * widget)
+{
+	GtkWidget * hbox;
+	GtkWidget * check;
+
+	hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+	check = gtk_check_button_new_with_label(label);
+	g_signal_connect_swapped(check, "toggled", G_CALLBACK(
+				_on_bulkedit_toggled), bulkedit);
+	gtk_size_group_add_widget(group, check);
+	gtk_box_pack_start(GTK_BOX(hbox), check, FALSE, TRUE, 0);
+	gtk_box_pack_start(GTK_BOX(hbox), widget, TRUE, TRUE, 0);
+	gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, TRUE, 0);
+	return check;
+}
+
+static void _on_bulkedit_cancel(gpointer data)
+{
+	BulkEdit * bulkedit = data;
+
+	bulkedit_delete(bulkedit);
+}
+
+static void _on_bulkedit_ok(gpointer data)
+{
+	BulkEdit * bulkedit = data;
+	AuditorBulk bulk;
+	gint i;
+
+	bulk.fields = 0;
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->done_check)))
+	{
+		bulk.fields |= AUDITOR_BULK_DONE;
+		bulk.done = (gtk_combo_box_get_active(GTK_COMBO_BOX(
+						bulkedit->done)) == 0) ? 1 : 0;
+	}
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->priority_check))
+			&& (i = gtk_combo_box_get_active(GTK_COMBO_BOX(
+						bulkedit->priority))) >= 0)
+	{
+		bulk.fields |= AUDITOR_BULK_PRIORITY;
+		bulk.priority = priorities[i].priority;
+	}
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->category_check)))
+	{
+		bulk.fields |= AUDITOR_BULK_CATEGORY;
+		bulk.category = gtk_entry_get_text(GTK_ENTRY(
+					bulkedit->category));
+	}
+	if(gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->shift_check)))
+	{
+		bulk.fields |= AUDITOR_BULK_SHIFT;
+		bulk.shift = (time_t)gtk_spin_button_get_value_as_int(
+				GTK_SPIN_BUTTON(bulkedit->shift)) * 60 * 60 * 24;
+	}
+	if(bulk.fields != 0)
+		auditor_task_update_selected(bulkedit->auditor, &bulk);
+	_on_bulkedit_cancel(bulkedit);
+}
+
+static void _on_bulkedit_toggled(gpointer data)
+{
+	BulkEdit * bulkedit = data;
+
+	gtk_widget_set_sensitive(bulkedit->done, gtk_toggle_button_get_active(
+				GTK_TOGGLE_BUTTON(bulkedit->done_check)));
+	gtk_widget_set_sensitive(bulkedit->priority,
+			gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->priority_check)));
+	gtk_widget_set_sensitive(bulkedit->category,
+			gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->category_check)));
+	gtk_widget_set_sensitive(bulkedit->shift,
+			gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(
+					bulkedit->shift_check)));
+}
+
+
+/* bulkedit_delete */
+void bulkedit_delete(BulkEdit * bulkedit)
+{
+	gtk_widget_destroy(bulkedit->window);
+	free(bulkedit);
+}
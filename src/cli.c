@@ -0,0 +1,934 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "exchange.h"
+#include "filter.h"
+#include "journal.h"
+#include "priority.h"
+#include "task.h"
+#include "taskstore.h"
+#include "cli.h"
+
+/* constants */
+#ifndef PROGNAME_AUDITOR
+# define PROGNAME_AUDITOR	"auditor"
+#endif
+#define CLI_ARGUMENTS_MAX	64
+
+
+/* Cli */
+/* private */
+/* types */
+struct _Cli
+{
+	char * directory;
+	Journal * journal;
+
+	/* the tasks used so far, only saved by cli_flush() */
+	GHashTable * tasks;
+	/* the files written or removed, only synchronized by cli_flush() */
+	GPtrArray * files;
+	int removed;
+};
+
+typedef int (*CliCallback)(Cli * cli, int argc, char * argv[]);
+
+/* returns 1 when keeping the task loaded */
+typedef int (*CliForeachCallback)(Cli * cli, char const * id, Task * task,
+		void * priv);
+
+typedef struct _CliForeach
+{
+	Cli * cli;
+	int full;
+	CliForeachCallback callback;
+	void * priv;
+} CliForeach;
+
+typedef struct _CliExport
+{
+	Exchange * exchange;
+	Filter * filter;
+} CliExport;
+
+
+/* prototypes */
+static int _cli_add(Cli * cli, int argc, char * argv[]);
+static int _cli_batch(Cli * cli, int argc, char * argv[]);
+static int _cli_done(Cli * cli, int argc, char * argv[]);
+static int _cli_export(Cli * cli, int argc, char * argv[]);
+static int _cli_import(Cli * cli, int argc, char * argv[]);
+static int _cli_list(Cli * cli, int argc, char * argv[]);
+static int _cli_memory(Cli * cli, int argc, char * argv[]);
+static int _cli_rm(Cli * cli, int argc, char * argv[]);
+static int _cli_set(Cli * cli, int argc, char * argv[]);
+
+static int _cli_batch_split(char * line, char * argv[], size_t size);
+static int _cli_error_usage(char const * name);
+static int _cli_foreach(Cli * cli, int full, CliForeachCallback callback,
+		void * priv);
+static int _cli_match(Filter * filter, Task * task);
+static Task * _cli_task_get(Cli * cli, char const * id);
+static char * _cli_task_get_filename(Cli * cli, char const * id);
+static char * _cli_task_new_filename(Cli * cli);
+static int _cli_task_set(Task * task, char const * assignment);
+
+
+/* constants */
+static const struct
+{
+	char const * name;
+	CliCallback callback;
+	char const * usage;
+} _cli_commands[] =
+{
+	{ "add",	_cli_add,	"title [field=value...]"	},
+	{ "batch",	_cli_batch,	"[filename]"			},
+	{ "done",	_cli_done,	"id..."				},
+	{ "export",	_cli_export,	"[format=csv|jsonl|todo.txt] "
+		"[fields=field,...][filter=expression]"			},
+	{ "import",	_cli_import,	"[format=csv|jsonl|todo.txt] "
+		"[filename]"						},
+	{ "list",	_cli_list,	"[filter]"			},
+	{ "memory",	_cli_memory,	""				},
+	{ "rm",		_cli_rm,	"id..."				},
+	{ "set",	_cli_set,	"id field=value..."		}
+};
+
+
+/* public */
+/* functions */
+/* cli_new */
+Cli * cli_new(void)
+{
+	Cli * cli;
+	char const * homedir;
+	char * filename;
+
+	if((cli = object_new(sizeof(*cli))) == NULL)
+		return NULL;
+	if((homedir = getenv("HOME")) == NULL)
+		homedir = g_get_home_dir();
+	cli->directory = g_build_filename(homedir, ".auditor", NULL);
+	cli->journal = NULL;
+	cli->tasks = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+			(GDestroyNotify)task_delete);
+	cli->files = g_ptr_array_new_with_free_func(free);
+	cli->removed = 0;
+	filename = g_build_filename(cli->directory, "journal", NULL);
+	if(journal_is_enabled(filename)
+			&& (cli->journal = journal_new(filename)) == NULL)
+	{
+		g_free(filename);
+		cli_delete(cli);
+		return NULL;
+	}
+	g_free(filename);
+	return cli;
+}
+
+
+/* cli_delete */
+void cli_delete(Cli * cli)
+{
+	g_hash_table_destroy(cli->tasks);
+	g_ptr_array_free(cli->files, TRUE);
+	if(cli->journal != NULL)
+		journal_delete(cli->journal);
+	g_free(cli->directory);
+	object_delete(cli);
+}
+
+
+/* useful */
+/* cli_batch */
+int cli_batch(Cli * cli, FILE * fp, char const * filename)
+{
+	char * line = NULL;
+	size_t size = 0;
+	ssize_t len;
+	unsigned long n;
+	unsigned long errors = 0;
+	char * argv[CLI_ARGUMENTS_MAX];
+	int argc;
+
+	/* one operation per line, all saved at once by cli_flush() */
+	for(n = 1; (len = getline(&line, &size, fp)) >= 0; n++)
+	{
+		while(len > 0 && (line[len - 1] == '\n'
+					|| line[len - 1] == '\r'))
+			line[--len] = '\0';
+		if((argc = _cli_batch_split(line, argv, sizeof(argv)
+						/ sizeof(*argv))) == 0)
+			continue;
+		if(argc > 0 && strcmp(argv[0], "batch") == 0)
+			argc = -error_set_code(1, "%s", "Nested batches are not"
+					" supported");
+		if(argc < 0 || cli_command(cli, argc, argv) != 0)
+		{
+			fprintf(stderr, "%s: %s:%lu: %s\n", PROGNAME_AUDITOR,
+					filename, n, error_get(NULL));
+			errors++;
+		}
+	}
+	free(line);
+	if(ferror(fp))
+		return -error_set_code(1, "%s: %s", filename, strerror(errno));
+	if(errors > 0)
+		return -error_set_code(1, "%s: %lu operation(s) failed",
+				filename, errors);
+	return 0;
+}
+
+
+/* cli_command */
+int cli_command(Cli * cli, int argc, char * argv[])
+{
+	size_t i;
+
+	for(i = 0; i < sizeof(_cli_commands) / sizeof(*_cli_commands); i++)
+		if(strcmp(_cli_commands[i].name, argv[0]) == 0)
+			return _cli_commands[i].callback(cli, argc, argv);
+	return -error_set_code(1, "%s: %s", argv[0], "Unknown command");
+}
+
+
+/* cli_flush */
+int cli_flush(Cli * cli)
+{
+	int ret = 0;
+	GHashTableIter iter;
+	gpointer value;
+	char * p;
+	guint i;
+
+	/* only the tasks changed are written */
+	g_hash_table_iter_init(&iter, cli->tasks);
+	while(g_hash_table_iter_next(&iter, NULL, &value))
+		if(task_get_dirty(value) == 0)
+			continue;
+		else if(task_save(value) != 0)
+			ret = -1;
+		else if(cli->journal != NULL)
+			continue;
+		else if((p = strdup(task_get_filename(value))) == NULL)
+			ret = -error_set_code(1, "%s", strerror(errno));
+		else
+			g_ptr_array_add(cli->files, p);
+	/* and synchronized to the disk only once */
+	if(cli->journal != NULL)
+		return (journal_sync(cli->journal) == 0) ? ret : -1;
+	for(i = 0; i < cli->files->len; i++)
+		if(task_sync_file(g_ptr_array_index(cli->files, i)) != 0)
+			ret = -1;
+	/* the new entries in the directory as well */
+	if((cli->files->len > 0 || cli->removed)
+			&& task_sync_directory(cli->directory) != 0)
+		ret = -1;
+	g_ptr_array_set_size(cli->files, 0);
+	cli->removed = 0;
+	return ret;
+}
+
+
+/* cli_is_command */
+int cli_is_command(char const * name)
+{
+	size_t i;
+
+	for(i = 0; i < sizeof(_cli_commands) / sizeof(*_cli_commands); i++)
+		if(strcmp(_cli_commands[i].name, name) == 0)
+			return 1;
+	return 0;
+}
+
+
+/* private */
+/* functions */
+/* commands */
+/* cli_add */
+static int _cli_add(Cli * cli, int argc, char * argv[])
+{
+	Task * task;
+	char * filename;
+	char const * p;
+	int i;
+
+	if(argc < 2)
+		return _cli_error_usage(argv[0]);
+	if((task = task_new()) == NULL)
+		return -1;
+	/* only create the task once its fields are valid */
+	if(task_set_title(task, argv[1]) != 0)
+	{
+		task_delete(task);
+		return -1;
+	}
+	for(i = 2; i < argc; i++)
+		if(_cli_task_set(task, argv[i]) != 0)
+		{
+			task_delete(task);
+			return -1;
+		}
+	if((filename = _cli_task_new_filename(cli)) == NULL
+			|| task_set_filename(task, filename) != 0)
+	{
+		free(filename);
+		task_delete(task);
+		return -1;
+	}
+	task_set_journal(task, cli->journal);
+	p = ((p = strrchr(filename, '/')) != NULL) ? p + 1 : filename;
+	g_hash_table_insert(cli->tasks, g_strdup(p), task);
+	printf("%s\n", p);
+	free(filename);
+	return 0;
+}
+
+
+/* cli_batch */
+static int _cli_batch(Cli * cli, int argc, char * argv[])
+{
+	int ret;
+	FILE * fp;
+
+	if(argc > 2)
+		return _cli_error_usage(argv[0]);
+	if(argc == 1 || strcmp(argv[1], "-") == 0)
+		return cli_batch(cli, stdin, "<stdin>");
+	if((fp = fopen(argv[1], "r")) == NULL)
+		return -error_set_code(1, "%s: %s", argv[1], strerror(errno));
+	ret = cli_batch(cli, fp, argv[1]);
+	fclose(fp);
+	return ret;
+}
+
+
+/* cli_done */
+static int _cli_done(Cli * cli, int argc, char * argv[])
+{
+	int i;
+	Task * task;
+
+	if(argc < 2)
+		return _cli_error_usage(argv[0]);
+	for(i = 1; i < argc; i++)
+		if((task = _cli_task_get(cli, argv[i])) == NULL
+				|| task_set_done(task, 1) != 0)
+			return -1;
+	return 0;
+}
+
+
+/* cli_export */
+static int _export_foreach(Cli * cli, char const * id, Task * task,
+		void * priv);
+
+static int _cli_export(Cli * cli, int argc, char * argv[])
+{
+	int ret;
+	int i;
+	CliExport export;
+	ExchangeFormat format = EXCHANGE_FORMAT_CSV;
+	char const * fields = NULL;
+	char const * filter = NULL;
+
+	for(i = 1; i < argc; i++)
+		if(strncmp(argv[i], "format=", 7) == 0)
+		{
+			if(exchange_parse_format(&argv[i][7], &format) != 0)
+				return -1;
+		}
+		else if(strncmp(argv[i], "fields=", 7) == 0)
+			fields = &argv[i][7];
+		else if(strncmp(argv[i], "filter=", 7) == 0)
+			filter = &argv[i][7];
+		else
+			return _cli_error_usage(argv[0]);
+	if((export.exchange = exchange_new(stdout, format)) == NULL)
+		return -1;
+	export.filter = NULL;
+	if((fields != NULL && exchange_set_fields(export.exchange, fields)
+				!= 0)
+			|| (filter != NULL && (export.filter = filter_new(
+						filter)) == NULL))
+	{
+		exchange_delete(export.exchange);
+		return -1;
+	}
+	/* the descriptions are only read when exported */
+	ret = _cli_foreach(cli, exchange_get_field(export.exchange,
+				EXCHANGE_FIELD_DESCRIPTION), _export_foreach,
+			&export);
+	if(export.filter != NULL)
+		filter_delete(export.filter);
+	exchange_delete(export.exchange);
+	if(ret == 0 && fflush(stdout) != 0)
+		ret = -error_set_code(1, "%s", strerror(errno));
+	return ret;
+}
+
+static int _export_foreach(Cli * cli, char const * id, Task * task,
+		void * priv)
+{
+	CliExport * export = priv;
+
+	if(export->filter != NULL && !_cli_match(export->filter, task))
+		return 0;
+	return exchange_write(export->exchange, id, task);
+}
+
+
+/* cli_import */
+static int _cli_import(Cli * cli, int argc, char * argv[])
+{
+	int ret = 0;
+	int i;
+	char const * filename = NULL;
+	char const * f = NULL;
+	ExchangeFormat format = EXCHANGE_FORMAT_CSV;
+	FILE * fp = stdin;
+	Exchange * exchange;
+	Task * task;
+	char * p;
+	int res;
+	unsigned long errors = 0;
+
+	for(i = 1; i < argc; i++)
+		if(strncmp(argv[i], "format=", 7) == 0)
+			f = &argv[i][7];
+		else if(filename == NULL)
+			filename = argv[i];
+		else
+			return _cli_error_usage(argv[0]);
+	if(filename != NULL && strcmp(filename, "-") == 0)
+		filename = NULL;
+	/* guess the format from the filename otherwise */
+	if(f != NULL && exchange_parse_format(f, &format) != 0)
+		return -1;
+	else if(f == NULL && filename != NULL)
+		exchange_parse_format(filename, &format);
+	if(filename != NULL && (fp = fopen(filename, "r")) == NULL)
+		return -error_set_code(1, "%s: %s", filename, strerror(errno));
+	if((exchange = exchange_new(fp, format)) == NULL)
+	{
+		if(fp != stdin)
+			fclose(fp);
+		return -1;
+	}
+	/* every task is written as soon as it is read, and only made durable
+	 * once by cli_flush() */
+	while(ret == 0 && !ferror(fp))
+	{
+		if((task = task_new()) == NULL)
+		{
+			ret = -1;
+			break;
+		}
+		if((res = exchange_read(exchange, task)) <= 0)
+		{
+			task_delete(task);
+			if(res == 0)
+				break;
+			fprintf(stderr, "%s: %s:%lu: %s\n", PROGNAME_AUDITOR,
+					(filename != NULL) ? filename
+					: "<stdin>",
+					exchange_get_line(exchange),
+					error_get(NULL));
+			errors++;
+			continue;
+		}
+		if((p = _cli_task_new_filename(cli)) == NULL
+				|| task_set_filename(task, p) != 0
+				|| task_set_journal(task, cli->journal) != 0
+				|| task_save(task) != 0)
+			ret = -1;
+		else if(cli->journal == NULL)
+		{
+			g_ptr_array_add(cli->files, p);
+			p = NULL;
+		}
+		free(p);
+		task_delete(task);
+	}
+	exchange_delete(exchange);
+	if(fp != stdin)
+		fclose(fp);
+	if(ret == 0 && errors > 0)
+		ret = -error_set_code(1, "%lu record(s) could not be imported",
+				errors);
+	return ret;
+}
+
+
+/* cli_list */
+static int _list_foreach(Cli * cli, char const * id, Task * task,
+		void * priv);
+
+static int _cli_list(Cli * cli, int argc, char * argv[])
+{
+	int ret;
+	Filter * filter = NULL;
+
+	if(argc > 2)
+		return _cli_error_usage(argv[0]);
+	if(argc == 2 && (filter = filter_new(argv[1])) == NULL)
+		return -1;
+	ret = _cli_foreach(cli, 0, _list_foreach, filter);
+	if(filter != NULL)
+		filter_delete(filter);
+	return ret;
+}
+
+static int _list_foreach(Cli * cli, char const * id, Task * task,
+		void * priv)
+{
+	Filter * filter = priv;
+	char const * title;
+	char const * priority = NULL;
+	AuditorPriority p;
+	time_t date;
+	char start[20] = "-";
+	char end[20] = "-";
+	struct tm tm;
+	size_t i;
+
+	if(filter != NULL && !_cli_match(filter, task))
+		return 0;
+	if((title = task_get_title(task)) == NULL)
+		title = "";
+	/* the output does not depend on the locale */
+	p = task_get_priority(task);
+	for(i = 0; priorities[i].title != NULL; i++)
+		if(priorities[i].priority == p)
+			priority = priorities[i].title;
+	if((date = task_get_start(task)) != 0
+			&& localtime_r(&date, &tm) != NULL)
+		strftime(start, sizeof(start), "%Y-%m-%dT%H:%M:%S", &tm);
+	if((date = task_get_end(task)) != 0 && localtime_r(&date, &tm) != NULL)
+		strftime(end, sizeof(end), "%Y-%m-%dT%H:%M:%S", &tm);
+	printf("%s\t%d\t%s\t%s\t%s\t%s\n", id,
+			(task_get_done(task) > 0) ? 1 : 0,
+			(priority != NULL) ? priority : "Unknown", start, end,
+			title);
+	return 0;
+}
+
+
+/* cli_memory */
+static int _memory_foreach(Cli * cli, char const * id, Task * task,
+		void * priv);
+static void _memory_print(char const * name, size_t size, unsigned long count);
+
+static int _cli_memory(Cli * cli, int argc, char * argv[])
+{
+	int ret;
+	TaskStore * store;
+	GtkTreeIter iter;
+	gboolean valid;
+	TaskStats stats;
+	TaskStoreMemory memory;
+	char const * names[TASK_MEMORY_COUNT] = { "object", "filename",
+		"title", "description", "description text", "other fields" };
+	size_t tasks = 0;
+	size_t i;
+	struct rusage ru;
+
+	if(argc != 1)
+		return _cli_error_usage(argv[0]);
+	/* loaded and indexed as in the window */
+	store = taskstore_new();
+	if((ret = _cli_foreach(cli, 0, _memory_foreach, store)) == 0)
+		while((ret = taskstore_index(store, G_MAXUINT)) > 0);
+	task_stats_get(&stats);
+	taskstore_get_memory(store, &memory);
+	printf("%lu task(s), in bytes:\n", stats.tasks);
+	for(i = 0; i < TASK_MEMORY_COUNT; i++)
+	{
+		_memory_print(names[i], stats.memory[i], stats.tasks);
+		tasks += stats.memory[i];
+	}
+	_memory_print("tasks", tasks, stats.tasks);
+	_memory_print("store rows", memory.rows, stats.tasks);
+	_memory_print("store indexes", memory.indexes, stats.tasks);
+	_memory_print("store titles", memory.titles, stats.tasks);
+	_memory_print("search index", memory.search, stats.tasks);
+	_memory_print("total", tasks + memory.rows + memory.indexes
+			+ memory.titles + memory.search, stats.tasks);
+	if(getrusage(RUSAGE_SELF, &ru) == 0)
+		printf("peak resident size: %ld kB\n", (long)ru.ru_maxrss);
+	/* the tasks are only referenced by the store */
+	for(valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iter);
+			valid == TRUE; valid = gtk_tree_model_iter_next(
+				GTK_TREE_MODEL(store), &iter))
+		task_delete(taskstore_get_task(store, &iter));
+	g_object_unref(store);
+	return ret;
+}
+
+static int _memory_foreach(Cli * cli, char const * id, Task * task,
+		void * priv)
+{
+	TaskStore * store = priv;
+	GtkTreeIter iter;
+
+	/* the tasks of this batch remain where they are */
+	if(g_hash_table_contains(cli->tasks, id))
+		return 0;
+	return (taskstore_insert(store, &iter, 0, task) == 0) ? 1 : -1;
+}
+
+static void _memory_print(char const * name, size_t size, unsigned long count)
+{
+	printf("%-17s %12zu %10.1f per task\n", name, size,
+			(count > 0) ? (double)size / count : 0.0);
+}
+
+
+/* cli_rm */
+static int _cli_rm(Cli * cli, int argc, char * argv[])
+{
+	int i;
+	int queued;
+	int written;
+	char * filename;
+
+	if(argc < 2)
+		return _cli_error_usage(argv[0]);
+	for(i = 1; i < argc; i++)
+	{
+		queued = g_hash_table_remove(cli->tasks, argv[i]);
+		if(cli->journal != NULL)
+		{
+			/* the tasks added in this batch were never written */
+			if((written = journal_has(cli->journal, argv[i]))
+					&& journal_remove(cli->journal, argv[i])
+					!= 0)
+				return -1;
+			if(!queued && !written)
+				return -error_set_code(1, "%s: %s", argv[i],
+						strerror(ENOENT));
+			continue;
+		}
+		if((filename = _cli_task_get_filename(cli, argv[i])) == NULL)
+			return -1;
+		if(unlink(filename) != 0)
+		{
+			error_set_code(1, "%s: %s", argv[i], strerror(errno));
+			g_free(filename);
+			return -1;
+		}
+		g_free(filename);
+		cli->removed = 1;
+	}
+	return 0;
+}
+
+
+/* cli_set */
+static int _cli_set(Cli * cli, int argc, char * argv[])
+{
+	int i;
+	Task * task;
+
+	if(argc < 3)
+		return _cli_error_usage(argv[0]);
+	if((task = _cli_task_get(cli, argv[1])) == NULL)
+		return -1;
+	for(i = 2; i < argc; i++)
+		if(_cli_task_set(task, argv[i]) != 0)
+			return -1;
+	return 0;
+}
+
+
+/* useful */
+/* cli_batch_split */
+static int _cli_batch_split(char * line, char * argv[], size_t size)
+{
+	size_t argc = 0;
+	char * p = line;
+	char * q;
+	char quote;
+
+	/* split the line like a shell would, without any expansion */
+	for(;;)
+	{
+		while(isspace((unsigned char)*p))
+			p++;
+		if(*p == '\0' || *p == '#')
+			break;
+		if(argc + 1 >= size)
+			return -error_set_code(1, "%s", "Too many arguments");
+		for(argv[argc++] = q = p, quote = '\0'; *p != '\0'; p++)
+			if(quote == '\0' && isspace((unsigned char)*p))
+				break;
+			else if(quote != '\0' && *p == quote)
+				quote = '\0';
+			else if(quote == '\0' && (*p == '"' || *p == '\''))
+				quote = *p;
+			else if(*p == '\\' && quote != '\'' && p[1] != '\0')
+				*(q++) = *(++p);
+			else
+				*(q++) = *p;
+		if(quote != '\0')
+			return -error_set_code(1, "%s", "Unterminated quote");
+		if(*p != '\0')
+			p++;
+		*q = '\0';
+	}
+	argv[argc] = NULL;
+	return argc;
+}
+
+
+/* cli_error_usage */
+static int _cli_error_usage(char const * name)
+{
+	size_t i;
+
+	for(i = 0; i < sizeof(_cli_commands) / sizeof(*_cli_commands); i++)
+		if(strcmp(_cli_commands[i].name, name) == 0)
+			break;
+	return -error_set_code(1, "Usage: %s %s %s", PROGNAME_AUDITOR, name,
+			_cli_commands[i].usage);
+}
+
+
+/* cli_foreach */
+static int _foreach_journal(char const * id, char const * data, size_t size,
+		void * priv);
+
+static int _cli_foreach(Cli * cli, int full, CliForeachCallback callback,
+		void * priv)
+{
+	int ret = 0;
+	CliForeach foreach;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	DIR * dir;
+	struct dirent * de;
+	Task * task;
+	char * filename;
+
+	/* the tasks used in this batch first, as they are now */
+	g_hash_table_iter_init(&iter, cli->tasks);
+	while(ret == 0 && g_hash_table_iter_next(&iter, &key, &value))
+		ret = callback(cli, key, value, priv);
+	if(ret != 0)
+		return ret;
+	if(cli->journal != NULL)
+	{
+		foreach.cli = cli;
+		foreach.full = full;
+		foreach.callback = callback;
+		foreach.priv = priv;
+		return journal_foreach(cli->journal, _foreach_journal,
+				&foreach);
+	}
+	/* then one task at a time from the disk */
+	if((dir = opendir(cli->directory)) == NULL)
+		return (errno == ENOENT) ? 0 : -error_set_code(1, "%s: %s",
+				cli->directory, strerror(errno));
+	while(ret == 0 && (de = readdir(dir)) != NULL)
+	{
+		if(strncmp(de->d_name, "task.", 5) != 0
+				|| g_hash_table_contains(cli->tasks,
+					de->d_name))
+			continue;
+		if((filename = _cli_task_get_filename(cli, de->d_name)) == NULL
+				|| (task = task_new()) == NULL)
+		{
+			g_free(filename);
+			ret = -1;
+			break;
+		}
+		if(task_set_filename(task, filename) == 0
+				&& (full ? task_load(task)
+					: task_load_header(task)) == 0)
+			ret = callback(cli, de->d_name, task, priv);
+		if(ret == 1)
+			ret = 0;
+		else
+			task_delete(task);
+		g_free(filename);
+	}
+	closedir(dir);
+	return ret;
+}
+
+static int _foreach_journal(char const * id, char const * data, size_t size,
+		void * priv)
+{
+	int ret = 0;
+	CliForeach * foreach = priv;
+	Task * task;
+
+	if(g_hash_table_contains(foreach->cli->tasks, id))
+		return 0;
+	if((task = task_new()) == NULL)
+		return -1;
+	if((foreach->full ? task_load_data(task, data, size)
+				: task_load_header_data(task, data, size)) == 0)
+		ret = foreach->callback(foreach->cli, id, task,
+				foreach->priv);
+	if(ret == 1)
+		return 0;
+	task_delete(task);
+	return ret;
+}
+
+
+/* cli_match */
+static int _cli_match(Filter * filter, Task * task)
+{
+	FilterRow row;
+
+	row.done = (task_get_done(task) > 0) ? 1 : 0;
+	if((row.title = task_get_title(task)) == NULL)
+		row.title = "";
+	row.start = task_get_start(task);
+	row.end = task_get_end(task);
+	row.priority = task_get_priority(task);
+	return filter_match(filter, &row);
+}
+
+
+/* cli_task_get */
+static Task * _cli_task_get(Cli * cli, char const * id)
+{
+	Task * task;
+	char * filename;
+
+	if((task = g_hash_table_lookup(cli->tasks, id)) != NULL)
+		return task;
+	if(strncmp(id, "task.", 5) != 0 || strchr(id, '/') != NULL)
+	{
+		error_set_code(1, "%s: %s", id, "Invalid task identifier");
+		return NULL;
+	}
+	if(cli->journal != NULL && !journal_has(cli->journal, id))
+	{
+		error_set_code(1, "%s: %s", id, strerror(ENOENT));
+		return NULL;
+	}
+	if((task = task_new()) == NULL)
+		return NULL;
+	if((filename = _cli_task_get_filename(cli, id)) == NULL
+			|| task_set_filename(task, filename) != 0
+			|| task_set_journal(task, cli->journal) != 0
+			|| task_load(task) != 0)
+	{
+		g_free(filename);
+		task_delete(task);
+		return NULL;
+	}
+	g_free(filename);
+	g_hash_table_insert(cli->tasks, g_strdup(id), task);
+	return task;
+}
+
+
+/* cli_task_get_filename */
+static char * _cli_task_get_filename(Cli * cli, char const * id)
+{
+	if(strncmp(id, "task.", 5) != 0 || strchr(id, '/') != NULL)
+	{
+		error_set_code(1, "%s: %s", id, "Invalid task identifier");
+		return NULL;
+	}
+	/* the tasks are identified by their name in the journal */
+	if(cli->journal != NULL)
+		return g_strdup(id);
+	return g_build_filename(cli->directory, id, NULL);
+}
+
+
+/* cli_task_new_filename */
+static char * _cli_task_new_filename(Cli * cli)
+{
+	char * filename;
+	size_t len;
+	int fd;
+
+	if(cli->journal != NULL)
+	{
+		/* the tasks added in this batch are not in the journal yet */
+		while((filename = journal_new_id(cli->journal)) != NULL
+				&& g_hash_table_contains(cli->tasks, filename))
+			free(filename);
+		return filename;
+	}
+	len = strlen(cli->directory) + sizeof("/task.XXXXXX");
+	if((filename = malloc(len)) == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		return NULL;
+	}
+	snprintf(filename, len, "%s/%s", cli->directory, "task.XXXXXX");
+	if((mkdir(cli->directory, 0777) != 0 && errno != EEXIST)
+			|| (fd = mkstemp(filename)) < 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		free(filename);
+		return NULL;
+	}
+	close(fd);
+	return filename;
+}
+
+
+/* cli_task_set */
+static int _cli_task_set(Task * task, char const * assignment)
+{
+	char const * value;
+	ExchangeField field;
+
+	if((value = strchr(assignment, '=')) == NULL)
+		return -error_set_code(1, "%s: %s", assignment,
+				"Expected field=value");
+	if(exchange_parse_field(assignment, value - assignment, &field) != 0)
+		return -1;
+	return exchange_task_set(task, field, value + 1);
+}
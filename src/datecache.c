@@ -0,0 +1,138 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <locale.h>
+#include <System.h>
+#include "datecache.h"
+
+
+/* DateCache */
+/* private */
+/* types */
+typedef struct _DateCacheEntry
+{
+	time_t date;
+	char buf[64];
+} DateCacheEntry;
+
+struct _DateCache
+{
+	DateCacheEntry * entries;
+	size_t size;
+	char * locale;
+};
+
+
+/* prototypes */
+static void _datecache_reset(DateCache * cache);
+
+
+/* public */
+/* functions */
+/* datecache_new */
+DateCache * datecache_new(size_t size)
+{
+	DateCache * cache;
+
+	if(size == 0)
+	{
+		error_set_code(1, "%s", strerror(EINVAL));
+		return NULL;
+	}
+	if((cache = object_new(sizeof(*cache))) == NULL)
+		return NULL;
+	cache->entries = malloc(sizeof(*cache->entries) * size);
+	cache->size = size;
+	cache->locale = NULL;
+	if(cache->entries == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		datecache_delete(cache);
+		return NULL;
+	}
+	_datecache_reset(cache);
+	return cache;
+}
+
+
+/* datecache_delete */
+void datecache_delete(DateCache * cache)
+{
+	free(cache->locale);
+	free(cache->entries);
+	object_delete(cache);
+}
+
+
+/* useful */
+/* datecache_format */
+char const * datecache_format(DateCache * cache, time_t date)
+{
+	char const * locale;
+	DateCacheEntry * entry;
+	struct tm tm;
+
+	if(date == 0)
+		return "";
+	/* the entries are only valid for the current locale */
+	if((locale = setlocale(LC_TIME, NULL)) == NULL)
+		locale = "C";
+	if(cache->locale == NULL || strcmp(cache->locale, locale) != 0)
+	{
+		free(cache->locale);
+		cache->locale = strdup(locale);
+		_datecache_reset(cache);
+	}
+	entry = &cache->entries[(size_t)date % cache->size];
+	if(entry->date == date)
+		return entry->buf;
+	entry->date = date;
+	if(localtime_r(&date, &tm) == NULL
+			|| strftime(entry->buf, sizeof(entry->buf), "%c", &tm)
+			== 0)
+		entry->buf[0] = '\0';
+	return entry->buf;
+}
+
+
+/* private */
+/* functions */
+/* datecache_reset */
+static void _datecache_reset(DateCache * cache)
+{
+	size_t i;
+
+	for(i = 0; i < cache->size; i++)
+	{
+		cache->entries[i].date = 0;
+		cache->entries[i].buf[0] = '\0';
+	}
+}
@@ -0,0 +1,914 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "filter.h"
+#include "priority.h"
+#include "exchange.h"
+
+/* constants */
+#define EXCHANGE_COLUMNS_MAX	64
+
+
+/* Exchange */
+/* private */
+/* types */
+struct _Exchange
+{
+	FILE * fp;
+	ExchangeFormat format;
+	ExchangeField fields[EXCHANGE_FIELD_COUNT];
+	size_t fields_cnt;
+	unsigned long records;
+
+	/* reading, one record at a time */
+	unsigned long line;
+	unsigned long record_line;
+	char * buffer;
+	size_t buffer_size;
+	int columns[EXCHANGE_COLUMNS_MAX];
+	size_t columns_cnt;
+};
+
+
+/* prototypes */
+static int _exchange_append(Exchange * exchange, size_t * len, int c);
+static char const * _exchange_get_value(ExchangeField field, char const * id,
+		Task * task, char * buf, size_t size);
+static int _exchange_getline(Exchange * exchange);
+
+/* CSV */
+static int _exchange_read_csv(Exchange * exchange, Task * task);
+static int _exchange_read_csv_field(Exchange * exchange, int * end);
+static void _exchange_write_csv(Exchange * exchange, char const * id,
+		Task * task);
+static void _exchange_write_csv_string(FILE * fp, char const * string);
+
+/* JSON Lines */
+static int _exchange_read_jsonl(Exchange * exchange, Task * task);
+static char * _exchange_read_jsonl_string(char ** string);
+static void _exchange_write_jsonl(Exchange * exchange, char const * id,
+		Task * task);
+static void _exchange_write_jsonl_string(FILE * fp, char const * string);
+
+/* todo.txt */
+static int _exchange_read_todotxt(Exchange * exchange, Task * task);
+static int _exchange_read_todotxt_date(char ** string, time_t * date);
+static AuditorPriority _exchange_todotxt_priority(char letter);
+static void _exchange_write_todotxt(Exchange * exchange, char const * id,
+		Task * task);
+
+
+/* constants */
+static char const * _exchange_fields[EXCHANGE_FIELD_COUNT] =
+{
+	"id", "title", "done", "priority", "start", "end", "category",
+	"description"
+};
+
+static const struct
+{
+	char const * name;
+	char const * extension;
+} _exchange_formats[EXCHANGE_FORMAT_COUNT] =
+{
+	{ "csv",	".csv"		},
+	{ "jsonl",	".jsonl"	},
+	{ "todo.txt",	".txt"		}
+};
+
+/* the priorities of todo.txt, from A to D */
+static const AuditorPriority _exchange_todotxt_priorities[] =
+{
+	AUDITOR_PRIORITY_URGENT,
+	AUDITOR_PRIORITY_HIGH,
+	AUDITOR_PRIORITY_MEDIUM,
+	AUDITOR_PRIORITY_LOW
+};
+
+
+/* public */
+/* functions */
+/* exchange_new */
+Exchange * exchange_new(FILE * fp, ExchangeFormat format)
+{
+	Exchange * exchange;
+
+	if(format > EXCHANGE_FORMAT_LAST)
+	{
+		error_set_code(1, "%s", "Unknown format");
+		return NULL;
+	}
+	if((exchange = object_new(sizeof(*exchange))) == NULL)
+		return NULL;
+	exchange->fp = fp;
+	exchange->format = format;
+	/* every field by default */
+	for(exchange->fields_cnt = 0; exchange->fields_cnt
+			< EXCHANGE_FIELD_COUNT; exchange->fields_cnt++)
+		exchange->fields[exchange->fields_cnt] = exchange->fields_cnt;
+	exchange->records = 0;
+	exchange->line = 0;
+	exchange->record_line = 0;
+	exchange->buffer = NULL;
+	exchange->buffer_size = 0;
+	exchange->columns_cnt = 0;
+	return exchange;
+}
+
+
+/* exchange_delete */
+void exchange_delete(Exchange * exchange)
+{
+	free(exchange->buffer);
+	object_delete(exchange);
+}
+
+
+/* accessors */
+/* exchange_get_field */
+int exchange_get_field(Exchange * exchange, ExchangeField field)
+{
+	size_t i;
+
+	for(i = 0; i < exchange->fields_cnt; i++)
+		if(exchange->fields[i] == field)
+			return 1;
+	return 0;
+}
+
+
+/* exchange_get_line */
+unsigned long exchange_get_line(Exchange * exchange)
+{
+	return exchange->record_line;
+}
+
+
+/* exchange_set_fields */
+int exchange_set_fields(Exchange * exchange, char const * fields)
+{
+	ExchangeField f[EXCHANGE_FIELD_COUNT];
+	size_t cnt = 0;
+	char const * p;
+	size_t len;
+
+	/* a list of fields separated by commas */
+	for(p = fields;; p += len + 1)
+	{
+		len = strcspn(p, ",");
+		if(cnt == EXCHANGE_FIELD_COUNT)
+			return -error_set_code(1, "%s", "Too many fields");
+		if(exchange_parse_field(p, len, &f[cnt++]) != 0)
+			return -1;
+		if(p[len] == '\0')
+			break;
+	}
+	memcpy(exchange->fields, f, sizeof(*f) * cnt);
+	exchange->fields_cnt = cnt;
+	return 0;
+}
+
+
+/* useful */
+/* exchange_parse_field */
+int exchange_parse_field(char const * name, size_t length,
+		ExchangeField * field)
+{
+	size_t i;
+
+	for(i = 0; i < EXCHANGE_FIELD_COUNT; i++)
+		if(strlen(_exchange_fields[i]) == length
+				&& g_ascii_strncasecmp(_exchange_fields[i],
+					name, length) == 0)
+		{
+			*field = i;
+			return 0;
+		}
+	return -error_set_code(1, "%.*s: %s", (int)length, name,
+			"Unknown field");
+}
+
+
+/* exchange_parse_format */
+int exchange_parse_format(char const * name, ExchangeFormat * format)
+{
+	size_t i;
+	size_t len;
+	size_t elen;
+
+	/* the name of the format, or a filename with its extension */
+	len = strlen(name);
+	for(i = 0; i < EXCHANGE_FORMAT_COUNT; i++)
+		if(g_ascii_strcasecmp(_exchange_formats[i].name, name) == 0
+				|| (len > (elen = strlen(
+							_exchange_formats[i]
+							.extension))
+					&& g_ascii_strcasecmp(
+						_exchange_formats[i].extension,
+						&name[len - elen]) == 0))
+		{
+			*format = i;
+			return 0;
+		}
+	return -error_set_code(1, "%s: %s", name, "Unknown format");
+}
+
+
+/* exchange_read */
+int exchange_read(Exchange * exchange, Task * task)
+{
+	int ret = -1;
+
+	switch(exchange->format)
+	{
+		case EXCHANGE_FORMAT_CSV:
+			ret = _exchange_read_csv(exchange, task);
+			break;
+		case EXCHANGE_FORMAT_JSONL:
+			ret = _exchange_read_jsonl(exchange, task);
+			break;
+		case EXCHANGE_FORMAT_TODOTXT:
+			ret = _exchange_read_todotxt(exchange, task);
+			break;
+	}
+	if(ret > 0)
+		exchange->records++;
+	return ret;
+}
+
+
+/* exchange_task_set */
+int exchange_task_set(Task * task, ExchangeField field, char const * value)
+{
+	int done;
+	time_t date;
+	AuditorPriority priority = AUDITOR_PRIORITY_UNKNOWN;
+
+	switch(field)
+	{
+		case EXCHANGE_FIELD_ID:
+			break;
+		case EXCHANGE_FIELD_CATEGORY:
+			return task_set_category(task, value);
+		case EXCHANGE_FIELD_DESCRIPTION:
+			return task_set_description(task, value);
+		case EXCHANGE_FIELD_DONE:
+			if(filter_parse_boolean(value, &done) != 0)
+				return -error_set_code(1, "%s: %s", value,
+						"Invalid boolean");
+			/* keep the completion date when already known */
+			date = task_get_end(task);
+			if(task_set_done(task, done) != 0)
+				return -1;
+			return (done && date != 0) ? task_set_end(task, date)
+				: 0;
+		case EXCHANGE_FIELD_END:
+		case EXCHANGE_FIELD_START:
+			if(value[0] == '\0')
+				date = 0;
+			else if(filter_parse_date(value, &date) != 0)
+				return -error_set_code(1, "%s: %s", value,
+						"Invalid date");
+			return (field == EXCHANGE_FIELD_END)
+				? task_set_end(task, date)
+				: task_set_start(task, date);
+		case EXCHANGE_FIELD_PRIORITY:
+			if(value[0] != '\0'
+					&& priority_parse(value, &priority)
+					!= 0)
+				return -error_set_code(1, "%s: %s", value,
+						"Invalid priority");
+			return task_set_priority(task, priority);
+		case EXCHANGE_FIELD_TITLE:
+			return task_set_title(task, value);
+	}
+	return -error_set_code(1, "%s: %s", _exchange_fields[field],
+			"Read-only field");
+}
+
+
+/* exchange_write */
+int exchange_write(Exchange * exchange, char const * id, Task * task)
+{
+	switch(exchange->format)
+	{
+		case EXCHANGE_FORMAT_CSV:
+			_exchange_write_csv(exchange, id, task);
+			break;
+		case EXCHANGE_FORMAT_JSONL:
+			_exchange_write_jsonl(exchange, id, task);
+			break;
+		case EXCHANGE_FORMAT_TODOTXT:
+			_exchange_write_todotxt(exchange, id, task);
+			break;
+	}
+	if(ferror(exchange->fp))
+		return -error_set_code(1, "%s", strerror(errno));
+	exchange->records++;
+	return 0;
+}
+
+
+/* private */
+/* functions */
+/* exchange_append */
+static int _exchange_append(Exchange * exchange, size_t * len, int c)
+{
+	char * p;
+	size_t size;
+
+	if(*len + 1 >= exchange->buffer_size)
+	{
+		size = (exchange->buffer_size > 0)
+			? exchange->buffer_size * 2 : 256;
+		if((p = realloc(exchange->buffer, size)) == NULL)
+			return -error_set_code(1, "%s", strerror(errno));
+		exchange->buffer = p;
+		exchange->buffer_size = size;
+	}
+	exchange->buffer[(*len)++] = c;
+	exchange->buffer[*len] = '\0';
+	return 0;
+}
+
+
+/* exchange_get_value */
+static char const * _exchange_get_value(ExchangeField field, char const * id,
+		Task * task, char * buf, size_t size)
+{
+	char const * p;
+	AuditorPriority priority;
+	size_t i;
+	time_t date;
+	struct tm tm;
+
+	/* the values do not depend on the locale; NULL when not set */
+	switch(field)
+	{
+		case EXCHANGE_FIELD_ID:
+			return id;
+		case EXCHANGE_FIELD_CATEGORY:
+			p = task_get_category(task);
+			return (p[0] != '\0') ? p : NULL;
+		case EXCHANGE_FIELD_DESCRIPTION:
+			return ((p = task_get_description(task)) != NULL)
+				? p : "";
+		case EXCHANGE_FIELD_DONE:
+			return (task_get_done(task) > 0) ? "1" : "0";
+		case EXCHANGE_FIELD_END:
+		case EXCHANGE_FIELD_START:
+			date = (field == EXCHANGE_FIELD_END)
+				? task_get_end(task) : task_get_start(task);
+			if(date == 0 || localtime_r(&date, &tm) == NULL
+					|| strftime(buf, size,
+						"%Y-%m-%dT%H:%M:%S", &tm) == 0)
+				return NULL;
+			return buf;
+		case EXCHANGE_FIELD_PRIORITY:
+			priority = task_get_priority(task);
+			if(priority == AUDITOR_PRIORITY_UNKNOWN)
+				return NULL;
+			for(i = 0; priorities[i].title != NULL; i++)
+				if(priorities[i].priority == priority)
+					return priorities[i].title;
+			return NULL;
+		case EXCHANGE_FIELD_TITLE:
+			return ((p = task_get_title(task)) != NULL) ? p : "";
+	}
+	return NULL;
+}
+
+
+/* exchange_getline */
+static int _exchange_getline(Exchange * exchange)
+{
+	ssize_t len;
+
+	/* skip the empty lines */
+	do
+	{
+		if((len = getline(&exchange->buffer, &exchange->buffer_size,
+						exchange->fp)) < 0)
+			return ferror(exchange->fp) ? -error_set_code(1, "%s",
+					strerror(errno)) : 0;
+		exchange->record_line = ++exchange->line;
+		while(len > 0 && isspace((unsigned char)exchange->buffer[
+					len - 1]))
+			exchange->buffer[--len] = '\0';
+	}
+	while(len == 0);
+	return 1;
+}
+
+
+/* CSV */
+/* exchange_read_csv */
+static int _exchange_read_csv(Exchange * exchange, Task * task)
+{
+	int ret = 1;
+	size_t column;
+	int end = 0;
+	int res;
+	ExchangeField field;
+
+	/* the first record names the columns */
+	while(exchange->columns_cnt == 0)
+	{
+		exchange->record_line = exchange->line + 1;
+		for(end = 0; !end && exchange->columns_cnt
+				< EXCHANGE_COLUMNS_MAX; exchange->columns_cnt++)
+		{
+			if((res = _exchange_read_csv_field(exchange, &end)) < 0
+					|| (res == 0 && exchange->columns_cnt
+						== 0))
+				return res;
+			/* the other columns are ignored */
+			exchange->columns[exchange->columns_cnt]
+				= (exchange_parse_field(exchange->buffer,
+							strlen(exchange->buffer),
+							&field) == 0)
+				? (int)field : -1;
+		}
+		if(!end)
+			return -error_set_code(1, "%s", "Too many columns");
+	}
+	do
+	{
+		exchange->record_line = exchange->line + 1;
+		for(column = 0, end = 0; !end; column++)
+		{
+			if((res = _exchange_read_csv_field(exchange, &end)) < 0
+					|| (res == 0 && column == 0))
+				return res;
+			/* the empty lines are ignored */
+			if(column == 0 && end && exchange->buffer[0] == '\0')
+				break;
+			if(ret > 0 && column < exchange->columns_cnt
+					&& exchange->columns[column] >= 0
+					&& exchange->columns[column]
+					!= EXCHANGE_FIELD_ID
+					&& exchange_task_set(task,
+						exchange->columns[column],
+						exchange->buffer) != 0)
+				/* read the rest of the record anyway */
+				ret = -1;
+		}
+	}
+	while(column == 0);
+	return ret;
+}
+
+
+/* exchange_read_csv_field */
+static int _exchange_read_csv_field(Exchange * exchange, int * end)
+{
+	FILE * fp = exchange->fp;
+	size_t len = 0;
+	int c;
+
+	/* the buffer holds an empty string at least */
+	if(_exchange_append(exchange, &len, '\0') != 0)
+		return -1;
+	len = 0;
+	if((c = getc(fp)) == EOF)
+	{
+		if(ferror(fp))
+			return -error_set_code(1, "%s", strerror(errno));
+		*end = 1;
+		return 0;
+	}
+	if(c == '"')
+		/* quoted, possibly over several lines */
+		for(;;)
+		{
+			if((c = getc(fp)) == EOF)
+				return -error_set_code(1, "%s",
+						"Unterminated quote");
+			if(c == '"' && (c = getc(fp)) != '"')
+				break;
+			if(c == '\n')
+				exchange->line++;
+			if(_exchange_append(exchange, &len, c) != 0)
+				return -1;
+		}
+	for(; c != ',' && c != '\n' && c != EOF; c = getc(fp))
+		if(c != '\r' && _exchange_append(exchange, &len, c) != 0)
+			return -1;
+	if(c == '\n')
+		exchange->line++;
+	*end = (c != ',') ? 1 : 0;
+	return 1;
+}
+
+
+/* exchange_write_csv */
+static void _exchange_write_csv(Exchange * exchange, char const * id,
+		Task * task)
+{
+	size_t i;
+	char buf[32];
+	char const * p;
+
+	/* the first record names the columns */
+	if(exchange->records == 0)
+	{
+		for(i = 0; i < exchange->fields_cnt; i++)
+			fprintf(exchange->fp, "%s%s", (i > 0) ? "," : "",
+					_exchange_fields[exchange->fields[i]]);
+		fputc('\n', exchange->fp);
+	}
+	for(i = 0; i < exchange->fields_cnt; i++)
+	{
+		if(i > 0)
+			fputc(',', exchange->fp);
+		if((p = _exchange_get_value(exchange->fields[i], id, task, buf,
+						sizeof(buf))) != NULL)
+			_exchange_write_csv_string(exchange->fp, p);
+	}
+	fputc('\n', exchange->fp);
+}
+
+
+/* exchange_write_csv_string */
+static void _exchange_write_csv_string(FILE * fp, char const * string)
+{
+	if(strpbrk(string, ",\"\r\n") == NULL)
+	{
+		fputs(string, fp);
+		return;
+	}
+	fputc('"', fp);
+	for(; *string != '\0'; string++)
+	{
+		if(*string == '"')
+			fputc('"', fp);
+		fputc(*string, fp);
+	}
+	fputc('"', fp);
+}
+
+
+/* JSON Lines */
+/* exchange_read_jsonl */
+static int _exchange_read_jsonl(Exchange * exchange, Task * task)
+{
+	int res;
+	char * p;
+	char * key;
+	char * value;
+	char c;
+	ExchangeField field;
+
+	if((res = _exchange_getline(exchange)) <= 0)
+		return res;
+	/* one object per line, with values of a single level */
+	for(p = exchange->buffer; isspace((unsigned char)*p); p++);
+	if(*(p++) != '{')
+		return -error_set_code(1, "%s", "Object expected");
+	for(; isspace((unsigned char)*p); p++);
+	if(*p == '}')
+		return 1;
+	for(;;)
+	{
+		if(*p != '"' || (key = _exchange_read_jsonl_string(&p)) == NULL)
+			return -error_set_code(1, "%s", "Name expected");
+		for(; isspace((unsigned char)*p); p++);
+		if(*(p++) != ':')
+			return -error_set_code(1, "%s", "Colon expected");
+		for(; isspace((unsigned char)*p); p++);
+		c = '\0';
+		if(*p == '"')
+		{
+			if((value = _exchange_read_jsonl_string(&p)) == NULL)
+				return -error_set_code(1, "%s",
+						"Invalid string");
+		}
+		else if(isalnum((unsigned char)*p) || *p == '-')
+		{
+			for(value = p; isalnum((unsigned char)*p) || *p == '-'
+					|| *p == '+' || *p == '.'; p++);
+			c = *p;
+			*p = '\0';
+			if(strcmp(value, "null") == 0)
+				value = NULL;
+			else if(strcmp(value, "true") == 0)
+				value = "1";
+			else if(strcmp(value, "false") == 0)
+				value = "0";
+		}
+		else
+			return -error_set_code(1, "%s", "Unsupported value");
+		/* the other names are ignored */
+		if(value != NULL && exchange_parse_field(key, strlen(key),
+					&field) == 0
+				&& field != EXCHANGE_FIELD_ID
+				&& exchange_task_set(task, field, value) != 0)
+			return -1;
+		if(c != '\0')
+			*p = c;
+		for(; isspace((unsigned char)*p); p++);
+		if(*p == '}')
+			return 1;
+		if(*(p++) != ',')
+			return -error_set_code(1, "%s", "Comma expected");
+		for(; isspace((unsigned char)*p); p++);
+	}
+}
+
+
+/* exchange_read_jsonl_string */
+static char * _exchange_read_jsonl_string(char ** string)
+{
+	char * ret;
+	char * p;
+	char * q;
+	unsigned long u;
+	unsigned long v;
+	char * r;
+	char buf[5];
+
+	/* decoded in place, never longer than the original */
+	for(ret = q = p = *string + 1; *p != '"'; p++)
+	{
+		if(*p == '\0')
+			return NULL;
+		if(*p != '\\')
+		{
+			*(q++) = *p;
+			continue;
+		}
+		switch(*(++p))
+		{
+			case 'b': *(q++) = '\b'; break;
+			case 'f': *(q++) = '\f'; break;
+			case 'n': *(q++) = '\n'; break;
+			case 'r': *(q++) = '\r'; break;
+			case 't': *(q++) = '\t'; break;
+			case 'u':
+				snprintf(buf, sizeof(buf), "%.4s", p + 1);
+				if(strlen(buf) != 4 || (u = strtoul(buf, &r, 16),
+							*r != '\0'))
+					return NULL;
+				p += 4;
+				/* surrogate pairs */
+				if(u >= 0xd800 && u < 0xdc00 && p[1] == '\\'
+						&& p[2] == 'u')
+				{
+					snprintf(buf, sizeof(buf), "%.4s",
+							p + 3);
+					if(strlen(buf) != 4 || (v = strtoul(buf,
+									&r, 16),
+								*r != '\0')
+							|| v < 0xdc00
+							|| v >= 0xe000)
+						return NULL;
+					u = 0x10000 + ((u - 0xd800) << 10)
+						+ (v - 0xdc00);
+					p += 6;
+				}
+				q += g_unichar_to_utf8(u, q);
+				break;
+			case '\0':
+				return NULL;
+			default:
+				*(q++) = *p;
+				break;
+		}
+	}
+	*string = p + 1;
+	*q = '\0';
+	return ret;
+}
+
+
+/* exchange_write_jsonl */
+static void _exchange_write_jsonl(Exchange * exchange, char const * id,
+		Task * task)
+{
+	size_t i;
+	char buf[32];
+	char const * p;
+	ExchangeField field;
+
+	fputc('{', exchange->fp);
+	for(i = 0; i < exchange->fields_cnt; i++)
+	{
+		field = exchange->fields[i];
+		fprintf(exchange->fp, "%s\"%s\":", (i > 0) ? "," : "",
+				_exchange_fields[field]);
+		p = _exchange_get_value(field, id, task, buf, sizeof(buf));
+		if(p == NULL)
+			fputs("null", exchange->fp);
+		else if(field == EXCHANGE_FIELD_DONE)
+			fputs((p[0] == '1') ? "true" : "false", exchange->fp);
+		else
+			_exchange_write_jsonl_string(exchange->fp, p);
+	}
+	fputs("}\n", exchange->fp);
+}
+
+
+/* exchange_write_jsonl_string */
+static void _exchange_write_jsonl_string(FILE * fp, char const * string)
+{
+	unsigned char const * p;
+
+	fputc('"', fp);
+	for(p = (unsigned char const *)string; *p != '\0'; p++)
+		switch(*p)
+		{
+			case '"':  fputs("\\\"", fp); break;
+			case '\\': fputs("\\\\", fp); break;
+			case '\b': fputs("\\b", fp); break;
+			case '\f': fputs("\\f", fp); break;
+			case '\n': fputs("\\n", fp); break;
+			case '\r': fputs("\\r", fp); break;
+			case '\t': fputs("\\t", fp); break;
+			default:
+				if(*p < 0x20)
+					fprintf(fp, "\\u%04x", *p);
+				else
+					fputc(*p, fp);
+				break;
+		}
+	fputc('"', fp);
+}
+
+
+/* todo.txt */
+/* exchange_read_todotxt */
+static int _exchange_read_todotxt(Exchange * exchange, Task * task)
+{
+	int res;
+	char * p;
+	char * q;
+	int done = 0;
+	time_t end = 0;
+	time_t start = 0;
+	AuditorPriority priority = AUDITOR_PRIORITY_UNKNOWN;
+
+	if((res = _exchange_getline(exchange)) <= 0)
+		return res;
+	/* "x [end] [start] title [pri:A]" or "[(A)] [start] title" */
+	p = exchange->buffer;
+	if(p[0] == 'x' && p[1] == ' ')
+	{
+		done = 1;
+		for(p += 2; *p == ' '; p++);
+		if(_exchange_read_todotxt_date(&p, &end) == 0)
+			_exchange_read_todotxt_date(&p, &start);
+	}
+	else
+	{
+		if(p[0] == '(' && p[1] >= 'A' && p[1] <= 'Z' && p[2] == ')'
+				&& p[3] == ' ')
+		{
+			priority = _exchange_todotxt_priority(p[1]);
+			for(p += 4; *p == ' '; p++);
+		}
+		_exchange_read_todotxt_date(&p, &start);
+	}
+	/* the tags written along, at the end of the line */
+	while((q = strrchr(p, ' ')) != NULL)
+		if(strncmp(q, " pri:", 5) == 0 && q[5] >= 'A' && q[5] <= 'Z'
+				&& q[6] == '\0')
+		{
+			priority = _exchange_todotxt_priority(q[5]);
+			*q = '\0';
+		}
+		else if(strncmp(q, " id:", 4) == 0)
+			*q = '\0';
+		else
+			break;
+	if(task_set_title(task, p) != 0
+			|| task_set_priority(task, priority) != 0
+			|| (start != 0 && task_set_start(task, start) != 0)
+			|| (done && task_set_done(task, 1) != 0)
+			|| (end != 0 && task_set_end(task, end) != 0))
+		return -1;
+	return 1;
+}
+
+
+/* exchange_read_todotxt_date */
+static int _exchange_read_todotxt_date(char ** string, time_t * date)
+{
+	char buf[11];
+	char * p = *string;
+	size_t i;
+
+	/* YYYY-MM-DD followed by a space */
+	for(i = 0; i < sizeof(buf) - 1; i++)
+		if((i == 4 || i == 7) ? p[i] != '-'
+				: !isdigit((unsigned char)p[i]))
+			return -1;
+	if(p[i] != ' ')
+		return -1;
+	memcpy(buf, p, sizeof(buf) - 1);
+	buf[sizeof(buf) - 1] = '\0';
+	if(filter_parse_date(buf, date) != 0)
+		return -1;
+	for(p += i; *p == ' '; p++);
+	*string = p;
+	return 0;
+}
+
+
+/* exchange_todotxt_priority */
+static AuditorPriority _exchange_todotxt_priority(char letter)
+{
+	size_t i = letter - 'A';
+	size_t count = sizeof(_exchange_todotxt_priorities)
+		/ sizeof(*_exchange_todotxt_priorities);
+
+	/* the lower priorities are all considered low */
+	return _exchange_todotxt_priorities[MIN(i, count - 1)];
+}
+
+
+/* exchange_write_todotxt */
+static void _exchange_write_todotxt(Exchange * exchange, char const * id,
+		Task * task)
+{
+	FILE * fp = exchange->fp;
+	int done;
+	time_t end;
+	time_t start;
+	AuditorPriority priority;
+	char letter = '\0';
+	struct tm tm;
+	char const * p;
+	size_t i;
+
+	/* one line per task, without the description */
+	done = exchange_get_field(exchange, EXCHANGE_FIELD_DONE)
+		&& task_get_done(task) > 0;
+	end = (done && exchange_get_field(exchange, EXCHANGE_FIELD_END))
+		? task_get_end(task) : 0;
+	start = exchange_get_field(exchange, EXCHANGE_FIELD_START)
+		? task_get_start(task) : 0;
+	/* the creation date cannot be told apart otherwise */
+	if(done && end == 0)
+		start = 0;
+	priority = exchange_get_field(exchange, EXCHANGE_FIELD_PRIORITY)
+		? task_get_priority(task) : AUDITOR_PRIORITY_UNKNOWN;
+	for(i = 0; i < sizeof(_exchange_todotxt_priorities)
+			/ sizeof(*_exchange_todotxt_priorities); i++)
+		if(_exchange_todotxt_priorities[i] == priority)
+			letter = 'A' + i;
+	if(done)
+		fputs("x ", fp);
+	else if(letter != '\0')
+		fprintf(fp, "(%c) ", letter);
+	if(end != 0 && localtime_r(&end, &tm) != NULL)
+		fprintf(fp, "%04d-%02d-%02d ", tm.tm_year + 1900,
+				tm.tm_mon + 1, tm.tm_mday);
+	if(start != 0 && localtime_r(&start, &tm) != NULL)
+		fprintf(fp, "%04d-%02d-%02d ", tm.tm_year + 1900,
+				tm.tm_mon + 1, tm.tm_mday);
+	if(exchange_get_field(exchange, EXCHANGE_FIELD_TITLE)
+			&& (p = task_get_title(task)) != NULL)
+		for(; *p != '\0'; p++)
+			fputc((*p == '\n' || *p == '\r') ? ' ' : *p, fp);
+	if(done && letter != '\0')
+		fprintf(fp, " pri:%c", letter);
+	if(exchange_get_field(exchange, EXCHANGE_FIELD_ID))
+		fprintf(fp, " id:%s", id);
+	fputc('\n', fp);
+}
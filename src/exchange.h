@@ -0,0 +1,86 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#ifndef AUDITOR_EXCHANGE_H
+# define AUDITOR_EXCHANGE_H
+
+# include <stdio.h>
+# include "task.h"
+
+
+/* Exchange */
+/* types */
+typedef struct _Exchange Exchange;
+
+typedef enum _ExchangeField
+{
+	EXCHANGE_FIELD_ID = 0,
+	EXCHANGE_FIELD_TITLE,
+	EXCHANGE_FIELD_DONE,
+	EXCHANGE_FIELD_PRIORITY,
+	EXCHANGE_FIELD_START,
+	EXCHANGE_FIELD_END,
+	EXCHANGE_FIELD_CATEGORY,
+	EXCHANGE_FIELD_DESCRIPTION
+} ExchangeField;
+# define EXCHANGE_FIELD_LAST EXCHANGE_FIELD_DESCRIPTION
+# define EXCHANGE_FIELD_COUNT (EXCHANGE_FIELD_LAST + 1)
+
+typedef enum _ExchangeFormat
+{
+	EXCHANGE_FORMAT_CSV = 0,
+	EXCHANGE_FORMAT_JSONL,
+	EXCHANGE_FORMAT_TODOTXT
+} ExchangeFormat;
+# define EXCHANGE_FORMAT_LAST EXCHANGE_FORMAT_TODOTXT
+# define EXCHANGE_FORMAT_COUNT (EXCHANGE_FORMAT_LAST + 1)
+
+
+/* functions */
+Exchange * exchange_new(FILE * fp, ExchangeFormat format);
+void exchange_delete(Exchange * exchange);
+
+/* accessors */
+int exchange_get_field(Exchange * exchange, ExchangeField field);
+unsigned long exchange_get_line(Exchange * exchange);
+
+int exchange_set_fields(Exchange * exchange, char const * fields);
+
+/* useful */
+int exchange_read(Exchange * exchange, Task * task);
+int exchange_write(Exchange * exchange, char const * id, Task * task);
+
+int exchange_parse_field(char const * name, size_t length,
+		ExchangeField * field);
+int exchange_parse_format(char const * name, ExchangeFormat * format);
+int exchange_task_set(Task * task, ExchangeField field, char const * value);
+
+#endif /* !AUDITOR_EXCHANGE_H */
@@ -0,0 +1,701 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "priority.h"
+#include "filter.h"
+
+/* constants */
+#define FILTER_DEPTH_MAX	32
+
+
+/* Filter */
+/* private */
+/* types */
+typedef enum _FilterField
+{
+	FILTER_FIELD_DONE = 0,
+	FILTER_FIELD_TITLE,
+	FILTER_FIELD_START,
+	FILTER_FIELD_END,
+	FILTER_FIELD_PRIORITY
+} FilterField;
+
+typedef enum _FilterType
+{
+	FILTER_TYPE_BOOLEAN = 0,
+	FILTER_TYPE_DATE,
+	FILTER_TYPE_PRIORITY,
+	FILTER_TYPE_STRING
+} FilterType;
+
+typedef enum _FilterOperator
+{
+	FILTER_OPERATOR_EQ = 0,
+	FILTER_OPERATOR_NE,
+	FILTER_OPERATOR_LT,
+	FILTER_OPERATOR_LE,
+	FILTER_OPERATOR_GT,
+	FILTER_OPERATOR_GE,
+	FILTER_OPERATOR_CONTAINS
+} FilterOperator;
+
+typedef enum _FilterOpcode
+{
+	FILTER_OPCODE_AND = 0,
+	FILTER_OPCODE_OR,
+	FILTER_OPCODE_NOT,
+	FILTER_OPCODE_COMPARE,
+	FILTER_OPCODE_CONTAINS,
+	FILTER_OPCODE_EQUALS
+} FilterOpcode;
+
+typedef struct _FilterInstruction
+{
+	FilterOpcode opcode;
+	FilterField field;
+	FilterOperator operator;
+	gint64 value;
+	char * string;
+} FilterInstruction;
+
+typedef enum _FilterToken
+{
+	FILTER_TOKEN_END = 0,
+	FILTER_TOKEN_LPAREN,
+	FILTER_TOKEN_RPAREN,
+	FILTER_TOKEN_OPERATOR,
+	FILTER_TOKEN_STRING,
+	FILTER_TOKEN_WORD
+} FilterToken;
+
+typedef struct _FilterParser
+{
+	Filter * filter;
+	char const * expression;
+	char const * p;
+	unsigned int level;
+	unsigned int depth;
+
+	/* current token */
+	FilterToken token;
+	char const * position;
+	FilterOperator operator;
+	char * text;
+} FilterParser;
+
+struct _Filter
+{
+	char * expression;
+
+	/* evaluated in postfix order */
+	FilterInstruction * program;
+	size_t program_cnt;
+};
+
+
+/* prototypes */
+static int _filter_emit(FilterParser * parser, FilterOpcode opcode,
+		FilterField field, FilterOperator operator, gint64 value,
+		char * string);
+static int _filter_error(FilterParser * parser, char const * message);
+
+static int _filter_parse_and(FilterParser * parser);
+static int _filter_parse_next(FilterParser * parser);
+static int _filter_parse_not(FilterParser * parser);
+static int _filter_parse_or(FilterParser * parser);
+static int _filter_parse_primary(FilterParser * parser);
+static int _filter_parse_value(FilterParser * parser, FilterField field,
+		FilterType type, FilterOperator operator);
+
+static int _filter_compare(gint64 a, FilterOperator operator, gint64 b);
+static gint64 _filter_row_get(FilterRow const * row, FilterField field);
+
+
+/* constants */
+static const struct
+{
+	char const * name;
+	FilterField field;
+	FilterType type;
+} _filter_fields[] =
+{
+	{ "done",	FILTER_FIELD_DONE,	FILTER_TYPE_BOOLEAN	},
+	{ "end",	FILTER_FIELD_END,	FILTER_TYPE_DATE	},
+	{ "priority",	FILTER_FIELD_PRIORITY,	FILTER_TYPE_PRIORITY	},
+	{ "start",	FILTER_FIELD_START,	FILTER_TYPE_DATE	},
+	{ "title",	FILTER_FIELD_TITLE,	FILTER_TYPE_STRING	},
+	{ NULL,		0,			0			}
+};
+
+static const struct
+{
+	char const * name;
+	FilterOperator operator;
+} _filter_operators[] =
+{
+	/* the longest operators first */
+	{ "==",	FILTER_OPERATOR_EQ		},
+	{ "!=",	FILTER_OPERATOR_NE		},
+	{ "<=",	FILTER_OPERATOR_LE		},
+	{ ">=",	FILTER_OPERATOR_GE		},
+	{ "=",	FILTER_OPERATOR_EQ		},
+	{ "<",	FILTER_OPERATOR_LT		},
+	{ ">",	FILTER_OPERATOR_GT		},
+	{ "~",	FILTER_OPERATOR_CONTAINS	},
+	{ NULL,	0				}
+};
+
+
+/* public */
+/* functions */
+/* filter_new */
+Filter * filter_new(char const * expression)
+{
+	Filter * filter;
+	FilterParser parser;
+
+	if((filter = object_new(sizeof(*filter))) == NULL)
+		return NULL;
+	filter->expression = strdup(expression);
+	filter->program = NULL;
+	filter->program_cnt = 0;
+	if(filter->expression == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		filter_delete(filter);
+		return NULL;
+	}
+	/* compile the expression once */
+	memset(&parser, 0, sizeof(parser));
+	parser.filter = filter;
+	parser.expression = expression;
+	parser.p = expression;
+	if(_filter_parse_next(&parser) != 0
+			|| (parser.token == FILTER_TOKEN_END
+				&& _filter_error(&parser, "Empty expression")
+				!= 0)
+			|| _filter_parse_or(&parser) != 0
+			|| (parser.token != FILTER_TOKEN_END
+				&& _filter_error(&parser, "Unexpected token")
+				!= 0))
+	{
+		g_free(parser.text);
+		filter_delete(filter);
+		return NULL;
+	}
+	g_free(parser.text);
+	return filter;
+}
+
+
+/* filter_delete */
+void filter_delete(Filter * filter)
+{
+	size_t i;
+
+	for(i = 0; i < filter->program_cnt; i++)
+		g_free(filter->program[i].string);
+	free(filter->program);
+	free(filter->expression);
+	object_delete(filter);
+}
+
+
+/* accessors */
+/* filter_get_expression */
+char const * filter_get_expression(Filter * filter)
+{
+	return filter->expression;
+}
+
+
+/* useful */
+/* filter_match */
+int filter_match(Filter * filter, FilterRow const * row)
+{
+	char stack[FILTER_DEPTH_MAX];
+	size_t sp = 0;
+	size_t i;
+	FilterInstruction * fi;
+	char const * title = (row->title != NULL) ? row->title : "";
+	gchar * folded = NULL;
+	int res;
+
+	for(i = 0; i < filter->program_cnt; i++)
+	{
+		fi = &filter->program[i];
+		switch(fi->opcode)
+		{
+			case FILTER_OPCODE_AND:
+				sp--;
+				stack[sp - 1] = stack[sp - 1] && stack[sp];
+				break;
+			case FILTER_OPCODE_OR:
+				sp--;
+				stack[sp - 1] = stack[sp - 1] || stack[sp];
+				break;
+			case FILTER_OPCODE_NOT:
+				stack[sp - 1] = !stack[sp - 1];
+				break;
+			case FILTER_OPCODE_COMPARE:
+				stack[sp++] = _filter_compare(_filter_row_get(
+							row, fi->field),
+						fi->operator, fi->value);
+				break;
+			case FILTER_OPCODE_CONTAINS:
+				/* only case-folded once for every row */
+				if(folded == NULL)
+					folded = g_utf8_validate(title, -1,
+							NULL)
+						? g_utf8_casefold(title, -1)
+						: g_ascii_strdown(title, -1);
+				stack[sp++] = (strstr(folded, fi->string)
+						!= NULL);
+				break;
+			case FILTER_OPCODE_EQUALS:
+				res = (strcmp(title, fi->string) == 0);
+				stack[sp++] = (fi->operator == FILTER_OPERATOR_EQ)
+					? res : !res;
+				break;
+		}
+	}
+	g_free(folded);
+	return (sp == 1 && stack[0]) ? 1 : 0;
+}
+
+
+/* filter_parse_boolean */
+int filter_parse_boolean(char const * string, int * value)
+{
+	if(strcmp(string, "1") == 0 || g_ascii_strcasecmp(string, "yes") == 0
+			|| g_ascii_strcasecmp(string, "true") == 0)
+		*value = 1;
+	else if(strcmp(string, "0") == 0
+			|| g_ascii_strcasecmp(string, "no") == 0
+			|| g_ascii_strcasecmp(string, "false") == 0)
+		*value = 0;
+	else
+		return -1;
+	return 0;
+}
+
+
+/* filter_parse_date */
+int filter_parse_date(char const * string, time_t * date)
+{
+	gint64 value;
+	gchar * p;
+	struct tm tm;
+	unsigned int year;
+	unsigned int month;
+	unsigned int day;
+	char c;
+	int n = 0;
+
+	/* timestamps */
+	value = g_ascii_strtoll(string, &p, 10);
+	if(string[0] != '\0' && *p == '\0')
+	{
+		*date = value;
+		return 0;
+	}
+	memset(&tm, 0, sizeof(tm));
+	if(strcmp(string, "now") == 0)
+	{
+		*date = time(NULL);
+		return 0;
+	}
+	if(strcmp(string, "today") == 0)
+	{
+		*date = time(NULL);
+		localtime_r(date, &tm);
+		tm.tm_hour = 0;
+		tm.tm_min = 0;
+		tm.tm_sec = 0;
+	}
+	else if(sscanf(string, "%4u-%2u-%2u%n", &year, &month, &day, &n) != 3
+			|| month < 1 || month > 12 || day < 1 || day > 31)
+		return -1;
+	else
+	{
+		tm.tm_year = year - 1900;
+		tm.tm_mon = month - 1;
+		tm.tm_mday = day;
+		/* the time is optional */
+		string += n;
+		if(*string != '\0' && (sscanf(string, "%c%2d:%2d%n", &c,
+						&tm.tm_hour, &tm.tm_min, &n)
+					!= 3 || (c != 'T' && c != ' ')
+					|| tm.tm_hour > 23 || tm.tm_min > 59
+					|| (string[n] != '\0'
+						&& (sscanf(&string[n], ":%2d",
+								&tm.tm_sec)
+							!= 1 || strlen(
+								&string[n])
+							!= 3))))
+			return -1;
+	}
+	tm.tm_isdst = -1;
+	if((*date = mktime(&tm)) == (time_t)-1)
+		return -1;
+	return 0;
+}
+
+
+/* private */
+/* functions */
+/* filter_compare */
+static int _filter_compare(gint64 a, FilterOperator operator, gint64 b)
+{
+	switch(operator)
+	{
+		case FILTER_OPERATOR_EQ:
+			return a == b;
+		case FILTER_OPERATOR_NE:
+			return a != b;
+		case FILTER_OPERATOR_LT:
+			return a < b;
+		case FILTER_OPERATOR_LE:
+			return a <= b;
+		case FILTER_OPERATOR_GT:
+			return a > b;
+		case FILTER_OPERATOR_GE:
+			return a >= b;
+		case FILTER_OPERATOR_CONTAINS:
+			break;
+	}
+	return 0;
+}
+
+
+/* filter_emit */
+static int _filter_emit(FilterParser * parser, FilterOpcode opcode,
+		FilterField field, FilterOperator operator, gint64 value,
+		char * string)
+{
+	Filter * filter = parser->filter;
+	FilterInstruction * p;
+
+	/* the operands are pushed, the operators consume them */
+	if(opcode == FILTER_OPCODE_AND || opcode == FILTER_OPCODE_OR)
+		parser->depth--;
+	else if(opcode != FILTER_OPCODE_NOT
+			&& ++parser->depth > FILTER_DEPTH_MAX)
+	{
+		g_free(string);
+		return _filter_error(parser, "Expression too complex");
+	}
+	if((p = realloc(filter->program, sizeof(*p)
+					* (filter->program_cnt + 1))) == NULL)
+	{
+		g_free(string);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	filter->program = p;
+	p = &filter->program[filter->program_cnt++];
+	p->opcode = opcode;
+	p->field = field;
+	p->operator = operator;
+	p->value = value;
+	p->string = string;
+	return 0;
+}
+
+
+/* filter_error */
+static int _filter_error(FilterParser * parser, char const * message)
+{
+	return -error_set_code(1, "%s (at character %u)", message,
+			(unsigned int)(parser->position - parser->expression)
+			+ 1);
+}
+
+
+/* filter_parse_and */
+static int _filter_parse_and(FilterParser * parser)
+{
+	if(_filter_parse_not(parser) != 0)
+		return -1;
+	for(;;)
+	{
+		/* the "and" keyword is implied between two terms */
+		if(parser->token == FILTER_TOKEN_WORD
+				&& g_ascii_strcasecmp(parser->text, "and") == 0)
+		{
+			if(_filter_parse_next(parser) != 0)
+				return -1;
+		}
+		else if(parser->token != FILTER_TOKEN_LPAREN
+				&& (parser->token != FILTER_TOKEN_WORD
+					|| g_ascii_strcasecmp(parser->text,
+						"or") == 0))
+			return 0;
+		if(_filter_parse_not(parser) != 0
+				|| _filter_emit(parser, FILTER_OPCODE_AND, 0, 0,
+					0, NULL) != 0)
+			return -1;
+	}
+}
+
+
+/* filter_parse_next */
+static int _filter_parse_next(FilterParser * parser)
+{
+	char const * p;
+	size_t i;
+	size_t len;
+
+	g_free(parser->text);
+	parser->text = NULL;
+	for(p = parser->p; *p == ' ' || *p == '\t' || *p == '\n'; p++);
+	parser->position = p;
+	if(*p == '\0')
+	{
+		parser->token = FILTER_TOKEN_END;
+		parser->p = p;
+		return 0;
+	}
+	if(*p == '(' || *p == ')')
+	{
+		parser->token = (*p == '(') ? FILTER_TOKEN_LPAREN
+			: FILTER_TOKEN_RPAREN;
+		parser->p = p + 1;
+		return 0;
+	}
+	for(i = 0; _filter_operators[i].name != NULL; i++)
+	{
+		len = strlen(_filter_operators[i].name);
+		if(strncmp(p, _filter_operators[i].name, len) != 0)
+			continue;
+		parser->token = FILTER_TOKEN_OPERATOR;
+		parser->operator = _filter_operators[i].operator;
+		parser->p = p + len;
+		return 0;
+	}
+	if(*p == '"')
+	{
+		/* quoted strings, with backslash escapes */
+		parser->token = FILTER_TOKEN_STRING;
+		parser->text = g_malloc(strlen(p));
+		for(i = 0, p++; *p != '"'; p++)
+		{
+			if(*p == '\\' && p[1] != '\0')
+				p++;
+			else if(*p == '\0')
+				return _filter_error(parser,
+						"Unterminated string");
+			parser->text[i++] = *p;
+		}
+		parser->text[i] = '\0';
+		parser->p = p + 1;
+	}
+	else
+	{
+		for(len = 0; p[len] != '\0' && strchr(" \t\n()\"=!<>~",
+					p[len]) == NULL; len++);
+		if(len == 0)
+			return _filter_error(parser, "Unexpected character");
+		parser->token = FILTER_TOKEN_WORD;
+		parser->text = g_strndup(p, len);
+		parser->p = p + len;
+	}
+	return 0;
+}
+
+
+/* filter_parse_not */
+static int _filter_parse_not(FilterParser * parser)
+{
+	int ret;
+
+	if(parser->token != FILTER_TOKEN_WORD
+			|| g_ascii_strcasecmp(parser->text, "not") != 0)
+		return _filter_parse_primary(parser);
+	if(++parser->level > FILTER_DEPTH_MAX)
+		return _filter_error(parser, "Expression too complex");
+	ret = (_filter_parse_next(parser) == 0
+			&& _filter_parse_not(parser) == 0
+			&& _filter_emit(parser, FILTER_OPCODE_NOT, 0, 0, 0,
+				NULL) == 0) ? 0 : -1;
+	parser->level--;
+	return ret;
+}
+
+
+/* filter_parse_or */
+static int _filter_parse_or(FilterParser * parser)
+{
+	if(_filter_parse_and(parser) != 0)
+		return -1;
+	while(parser->token == FILTER_TOKEN_WORD
+			&& g_ascii_strcasecmp(parser->text, "or") == 0)
+		if(_filter_parse_next(parser) != 0
+				|| _filter_parse_and(parser) != 0
+				|| _filter_emit(parser, FILTER_OPCODE_OR, 0, 0,
+					0, NULL) != 0)
+			return -1;
+	return 0;
+}
+
+
+/* filter_parse_primary */
+static int _filter_parse_primary(FilterParser * parser)
+{
+	size_t i;
+	FilterOperator operator;
+
+	if(parser->token == FILTER_TOKEN_LPAREN)
+	{
+		if(++parser->level > FILTER_DEPTH_MAX)
+			return _filter_error(parser, "Expression too complex");
+		if(_filter_parse_next(parser) != 0
+				|| _filter_parse_or(parser) != 0)
+			return -1;
+		if(parser->token != FILTER_TOKEN_RPAREN)
+			return _filter_error(parser, "Missing parenthesis");
+		parser->level--;
+		return _filter_parse_next(parser);
+	}
+	if(parser->token != FILTER_TOKEN_WORD)
+		return _filter_error(parser, "Field expected");
+	for(i = 0; _filter_fields[i].name != NULL; i++)
+		if(g_ascii_strcasecmp(_filter_fields[i].name, parser->text)
+				== 0)
+			break;
+	if(_filter_fields[i].name == NULL)
+		return _filter_error(parser, "Unknown field");
+	if(_filter_parse_next(parser) != 0)
+		return -1;
+	if(parser->token != FILTER_TOKEN_OPERATOR)
+	{
+		/* the boolean fields may be tested on their own */
+		if(_filter_fields[i].type != FILTER_TYPE_BOOLEAN)
+			return _filter_error(parser, "Operator expected");
+		return _filter_emit(parser, FILTER_OPCODE_COMPARE,
+				_filter_fields[i].field, FILTER_OPERATOR_EQ, 1,
+				NULL);
+	}
+	operator = parser->operator;
+	if(_filter_parse_next(parser) != 0)
+		return -1;
+	if(parser->token != FILTER_TOKEN_WORD
+			&& parser->token != FILTER_TOKEN_STRING)
+		return _filter_error(parser, "Value expected");
+	if(_filter_parse_value(parser, _filter_fields[i].field,
+				_filter_fields[i].type, operator) != 0)
+		return -1;
+	return _filter_parse_next(parser);
+}
+
+
+/* filter_parse_value */
+static int _filter_parse_value(FilterParser * parser, FilterField field,
+		FilterType type, FilterOperator operator)
+{
+	char const * text = parser->text;
+	gint64 value;
+	int boolean;
+	time_t date;
+	AuditorPriority priority;
+
+	switch(type)
+	{
+		case FILTER_TYPE_BOOLEAN:
+			if(operator != FILTER_OPERATOR_EQ
+					&& operator != FILTER_OPERATOR_NE)
+				break;
+			if(filter_parse_boolean(text, &boolean) != 0)
+				return _filter_error(parser,
+						"Invalid boolean");
+			value = boolean;
+			return _filter_emit(parser, FILTER_OPCODE_COMPARE,
+					field, operator, value, NULL);
+		case FILTER_TYPE_DATE:
+			if(operator == FILTER_OPERATOR_CONTAINS)
+				break;
+			if(filter_parse_date(text, &date) != 0)
+				return _filter_error(parser, "Invalid date");
+			value = date;
+			return _filter_emit(parser, FILTER_OPCODE_COMPARE,
+					field, operator, value, NULL);
+		case FILTER_TYPE_PRIORITY:
+			if(operator == FILTER_OPERATOR_CONTAINS)
+				break;
+			if(priority_parse(text, &priority) != 0)
+				return _filter_error(parser,
+						"Invalid priority");
+			value = priority;
+			return _filter_emit(parser, FILTER_OPCODE_COMPARE,
+					field, operator, value, NULL);
+		case FILTER_TYPE_STRING:
+			if(operator == FILTER_OPERATOR_CONTAINS)
+				/* matched regardless of the case */
+				return _filter_emit(parser,
+						FILTER_OPCODE_CONTAINS, field,
+						operator, 0, g_utf8_validate(
+							text, -1, NULL)
+						? g_utf8_casefold(text, -1)
+						: g_ascii_strdown(text, -1));
+			if(operator != FILTER_OPERATOR_EQ
+					&& operator != FILTER_OPERATOR_NE)
+				break;
+			return _filter_emit(parser, FILTER_OPCODE_EQUALS,
+					field, operator, 0, g_strdup(text));
+	}
+	return _filter_error(parser, "Invalid operator for this field");
+}
+
+
+/* filter_row_get */
+static gint64 _filter_row_get(FilterRow const * row, FilterField field)
+{
+	switch(field)
+	{
+		case FILTER_FIELD_DONE:
+			return row->done ? 1 : 0;
+		case FILTER_FIELD_START:
+			return row->start;
+		case FILTER_FIELD_END:
+			return row->end;
+		case FILTER_FIELD_PRIORITY:
+			return row->priority;
+		case FILTER_FIELD_TITLE:
+			break;
+	}
+	return 0;
+}
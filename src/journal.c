@@ -0,0 +1,624 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "journal.h"
+
+/* constants */
+#define JOURNAL_MAGIC		"AUDITOR-JOURNAL 1\n"
+#define JOURNAL_COMPACT_MIN	(1024 * 1024)
+#define JOURNAL_ID_MAX		64
+
+
+/* Journal */
+/* private */
+/* types */
+typedef struct _JournalRecord
+{
+	off_t offset;
+	size_t size;
+	size_t length;
+} JournalRecord;
+
+struct _Journal
+{
+	String * filename;
+	int fd;
+	GHashTable * records;
+
+	/* shared with the writer thread */
+	GRecMutex lock;
+
+	/* replay buffer, released after the first enumeration */
+	char * buffer;
+	size_t buffer_size;
+
+	/* accounting */
+	off_t size;
+	off_t live;
+};
+
+
+/* prototypes */
+static int _journal_append(Journal * journal, char op, char const * id,
+		char const * data, size_t size);
+static unsigned long _journal_checksum(char const * id, char const * data,
+		size_t size);
+static int _journal_compact(Journal * journal);
+static int _journal_get(Journal * journal, char const * id, char ** data,
+		size_t * size);
+static void _journal_index(Journal * journal, char op, char const * id,
+		off_t offset, size_t size, size_t length);
+static int _journal_read(int fd, char * buf, size_t size, off_t offset);
+static int _journal_replay(Journal * journal);
+static int _journal_sync_directory(char const * filename);
+
+
+/* public */
+/* functions */
+/* journal_new */
+Journal * journal_new(char const * filename)
+{
+	Journal * journal;
+
+	if((journal = object_new(sizeof(*journal))) == NULL)
+		return NULL;
+	journal->filename = string_new(filename);
+	journal->fd = -1;
+	journal->records = g_hash_table_new_full(g_str_hash, g_str_equal,
+			g_free, g_free);
+	g_rec_mutex_init(&journal->lock);
+	journal->buffer = NULL;
+	journal->buffer_size = 0;
+	journal->size = 0;
+	journal->live = 0;
+	if(journal->filename == NULL || journal->records == NULL)
+	{
+		journal_delete(journal);
+		return NULL;
+	}
+	if((journal->fd = open(filename, O_RDWR | O_CREAT | O_APPEND, 0600))
+			< 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		journal_delete(journal);
+		return NULL;
+	}
+	if(_journal_replay(journal) != 0)
+	{
+		journal_delete(journal);
+		return NULL;
+	}
+	return journal;
+}
+
+
+/* journal_delete */
+void journal_delete(Journal * journal)
+{
+	if(journal->fd >= 0)
+	{
+		if(journal->size >= JOURNAL_COMPACT_MIN
+				&& journal->size > 2 * journal->live)
+			journal_compact(journal);
+		journal_sync(journal);
+		close(journal->fd);
+	}
+	if(journal->records != NULL)
+		g_hash_table_destroy(journal->records);
+	free(journal->buffer);
+	string_delete(journal->filename);
+	g_rec_mutex_clear(&journal->lock);
+	object_delete(journal);
+}
+
+
+/* accessors */
+/* journal_get */
+int journal_get(Journal * journal, char const * id, char ** data,
+		size_t * size)
+{
+	int ret;
+
+	g_rec_mutex_lock(&journal->lock);
+	ret = _journal_get(journal, id, data, size);
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* journal_set */
+int journal_set(Journal * journal, char const * id, char const * data,
+		size_t size)
+{
+	int ret;
+
+	g_rec_mutex_lock(&journal->lock);
+	ret = _journal_append(journal, '+', id, data, size);
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* useful */
+/* journal_compact */
+int journal_compact(Journal * journal)
+{
+	int ret;
+
+	g_rec_mutex_lock(&journal->lock);
+	ret = _journal_compact(journal);
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* journal_foreach */
+int journal_foreach(Journal * journal, JournalForeachCallback callback,
+		void * priv)
+{
+	int ret = 0;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	JournalRecord * record;
+	char * data;
+	size_t size;
+
+	/* the callback must not modify the journal */
+	g_rec_mutex_lock(&journal->lock);
+	g_hash_table_iter_init(&iter, journal->records);
+	while(ret == 0 && g_hash_table_iter_next(&iter, &key, &value))
+	{
+		record = value;
+		if(journal->buffer != NULL
+				&& (size_t)record->offset + record->size
+				<= journal->buffer_size)
+			ret = callback(key, &journal->buffer[record->offset],
+					record->size, priv);
+		else if((ret = _journal_get(journal, key, &data, &size)) == 0)
+		{
+			ret = callback(key, data, size, priv);
+			free(data);
+		}
+	}
+	free(journal->buffer);
+	journal->buffer = NULL;
+	journal->buffer_size = 0;
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* journal_has */
+int journal_has(Journal * journal, char const * id)
+{
+	int ret;
+
+	g_rec_mutex_lock(&journal->lock);
+	ret = (g_hash_table_lookup(journal->records, id) != NULL) ? 1 : 0;
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* journal_is_enabled */
+int journal_is_enabled(char const * filename)
+{
+	char const * p;
+
+	/* otherwise only used once it exists */
+	if((p = getenv("AUDITOR_JOURNAL")) != NULL && p[0] != '\0')
+		return (strcmp(p, "0") != 0) ? 1 : 0;
+	return (access(filename, F_OK) == 0) ? 1 : 0;
+}
+
+
+/* journal_new_id */
+char * journal_new_id(Journal * journal)
+{
+	char const chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+		"abcdefghijklmnopqrstuvwxyz0123456789";
+	char id[] = "task.XXXXXX";
+	size_t i;
+
+	do
+		for(i = sizeof("task.") - 1; id[i] != '\0'; i++)
+			id[i] = chars[g_random_int_range(0, sizeof(chars) - 1)];
+	while(journal_has(journal, id));
+	return strdup(id);
+}
+
+
+/* journal_remove */
+int journal_remove(Journal * journal, char const * id)
+{
+	int ret;
+
+	g_rec_mutex_lock(&journal->lock);
+	if(journal_has(journal, id) == 0)
+		ret = -error_set_code(1, "%s: %s", id, strerror(ENOENT));
+	else
+		ret = _journal_append(journal, '-', id, "", 0);
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* journal_sync */
+int journal_sync(Journal * journal)
+{
+	int ret = 0;
+
+	g_rec_mutex_lock(&journal->lock);
+	if(fsync(journal->fd) != 0)
+		ret = -error_set_code(1, "%s: %s", journal->filename,
+				strerror(errno));
+	g_rec_mutex_unlock(&journal->lock);
+	return ret;
+}
+
+
+/* private */
+/* functions */
+/* journal_append */
+static int _journal_append(Journal * journal, char op, char const * id,
+		char const * data, size_t size)
+{
+	char header[JOURNAL_ID_MAX + 32];
+	int len;
+	struct iovec iov[3];
+	ssize_t res;
+
+	if(id[0] == '\0' || strlen(id) >= JOURNAL_ID_MAX
+			|| strpbrk(id, " \t\n") != NULL)
+		return -error_set_code(1, "%s: %s", id, strerror(EINVAL));
+	len = snprintf(header, sizeof(header), "%c %s %lu %08lx\n", op, id,
+			(unsigned long)size, _journal_checksum(id, data, size));
+	iov[0].iov_base = header;
+	iov[0].iov_len = len;
+	iov[1].iov_base = (char *)data;
+	iov[1].iov_len = size;
+	iov[2].iov_base = "\n";
+	iov[2].iov_len = 1;
+	if((res = writev(journal->fd, iov, 3)) != (ssize_t)(len + size + 1))
+	{
+		error_set_code(1, "%s: %s", journal->filename,
+				(res < 0) ? strerror(errno) : "Short write");
+		/* do not leave a torn record behind */
+		if(res > 0 && ftruncate(journal->fd, journal->size) != 0)
+			return -error_set_code(1, "%s: %s",
+					journal->filename, strerror(errno));
+		return -1;
+	}
+	_journal_index(journal, op, id, journal->size + len, size,
+			len + size + 1);
+	journal->size += len + size + 1;
+	/* the record is kept even if the compaction fails */
+	if(journal->size >= JOURNAL_COMPACT_MIN
+			&& journal->size > 2 * journal->live)
+		return _journal_compact(journal);
+	return 0;
+}
+
+
+/* journal_checksum */
+static unsigned long _journal_checksum(char const * id, char const * data,
+		size_t size)
+{
+	uint32_t hash = 2166136261u;
+	size_t i;
+
+	for(i = 0; id[i] != '\0'; i++)
+		hash = (hash ^ (unsigned char)id[i]) * 16777619u;
+	hash *= 16777619u;
+	for(i = 0; i < size; i++)
+		hash = (hash ^ (unsigned char)data[i]) * 16777619u;
+	return hash;
+}
+
+
+/* journal_compact */
+static int _journal_compact(Journal * journal)
+{
+	int ret = 0;
+	String * filename;
+	int fd;
+	GHashTableIter iter;
+	gpointer key;
+	gpointer value;
+	JournalRecord * record;
+	GArray * records;
+	JournalRecord r;
+	off_t offset;
+	char * data;
+	size_t size;
+	char header[JOURNAL_ID_MAX + 32];
+	int len;
+	struct iovec iov[3];
+	guint i;
+
+	if((filename = string_new_append(journal->filename, ".tmp", NULL))
+			== NULL)
+		return -1;
+	if((fd = open(filename, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0600))
+			< 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		string_delete(filename);
+		return -1;
+	}
+	records = g_array_new(FALSE, FALSE, sizeof(r));
+	offset = sizeof(JOURNAL_MAGIC) - 1;
+	if(write(fd, JOURNAL_MAGIC, offset) != offset)
+		ret = -error_set_code(1, "%s: %s", filename,
+				strerror(errno));
+	g_hash_table_iter_init(&iter, journal->records);
+	while(ret == 0 && g_hash_table_iter_next(&iter, &key, &value))
+	{
+		if((ret = _journal_get(journal, key, &data, &size)) != 0)
+			break;
+		len = snprintf(header, sizeof(header), "+ %s %lu %08lx\n",
+				(char const *)key, (unsigned long)size,
+				_journal_checksum(key, data, size));
+		iov[0].iov_base = header;
+		iov[0].iov_len = len;
+		iov[1].iov_base = data;
+		iov[1].iov_len = size;
+		iov[2].iov_base = "\n";
+		iov[2].iov_len = 1;
+		if(writev(fd, iov, 3) != (ssize_t)(len + size + 1))
+			ret = -error_set_code(1, "%s: %s", filename,
+					strerror(errno));
+		free(data);
+		r.offset = offset + len;
+		r.size = size;
+		r.length = len + size + 1;
+		g_array_append_val(records, r);
+		offset += r.length;
+	}
+	if(ret == 0 && fsync(fd) != 0)
+		ret = -error_set_code(1, "%s: %s", filename,
+				strerror(errno));
+	if(ret == 0 && rename(filename, journal->filename) != 0)
+		ret = -error_set_code(1, "%s: %s", journal->filename,
+				strerror(errno));
+	if(ret != 0)
+	{
+		close(fd);
+		unlink(filename);
+		g_array_free(records, TRUE);
+		string_delete(filename);
+		return ret;
+	}
+	/* the hash table was not modified, so it iterates in the same order */
+	g_hash_table_iter_init(&iter, journal->records);
+	for(i = 0; g_hash_table_iter_next(&iter, &key, &value); i++)
+	{
+		record = value;
+		*record = g_array_index(records, JournalRecord, i);
+	}
+	close(journal->fd);
+	journal->fd = fd;
+	free(journal->buffer);
+	journal->buffer = NULL;
+	journal->buffer_size = 0;
+	journal->size = offset;
+	journal->live = offset - (sizeof(JOURNAL_MAGIC) - 1);
+	g_array_free(records, TRUE);
+	string_delete(filename);
+	/* the new file only replaces the former once its directory is synced */
+	return _journal_sync_directory(journal->filename);
+}
+
+
+/* journal_get */
+static int _journal_get(Journal * journal, char const * id, char ** data,
+		size_t * size)
+{
+	JournalRecord * record;
+	char * p;
+
+	if((record = g_hash_table_lookup(journal->records, id)) == NULL)
+		return -error_set_code(1, "%s: %s", id, strerror(ENOENT));
+	if((p = malloc(record->size + 1)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	if(journal->buffer != NULL
+			&& (size_t)record->offset + record->size
+			<= journal->buffer_size)
+		memcpy(p, &journal->buffer[record->offset], record->size);
+	else if(_journal_read(journal->fd, p, record->size, record->offset)
+			!= 0)
+	{
+		error_set_code(1, "%s: %s", journal->filename,
+				error_get(NULL));
+		free(p);
+		return -1;
+	}
+	p[record->size] = '\0';
+	*data = p;
+	*size = record->size;
+	return 0;
+}
+
+
+/* journal_index */
+static void _journal_index(Journal * journal, char op, char const * id,
+		off_t offset, size_t size, size_t length)
+{
+	JournalRecord * record;
+
+	if((record = g_hash_table_lookup(journal->records, id)) != NULL)
+	{
+		journal->live -= record->length;
+		if(op == '-')
+		{
+			g_hash_table_remove(journal->records, id);
+			return;
+		}
+	}
+	else if(op == '-')
+		return;
+	else
+	{
+		record = g_new(JournalRecord, 1);
+		g_hash_table_insert(journal->records, g_strdup(id), record);
+	}
+	record->offset = offset;
+	record->size = size;
+	record->length = length;
+	journal->live += length;
+}
+
+
+/* journal_read */
+static int _journal_read(int fd, char * buf, size_t size, off_t offset)
+{
+	ssize_t res;
+
+	while(size > 0)
+	{
+		if((res = pread(fd, buf, size, offset)) < 0 && errno == EINTR)
+			continue;
+		if(res <= 0)
+			return -error_set_code(1, "%s", (res < 0)
+					? strerror(errno) : "Unexpected EOF");
+		buf += res;
+		size -= res;
+		offset += res;
+	}
+	return 0;
+}
+
+
+/* journal_replay */
+static size_t _replay_record(Journal * journal, char const * buf, size_t len,
+		size_t pos);
+
+static int _journal_replay(Journal * journal)
+{
+	struct stat st;
+	size_t len;
+	size_t pos;
+	size_t res;
+
+	if(fstat(journal->fd, &st) != 0)
+		return -error_set_code(1, "%s: %s", journal->filename,
+				strerror(errno));
+	if(st.st_size == 0)
+	{
+		len = sizeof(JOURNAL_MAGIC) - 1;
+		if(write(journal->fd, JOURNAL_MAGIC, len) != (ssize_t)len)
+			return -error_set_code(1, "%s: %s",
+					journal->filename, strerror(errno));
+		journal->size = len;
+		return 0;
+	}
+	/* read everything at once, the records are looked up from memory */
+	len = st.st_size;
+	if((journal->buffer = malloc(len)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	journal->buffer_size = len;
+	if(_journal_read(journal->fd, journal->buffer, len, 0) != 0)
+		return -error_set_code(1, "%s: %s", journal->filename,
+				error_get(NULL));
+	if(len < sizeof(JOURNAL_MAGIC) - 1 || memcmp(journal->buffer,
+				JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC) - 1) != 0)
+		return -error_set_code(1, "%s: %s", journal->filename,
+				"Not a journal file");
+	for(pos = sizeof(JOURNAL_MAGIC) - 1; pos < len; pos += res)
+		if((res = _replay_record(journal, journal->buffer, len, pos))
+				== 0)
+			break;
+	/* discard any incomplete or corrupted trailing record */
+	if(pos < len && ftruncate(journal->fd, pos) != 0)
+		return -error_set_code(1, "%s: %s", journal->filename,
+				strerror(errno));
+	journal->size = pos;
+	return 0;
+}
+
+static size_t _replay_record(Journal * journal, char const * buf, size_t len,
+		size_t pos)
+{
+	char const * p = &buf[pos];
+	char const * eol;
+	char line[JOURNAL_ID_MAX + 32];
+	char op;
+	char id[JOURNAL_ID_MAX];
+	unsigned long size;
+	unsigned long checksum;
+	size_t hlen;
+
+	if((eol = memchr(p, '\n', len - pos)) == NULL
+			|| (hlen = eol - p + 1) >= sizeof(line))
+		return 0;
+	memcpy(line, p, hlen);
+	line[hlen] = '\0';
+	if(sscanf(line, "%c %63s %lu %lx\n", &op, id, &size, &checksum) != 4
+			|| (op != '+' && op != '-'))
+		return 0;
+	if(size > len - pos - hlen || pos + hlen + size >= len
+			|| buf[pos + hlen + size] != '\n'
+			|| _journal_checksum(id, &buf[pos + hlen], size)
+			!= checksum)
+		return 0;
+	_journal_index(journal, op, id, pos + hlen, size, hlen + size + 1);
+	return hlen + size + 1;
+}
+
+
+/* journal_sync_directory */
+static int _journal_sync_directory(char const * filename)
+{
+	int ret = 0;
+	gchar * directory;
+	int fd;
+
+	directory = g_path_get_dirname(filename);
+	if((fd = open(directory, O_RDONLY)) < 0 || fsync(fd) != 0)
+		ret = -error_set_code(1, "%s: %s", directory,
+				strerror(errno));
+	if(fd >= 0)
+		close(fd);
+	g_free(directory);
+	return ret;
+}
@@ -0,0 +1,68 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#ifndef AUDITOR_JOURNAL_H
+# define AUDITOR_JOURNAL_H
+
+# include <sys/types.h>
+
+
+/* Journal */
+/* types */
+typedef struct _Journal Journal;
+
+typedef int (*JournalForeachCallback)(char const * id, char const * data,
+		size_t size, void * priv);
+
+
+/* functions */
+Journal * journal_new(char const * filename);
+void journal_delete(Journal * journal);
+
+
+/* accessors */
+int journal_get(Journal * journal, char const * id, char ** data,
+		size_t * size);
+int journal_set(Journal * journal, char const * id, char const * data,
+		size_t size);
+
+
+/* useful */
+int journal_compact(Journal * journal);
+int journal_foreach(Journal * journal, JournalForeachCallback callback,
+		void * priv);
+int journal_has(Journal * journal, char const * id);
+int journal_is_enabled(char const * filename);
+char * journal_new_id(Journal * journal);
+int journal_remove(Journal * journal, char const * id);
+int journal_sync(Journal * journal);
+
+#endif /* !AUDITOR_JOURNAL_H */
@@ -0,0 +1,253 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "search.h"
+#include "trace.h"
+#include "loader.h"
+
+
+/* Loader */
+/* private */
+/* types */
+typedef struct _LoaderResult
+{
+	char * filename;
+	Arena * arena;
+	int keywords;
+	Task * task;
+	char * error;
+} LoaderResult;
+
+struct _Loader
+{
+	unsigned int threads;
+	Arena * arena;
+	int keywords;
+	GThreadPool * pool;
+	GAsyncQueue * results;
+	size_t pending;
+};
+
+
+/* prototypes */
+static void _loader_on_load(gpointer data, gpointer user_data);
+
+
+/* public */
+/* functions */
+/* loader_new */
+Loader * loader_new(unsigned int threads)
+{
+	Loader * loader;
+	GError * error = NULL;
+
+	if((loader = object_new(sizeof(*loader))) == NULL)
+		return NULL;
+	if(threads == 0)
+		threads = g_get_num_processors();
+	loader->threads = threads;
+	loader->arena = NULL;
+	loader->keywords = 0;
+	loader->results = g_async_queue_new();
+	loader->pending = 0;
+	if((loader->pool = g_thread_pool_new(_loader_on_load, loader, threads,
+					FALSE, &error)) == NULL)
+	{
+		error_set_code(1, "%s", error->message);
+		g_error_free(error);
+		g_async_queue_unref(loader->results);
+		object_delete(loader);
+		return NULL;
+	}
+	return loader;
+}
+
+
+/* loader_delete */
+static void _delete_result(Task * task, char const * filename, void * data);
+
+void loader_delete(Loader * loader)
+{
+	/* wait for the jobs already queued */
+	g_thread_pool_free(loader->pool, FALSE, TRUE);
+	loader_collect(loader, loader->pending, 0, _delete_result, NULL);
+	g_async_queue_unref(loader->results);
+	object_delete(loader);
+}
+
+static void _delete_result(Task * task, char const * filename, void * data)
+{
+	(void) filename;
+	(void) data;
+
+	if(task != NULL)
+		task_delete(task);
+}
+
+
+/* accessors */
+/* loader_get_pending */
+size_t loader_get_pending(Loader * loader)
+{
+	return loader->pending;
+}
+
+
+/* loader_get_threads */
+unsigned int loader_get_threads(Loader * loader)
+{
+	return loader->threads;
+}
+
+
+/* loader_set_arena */
+void loader_set_arena(Loader * loader, Arena * arena)
+{
+	loader->arena = arena;
+}
+
+
+/* loader_set_keywords */
+void loader_set_keywords(Loader * loader, int keywords)
+{
+	loader->keywords = keywords ? 1 : 0;
+}
+
+
+/* useful */
+/* loader_push */
+int loader_push(Loader * loader, char const * filename)
+{
+	LoaderResult * result;
+	GError * error = NULL;
+
+	if((result = malloc(sizeof(*result))) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	if((result->filename = strdup(filename)) == NULL)
+	{
+		free(result);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	/* the tasks are allocated from the arena current when queued */
+	result->arena = loader->arena;
+	result->keywords = loader->keywords;
+	result->task = NULL;
+	result->error = NULL;
+	if(g_thread_pool_push(loader->pool, result, &error) != TRUE)
+	{
+		error_set_code(1, "%s", error->message);
+		g_error_free(error);
+		free(result->filename);
+		free(result);
+		return -1;
+	}
+	loader->pending++;
+	return 0;
+}
+
+
+/* loader_collect */
+size_t loader_collect(Loader * loader, size_t count, int wait,
+		LoaderCallback callback, void * data)
+{
+	size_t i;
+	LoaderResult * result;
+
+	for(i = 0; i < count && loader->pending > 0; i++)
+	{
+		/* only block for the first result */
+		if(wait && i == 0)
+			result = g_async_queue_pop(loader->results);
+		else if((result = g_async_queue_try_pop(loader->results))
+				== NULL)
+			break;
+		loader->pending--;
+		/* reported from the main thread */
+		if(result->task == NULL && result->error != NULL)
+			error_set("%s", result->error);
+		else if(result->task == NULL)
+			error_set("%s: %s", result->filename,
+					"Could not load task");
+		callback(result->task, result->filename, data);
+		free(result->error);
+		free(result->filename);
+		free(result);
+	}
+	return i;
+}
+
+
+/* private */
+/* functions */
+/* callbacks */
+/* loader_on_load */
+static int _on_load_keywords(Task * task);
+
+static void _loader_on_load(gpointer data, gpointer user_data)
+{
+	LoaderResult * result = data;
+	Loader * loader = user_data;
+	Task * task;
+
+	trace_set_thread("loader");
+	if((task = task_new_arena(result->arena)) == NULL
+			|| task_set_filename(task, result->filename) != 0
+			|| task_load_header(task) != 0
+			|| (result->keywords && _on_load_keywords(task) != 0))
+	{
+		/* copied right away, as the other threads may fail too */
+		result->error = strdup(error_get(NULL));
+		if(task != NULL)
+			task_delete(task);
+		task = NULL;
+	}
+	result->task = task;
+	g_async_queue_push(loader->results, result);
+}
+
+static int _on_load_keywords(Task * task)
+{
+	int ret;
+	char const * description;
+	char * keywords;
+
+	/* tokenized here rather than read again when indexing */
+	if((description = task_get_description(task)) == NULL)
+		return -1;
+	keywords = search_tokenize(description);
+	ret = task_unload_description(task);
+	if(ret == 0)
+		ret = task_set_keywords(task, keywords);
+	g_free(keywords);
+	return ret;
+}
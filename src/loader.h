@@ -0,0 +1,63 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#ifndef AUDITOR_LOADER_H
+# define AUDITOR_LOADER_H
+
+# include "arena.h"
+# include "task.h"
+
+
+/* Loader */
+/* types */
+typedef struct _Loader Loader;
+
+/* the task is NULL if it could not be loaded, with the error set */
+typedef void (*LoaderCallback)(Task * task, char const * filename,
+		void * data);
+
+
+/* functions */
+Loader * loader_new(unsigned int threads);
+void loader_delete(Loader * loader);
+
+
+/* accessors */
+size_t loader_get_pending(Loader * loader);
+unsigned int loader_get_threads(Loader * loader);
+
+void loader_set_arena(Loader * loader, Arena * arena);
+void loader_set_keywords(Loader * loader, int keywords);
+
+
+/* useful */
+int loader_push(Loader * loader, char const * filename);
+size_t loader_collect(Loader * loader, size_t count, int wait,
+		LoaderCallback callback, void * data);
+
+#endif /* !AUDITOR_LOADER_H */
@@ -30,10 +30,14 @@
 
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <locale.h>
 #include <libintl.h>
 #include <gtk/gtk.h>
 #include <System.h>
+#include "cli.h"
+#include "trace.h"
 #include "window.h"
 #include "../config.h"
 #define _(string) gettext(string)
@@ -55,7 +59,8 @@
 
 /* private */
 /* prototypes */
-static int _auditor(void);
+static int _auditor(unsigned int threads, int delay);
+static int _cli(int argc, char * argv[]);
 
 static int _error(char const * message, int ret);
 static int _usage(void);
@@ -63,18 +68,39 @@ static int _usage(void);
 
 /* functions */
 /* auditor */
-static int _auditor(void)
+static int _auditor(unsigned int threads, int delay)
 {
 	AuditorWindow * auditor;
 
 	if((auditor = auditorwindow_new()) == NULL)
 		return error_print(PROGNAME_AUDITOR);
+	auditorwindow_set_threads(auditor, threads);
+	if(delay >= 0)
+		auditorwindow_set_write_delay(auditor, delay);
 	gtk_main();
 	auditorwindow_delete(auditor);
 	return 0;
 }
 
 
+/* cli */
+static int _cli(int argc, char * argv[])
+{
+	int ret;
+	Cli * cli;
+
+	if((cli = cli_new()) == NULL)
+		return error_print(PROGNAME_AUDITOR);
+	if((ret = cli_command(cli, argc, argv)) != 0)
+		error_print(PROGNAME_AUDITOR);
+	/* the changes are written even if some operations failed */
+	if(cli_flush(cli) != 0)
+		ret = error_print(PROGNAME_AUDITOR);
+	cli_delete(cli);
+	return ret;
+}
+
+
 /* error */
 static int _error(char const * message, int ret)
 {
@@ -87,7 +113,24 @@ static int _error(char const * message, int ret)
 /* usage */
 static int _usage(void)
 {
-	fprintf(stderr, _("Usage: %s\n"), PROGNAME_AUDITOR);
+	fprintf(stderr, _("Usage: %s [-j threads][-T filename][-w delay]\n"
+"       %s add title [field=value...]\n"
+"       %s batch [filename]\n"
+"       %s done id...\n"
+"       %s export [format=csv|jsonl|todo.txt][fields=field,...]"
+"[filter=expression]\n"
+"       %s import [format=csv|jsonl|todo.txt][filename]\n"
+"       %s list [filter]\n"
+"       %s memory | --memory-report\n"
+"       %s rm id...\n"
+"       %s set id field=value...\n"
+"  -j	Number of threads used to load tasks (default: one per CPU)\n"
+"  -T	Write a trace of the operations to this file\n"
+"  -w	Delay before writing changes, in milliseconds (default: 500)\n"),
+			PROGNAME_AUDITOR, PROGNAME_AUDITOR, PROGNAME_AUDITOR,
+			PROGNAME_AUDITOR, PROGNAME_AUDITOR, PROGNAME_AUDITOR,
+			PROGNAME_AUDITOR, PROGNAME_AUDITOR, PROGNAME_AUDITOR,
+			PROGNAME_AUDITOR);
 	return 1;
 }
 
@@ -97,20 +140,61 @@ static int _usage(void)
 /* main */
 int main(int argc, char * argv[])
 {
+	int ret;
 	int o;
+	unsigned int threads = 0;
+	int delay = -1;
+	char * p;
+	char * memory[] = { "memory", NULL };
+	char ** cargv;
 
 	if(setlocale(LC_ALL, "") == NULL)
 		_error("setlocale", 1);
 	bindtextdomain(PACKAGE, LOCALEDIR);
 	textdomain(PACKAGE);
+	/* tracing is enabled before any thread is started */
+	if((p = getenv("AUDITOR_TRACE")) != NULL && p[0] != '\0'
+			&& trace_open(p) != 0)
+		error_print(PROGNAME_AUDITOR);
+	/* the commands do not need a display */
+	if(argc == 2 && strcmp(argv[1], "--memory-report") == 0)
+		cargv = memory;
+	else if(argc >= 2 && cli_is_command(argv[1]))
+		cargv = &argv[1];
+	else
+		cargv = NULL;
+	if(cargv != NULL)
+	{
+		ret = _cli((cargv == memory) ? 1 : argc - 1, cargv);
+		if(trace_close() != 0)
+			error_print(PROGNAME_AUDITOR);
+		return (ret == 0) ? 0 : 2;
+	}
 	gtk_init(&argc, &argv);
-	while((o = getopt(argc, argv, "")) != -1)
+	while((o = getopt(argc, argv, "j:T:w:")) != -1)
 		switch(o)
 		{
+			case 'j':
+				threads = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			case 'T':
+				if(trace_open(optarg) != 0)
+					return error_print(PROGNAME_AUDITOR);
+				break;
+			case 'w':
+				delay = strtol(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0' || delay < 0)
+					return _usage();
+				break;
 			default:
 				return _usage();
 		}
 	if(optind != argc)
 		return _usage();
-	return (_auditor() == 0) ? 0 : 2;
+	ret = _auditor(threads, delay);
+	if(trace_close() != 0)
+		error_print(PROGNAME_AUDITOR);
+	return (ret == 0) ? 0 : 2;
 }
@@ -28,7 +28,11 @@
 
 
 
+#include <string.h>
+#include <libintl.h>
+#include <glib.h>
 #include "priority.h"
+#define _(string) gettext(string)
 #define N_(string) (string)
 
 
@@ -42,3 +46,86 @@ AuditorPriorityTitle priorities[] =
 	{ AUDITOR_PRIORITY_URGENT,	N_("Urgent")	},
 	{ 0,				NULL		}
 };
+
+/* private */
+/* variables */
+static char const * _priority_titles[AUDITOR_PRIORITY_COUNT];
+
+
+/* prototypes */
+static void _priority_init(void);
+
+
+/* public */
+/* functions */
+/* priority_get */
+AuditorPriority priority_get(char const * title)
+{
+	size_t i;
+
+	if(title == NULL)
+		return AUDITOR_PRIORITY_UNKNOWN;
+	_priority_init();
+	/* accept the titles in English or in the current locale */
+	for(i = 0; priorities[i].title != NULL; i++)
+		if(strcmp(priorities[i].title, title) == 0
+				|| strcmp(_priority_titles[
+					priorities[i].priority], title) == 0)
+			return priorities[i].priority;
+	return AUDITOR_PRIORITY_UNKNOWN;
+}
+
+
+/* priority_get_title */
+char const * priority_get_title(AuditorPriority priority)
+{
+	_priority_init();
+	if(priority > AUDITOR_PRIORITY_LAST)
+		priority = AUDITOR_PRIORITY_UNKNOWN;
+	return _priority_titles[priority];
+}
+
+
+/* priority_parse */
+int priority_parse(char const * string, AuditorPriority * priority)
+{
+	size_t i;
+	gint64 value;
+	gchar * p;
+
+	_priority_init();
+	/* accept the titles in English or in the current locale regardless
+	 * of the case, or the values directly */
+	for(i = 0; priorities[i].title != NULL; i++)
+		if(g_ascii_strcasecmp(priorities[i].title, string) == 0
+				|| g_ascii_strcasecmp(_priority_titles[
+					priorities[i].priority], string) == 0)
+		{
+			*priority = priorities[i].priority;
+			return 0;
+		}
+	if((value = g_ascii_strtoll(string, &p, 10)) < 0
+			|| value > AUDITOR_PRIORITY_LAST
+			|| string[0] == '\0' || *p != '\0')
+		return -1;
+	*priority = value;
+	return 0;
+}
+
+
+/* private */
+/* functions */
+/* priority_init */
+static void _priority_init(void)
+{
+	static gsize init = 0;
+	size_t i;
+
+	/* translate the titles only once */
+	if(!g_once_init_enter(&init))
+		return;
+	for(i = 0; priorities[i].title != NULL; i++)
+		_priority_titles[priorities[i].priority] = _(
+				priorities[i].title);
+	g_once_init_leave(&init, 1);
+}
@@ -31,10 +31,18 @@
 #ifndef AUDITOR_PRIORITY_H
 # define AUDITOR_PRIORITY_H
 
-# include "auditor.h"
-
-
 /* types */
+typedef enum _AuditorPriority
+{
+	AUDITOR_PRIORITY_UNKNOWN,
+	AUDITOR_PRIORITY_LOW,
+	AUDITOR_PRIORITY_MEDIUM,
+	AUDITOR_PRIORITY_HIGH,
+	AUDITOR_PRIORITY_URGENT
+} AuditorPriority;
+# define AUDITOR_PRIORITY_LAST AUDITOR_PRIORITY_URGENT
+# define AUDITOR_PRIORITY_COUNT (AUDITOR_PRIORITY_LAST + 1)
+
 typedef struct
 {
 	AuditorPriority priority;
@@ -45,4 +53,11 @@ typedef struct
 /* variables */
 extern AuditorPriorityTitle priorities[];
 
+
+/* functions */
+AuditorPriority priority_get(char const * title);
+char const * priority_get_title(AuditorPriority priority);
+
+int priority_parse(char const * string, AuditorPriority * priority);
+
 #endif /* !AUDITOR_PRIORITY_H */
@@ -0,0 +1,711 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "search.h"
+
+/* constants */
+#define SEARCH_MATCH_BITS	32
+/* estimated overhead of each word in the hash table, vocabulary and array */
+#define SEARCH_MEMORY_WORD	96
+
+
+/* Search */
+/* private */
+/* types */
+typedef struct _SearchPosting
+{
+	unsigned int id;
+	unsigned int fields;
+} SearchPosting;
+
+typedef struct _SearchWord
+{
+	char * word;
+	GArray * postings;
+	GSequenceIter * iter;
+} SearchWord;
+
+typedef struct _SearchDocument
+{
+	/* the words of each field, one field after the other */
+	SearchWord ** words;
+	unsigned int count[SEARCH_FIELD_COUNT];
+} SearchDocument;
+
+struct _Search
+{
+	/* words case-folded, also sorted for the prefixes */
+	GHashTable * words;
+	GSequence * vocabulary;
+
+	/* documents by identifier */
+	SearchDocument * documents;
+	size_t documents_size;
+
+	/* memory used, in bytes and entries */
+	size_t words_size;
+	size_t postings;
+	size_t references;
+
+	/* current query */
+	char * query;
+	GPtrArray * terms;
+	guint32 * matches;
+	size_t matches_size;
+};
+
+
+/* prototypes */
+static int _search_document_grow(Search * search, unsigned int id);
+static int _search_document_match(Search * search, unsigned int id);
+static int _search_document_replace(Search * search, unsigned int id,
+		SearchField field, GPtrArray * words);
+
+static int _search_matches_grow(Search * search, size_t size);
+static void _search_matches_set(Search * search, unsigned int id,
+		int match);
+
+static int _search_set(Search * search, unsigned int id, SearchField field,
+		GPtrArray * tokens);
+static GPtrArray * _search_split(char const * words);
+static GPtrArray * _search_tokenize(char const * text);
+
+static SearchWord * _search_word_get(Search * search, char const * word);
+static SearchPosting * _search_word_lookup(SearchWord * word,
+		unsigned int id, guint * position);
+static void _search_word_unset(Search * search, SearchWord * word,
+		unsigned int id, SearchField field);
+
+static gint _search_word_compare(gconstpointer a, gconstpointer b,
+		gpointer data);
+
+
+/* public */
+/* functions */
+/* search_new */
+Search * search_new(void)
+{
+	Search * search;
+
+	if((search = object_new(sizeof(*search))) == NULL)
+		return NULL;
+	search->words = g_hash_table_new(g_str_hash, g_str_equal);
+	search->vocabulary = g_sequence_new(NULL);
+	search->documents = NULL;
+	search->documents_size = 0;
+	search->words_size = 0;
+	search->postings = 0;
+	search->references = 0;
+	search->query = NULL;
+	search->terms = NULL;
+	search->matches = NULL;
+	search->matches_size = 0;
+	return search;
+}
+
+
+/* search_delete */
+void search_delete(Search * search)
+{
+	search_query(search, NULL);
+	search_clear(search);
+	free(search->documents);
+	g_sequence_free(search->vocabulary);
+	g_hash_table_destroy(search->words);
+	free(search->matches);
+	object_delete(search);
+}
+
+
+/* accessors */
+/* search_get_match */
+int search_get_match(Search * search, unsigned int id)
+{
+	if(search->terms == NULL)
+		return 1;
+	if(id / SEARCH_MATCH_BITS >= search->matches_size)
+		return 0;
+	return (search->matches[id / SEARCH_MATCH_BITS]
+			& (1u << (id % SEARCH_MATCH_BITS))) ? 1 : 0;
+}
+
+
+/* search_get_query */
+char const * search_get_query(Search * search)
+{
+	return search->query;
+}
+
+
+/* search_get_size */
+size_t search_get_size(Search * search)
+{
+	size_t words = g_hash_table_size(search->words);
+
+	return sizeof(*search) + words * (sizeof(SearchWord)
+			+ SEARCH_MEMORY_WORD) + search->words_size
+		+ search->postings * sizeof(SearchPosting)
+		+ search->references * sizeof(SearchWord *)
+		+ search->documents_size * sizeof(*search->documents)
+		+ search->matches_size * sizeof(*search->matches);
+}
+
+
+/* search_get_words */
+size_t search_get_words(Search * search)
+{
+	return g_hash_table_size(search->words);
+}
+
+
+/* search_set */
+int search_set(Search * search, unsigned int id, SearchField field,
+		char const * text)
+{
+	return _search_set(search, id, field, (text != NULL)
+			? _search_tokenize(text) : NULL);
+}
+
+
+/* search_set_words */
+int search_set_words(Search * search, unsigned int id, SearchField field,
+		char const * words)
+{
+	return _search_set(search, id, field, (words != NULL)
+			? _search_split(words) : NULL);
+}
+
+
+/* useful */
+/* search_clear */
+void search_clear(Search * search)
+{
+	GSequenceIter * siter;
+	SearchWord * word;
+	size_t i;
+
+	/* faster than removing the documents one at a time */
+	for(i = 0; i < search->documents_size; i++)
+	{
+		free(search->documents[i].words);
+		memset(&search->documents[i], 0, sizeof(search->documents[i]));
+	}
+	g_hash_table_remove_all(search->words);
+	search->words_size = 0;
+	search->postings = 0;
+	search->references = 0;
+	while(!g_sequence_iter_is_end(siter = g_sequence_get_begin_iter(
+					search->vocabulary)))
+	{
+		word = g_sequence_get(siter);
+		g_sequence_remove(siter);
+		g_array_free(word->postings, TRUE);
+		g_free(word->word);
+		g_free(word);
+	}
+	if(search->matches != NULL)
+		memset(search->matches, 0, sizeof(*search->matches)
+				* search->matches_size);
+}
+
+
+/* search_query */
+static void _query_term(Search * search, char const * term, guint32 * matches);
+
+int search_query(Search * search, char const * query)
+{
+	GPtrArray * terms;
+	guint32 * matches;
+	size_t size;
+	size_t i;
+	size_t j;
+
+	free(search->query);
+	search->query = NULL;
+	if(search->terms != NULL)
+		g_ptr_array_free(search->terms, TRUE);
+	search->terms = NULL;
+	/* an empty query matches every document */
+	if(query == NULL || (terms = _search_tokenize(query)) == NULL)
+		return 0;
+	if(terms->len == 0)
+	{
+		g_ptr_array_free(terms, TRUE);
+		return 0;
+	}
+	size = (search->documents_size + SEARCH_MATCH_BITS - 1)
+		/ SEARCH_MATCH_BITS;
+	if(_search_matches_grow(search, size) != 0
+			|| (search->query = strdup(query)) == NULL)
+	{
+		g_ptr_array_free(terms, TRUE);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	if(search->matches_size == 0)
+	{
+		/* no document to match */
+		search->terms = terms;
+		return 0;
+	}
+	if((matches = malloc(sizeof(*matches) * search->matches_size)) == NULL)
+	{
+		free(search->query);
+		search->query = NULL;
+		g_ptr_array_free(terms, TRUE);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	search->terms = terms;
+	/* every term has to match */
+	for(i = 0; i < terms->len; i++)
+	{
+		memset(matches, 0, sizeof(*matches) * search->matches_size);
+		_query_term(search, g_ptr_array_index(terms, i), matches);
+		if(i == 0)
+			memcpy(search->matches, matches, sizeof(*matches)
+					* search->matches_size);
+		else
+			for(j = 0; j < search->matches_size; j++)
+				search->matches[j] &= matches[j];
+	}
+	free(matches);
+	return 0;
+}
+
+static void _query_term(Search * search, char const * term, guint32 * matches)
+{
+	SearchWord w;
+	GSequenceIter * siter;
+	GSequenceIter * prev;
+	SearchWord * word;
+	size_t len;
+	guint i;
+	unsigned int id;
+
+	/* the words starting with the term are contiguous */
+	w.word = (char *)term;
+	siter = g_sequence_search(search->vocabulary, &w, _search_word_compare,
+			NULL);
+	if(!g_sequence_iter_is_begin(siter))
+	{
+		prev = g_sequence_iter_prev(siter);
+		word = g_sequence_get(prev);
+		if(strcmp(word->word, term) == 0)
+			siter = prev;
+	}
+	len = strlen(term);
+	for(; !g_sequence_iter_is_end(siter);
+			siter = g_sequence_iter_next(siter))
+	{
+		word = g_sequence_get(siter);
+		if(strncmp(word->word, term, len) != 0)
+			break;
+		for(i = 0; i < word->postings->len; i++)
+		{
+			id = g_array_index(word->postings, SearchPosting,
+					i).id;
+			matches[id / SEARCH_MATCH_BITS] |= (1u
+					<< (id % SEARCH_MATCH_BITS));
+		}
+	}
+}
+
+
+/* search_remove */
+void search_remove(Search * search, unsigned int id)
+{
+	SearchDocument * document;
+	size_t offset;
+	size_t i;
+	size_t j;
+
+	if(id >= search->documents_size)
+		return;
+	document = &search->documents[id];
+	for(i = 0, offset = 0; i < SEARCH_FIELD_COUNT; i++)
+	{
+		for(j = 0; j < document->count[i]; j++)
+			_search_word_unset(search, document->words[offset + j],
+					id, i);
+		offset += document->count[i];
+		document->count[i] = 0;
+	}
+	search->references -= offset;
+	free(document->words);
+	document->words = NULL;
+	_search_matches_set(search, id, 0);
+}
+
+
+/* search_tokenize */
+char * search_tokenize(char const * text)
+{
+	GPtrArray * tokens;
+	GHashTable * seen;
+	GString * words;
+	char const * token;
+	size_t i;
+
+	/* the words are case-folded and alphanumeric, thus without spaces */
+	tokens = _search_tokenize(text);
+	seen = g_hash_table_new(g_str_hash, g_str_equal);
+	words = g_string_new(NULL);
+	for(i = 0; i < tokens->len; i++)
+	{
+		token = g_ptr_array_index(tokens, i);
+		if(g_hash_table_lookup(seen, token) != NULL)
+			continue;
+		g_hash_table_insert(seen, (gpointer)token, (gpointer)token);
+		if(words->len > 0)
+			g_string_append_c(words, ' ');
+		g_string_append(words, token);
+	}
+	g_hash_table_destroy(seen);
+	g_ptr_array_free(tokens, TRUE);
+	return g_string_free(words, FALSE);
+}
+
+
+/* private */
+/* functions */
+/* search_document_grow */
+static int _search_document_grow(Search * search, unsigned int id)
+{
+	size_t size;
+	SearchDocument * documents;
+
+	if(id < search->documents_size)
+		return 0;
+	for(size = (search->documents_size == 0) ? 256
+			: search->documents_size; size <= id; size *= 2);
+	if((documents = realloc(search->documents, sizeof(*documents) * size))
+			== NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	memset(&documents[search->documents_size], 0, sizeof(*documents)
+			* (size - search->documents_size));
+	search->documents = documents;
+	search->documents_size = size;
+	return 0;
+}
+
+
+/* search_document_match */
+static int _search_document_match(Search * search, unsigned int id)
+{
+	SearchDocument * document = &search->documents[id];
+	char const * term;
+	size_t len;
+	size_t count;
+	size_t i;
+	size_t j;
+
+	if(search->terms == NULL)
+		return 1;
+	for(i = 0, count = 0; i < SEARCH_FIELD_COUNT; i++)
+		count += document->count[i];
+	for(i = 0; i < search->terms->len; i++)
+	{
+		term = g_ptr_array_index(search->terms, i);
+		len = strlen(term);
+		for(j = 0; j < count; j++)
+			if(strncmp(document->words[j]->word, term, len) == 0)
+				break;
+		if(j == count)
+			return 0;
+	}
+	return 1;
+}
+
+
+/* search_document_replace */
+static int _search_document_replace(Search * search, unsigned int id,
+		SearchField field, GPtrArray * words)
+{
+	SearchDocument * document = &search->documents[id];
+	SearchWord ** w = NULL;
+	size_t count;
+	size_t offset;
+	size_t i;
+	size_t j;
+
+	for(i = 0, count = 0; i < SEARCH_FIELD_COUNT; i++)
+		count += (i == field) ? ((words != NULL) ? words->len : 0)
+			: document->count[i];
+	if(count > 0 && (w = malloc(sizeof(*w) * count)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	for(i = 0, offset = 0, count = 0; i < SEARCH_FIELD_COUNT; i++)
+	{
+		if(i != field)
+			for(j = 0; j < document->count[i]; j++)
+				w[count++] = document->words[offset + j];
+		else
+		{
+			/* the words replaced are no longer indexed */
+			for(j = 0; j < document->count[i]; j++)
+				_search_word_unset(search,
+						document->words[offset + j],
+						id, field);
+			for(j = 0; words != NULL && j < words->len; j++)
+				w[count++] = g_ptr_array_index(words, j);
+		}
+		offset += document->count[i];
+	}
+	search->references += count - offset;
+	free(document->words);
+	document->words = w;
+	document->count[field] = (words != NULL) ? words->len : 0;
+	return 0;
+}
+
+
+/* search_matches_grow */
+static int _search_matches_grow(Search * search, size_t size)
+{
+	guint32 * matches;
+
+	if(size <= search->matches_size)
+		return 0;
+	if((matches = realloc(search->matches, sizeof(*matches) * size))
+			== NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	memset(&matches[search->matches_size], 0, sizeof(*matches)
+			* (size - search->matches_size));
+	search->matches = matches;
+	search->matches_size = size;
+	return 0;
+}
+
+
+/* search_matches_set */
+static void _search_matches_set(Search * search, unsigned int id, int match)
+{
+	guint32 bit = 1u << (id % SEARCH_MATCH_BITS);
+
+	/* only relevant while searching */
+	if(search->terms == NULL || _search_matches_grow(search,
+				id / SEARCH_MATCH_BITS + 1) != 0)
+		return;
+	if(match)
+		search->matches[id / SEARCH_MATCH_BITS] |= bit;
+	else
+		search->matches[id / SEARCH_MATCH_BITS] &= ~bit;
+}
+
+
+/* search_set */
+static int _search_set(Search * search, unsigned int id, SearchField field,
+		GPtrArray * tokens)
+{
+	GPtrArray * words;
+	SearchWord * word;
+	SearchPosting posting;
+	SearchPosting * p;
+	guint position;
+	size_t i;
+
+	if(field >= SEARCH_FIELD_COUNT)
+		error_set_code(1, "%s", strerror(EINVAL));
+	if(field >= SEARCH_FIELD_COUNT || _search_document_grow(search, id)
+			!= 0)
+	{
+		if(tokens != NULL)
+			g_ptr_array_free(tokens, TRUE);
+		return -1;
+	}
+	words = g_ptr_array_new();
+	_search_document_replace(search, id, field, words);
+	/* register each word once per field */
+	for(i = 0; tokens != NULL && i < tokens->len; i++)
+	{
+		word = _search_word_get(search, g_ptr_array_index(tokens, i));
+		if((p = _search_word_lookup(word, id, &position)) == NULL)
+		{
+			posting.id = id;
+			posting.fields = 0;
+			g_array_insert_val(word->postings, position, posting);
+			search->postings++;
+			p = &g_array_index(word->postings, SearchPosting,
+					position);
+		}
+		if(p->fields & (1u << field))
+			continue;
+		p->fields |= (1u << field);
+		g_ptr_array_add(words, word);
+	}
+	if(tokens != NULL)
+		g_ptr_array_free(tokens, TRUE);
+	if(_search_document_replace(search, id, field, words) != 0)
+	{
+		for(i = 0; i < words->len; i++)
+			_search_word_unset(search, g_ptr_array_index(words, i),
+					id, field);
+		g_ptr_array_free(words, TRUE);
+		return -1;
+	}
+	g_ptr_array_free(words, TRUE);
+	_search_matches_set(search, id, _search_document_match(search, id));
+	return 0;
+}
+
+
+/* search_split */
+static GPtrArray * _search_split(char const * words)
+{
+	GPtrArray * tokens;
+	char const * p;
+
+	tokens = g_ptr_array_new_with_free_func(g_free);
+	for(; *words != '\0'; words = (*p != '\0') ? p + 1 : p)
+	{
+		if((p = strchr(words, ' ')) == NULL)
+			p = words + strlen(words);
+		if(p > words)
+			g_ptr_array_add(tokens, g_strndup(words, p - words));
+	}
+	return tokens;
+}
+
+
+/* search_tokenize */
+static GPtrArray * _search_tokenize(char const * text)
+{
+	GPtrArray * tokens;
+	char const * end;
+	char const * p;
+	char const * start = NULL;
+
+	/* only the valid part of the text is indexed */
+	g_utf8_validate(text, -1, &end);
+	tokens = g_ptr_array_new_with_free_func(g_free);
+	for(p = text; p < end; p = g_utf8_next_char(p))
+		if(g_unichar_isalnum(g_utf8_get_char(p)))
+		{
+			if(start == NULL)
+				start = p;
+		}
+		else if(start != NULL)
+		{
+			g_ptr_array_add(tokens, g_utf8_casefold(start,
+						p - start));
+			start = NULL;
+		}
+	if(start != NULL)
+		g_ptr_array_add(tokens, g_utf8_casefold(start, p - start));
+	return tokens;
+}
+
+
+/* search_word_get */
+static SearchWord * _search_word_get(Search * search, char const * word)
+{
+	SearchWord * w;
+
+	if((w = g_hash_table_lookup(search->words, word)) != NULL)
+		return w;
+	w = g_new(SearchWord, 1);
+	w->word = g_strdup(word);
+	search->words_size += strlen(word) + 1;
+	w->postings = g_array_new(FALSE, FALSE, sizeof(SearchPosting));
+	w->iter = g_sequence_insert_sorted(search->vocabulary, w,
+			_search_word_compare, NULL);
+	g_hash_table_insert(search->words, w->word, w);
+	return w;
+}
+
+
+/* search_word_lookup */
+static SearchPosting * _search_word_lookup(SearchWord * word,
+		unsigned int id, guint * position)
+{
+	SearchPosting * p;
+	guint low = 0;
+	guint high = word->postings->len;
+	guint middle;
+
+	/* the postings are sorted by document */
+	while(low < high)
+	{
+		middle = low + (high - low) / 2;
+		p = &g_array_index(word->postings, SearchPosting, middle);
+		if(p->id == id)
+		{
+			*position = middle;
+			return p;
+		}
+		if(p->id < id)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	*position = low;
+	return NULL;
+}
+
+
+/* search_word_unset */
+static void _search_word_unset(Search * search, SearchWord * word,
+		unsigned int id, SearchField field)
+{
+	SearchPosting * p;
+	guint position;
+
+	if((p = _search_word_lookup(word, id, &position)) == NULL)
+		return;
+	if((p->fields &= ~(1u << field)) != 0)
+		return;
+	g_array_remove_index(word->postings, position);
+	search->postings--;
+	if(word->postings->len > 0)
+		return;
+	/* the word is no longer used */
+	search->words_size -= strlen(word->word) + 1;
+	g_hash_table_remove(search->words, word->word);
+	g_sequence_remove(word->iter);
+	g_array_free(word->postings, TRUE);
+	g_free(word->word);
+	g_free(word);
+}
+
+
+/* search_word_compare */
+static gint _search_word_compare(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	SearchWord const * wa = a;
+	SearchWord const * wb = b;
+	(void) data;
+
+	return strcmp(wa->word, wb->word);
+}
@@ -0,0 +1,70 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+#ifndef AUDITOR_SEARCH_H
+# define AUDITOR_SEARCH_H
+
+# include <stddef.h>
+
+
+/* Search */
+/* types */
+typedef struct _Search Search;
+
+typedef enum _SearchField
+{
+	SEARCH_FIELD_TITLE = 0,
+	SEARCH_FIELD_DESCRIPTION
+} SearchField;
+# define SEARCH_FIELD_LAST SEARCH_FIELD_DESCRIPTION
+# define SEARCH_FIELD_COUNT (SEARCH_FIELD_LAST + 1)
+
+
+/* functions */
+Search * search_new(void);
+void search_delete(Search * search);
+
+/* accessors */
+int search_get_match(Search * search, unsigned int id);
+char const * search_get_query(Search * search);
+size_t search_get_size(Search * search);
+size_t search_get_words(Search * search);
+
+int search_set(Search * search, unsigned int id, SearchField field,
+		char const * text);
+int search_set_words(Search * search, unsigned int id, SearchField field,
+		char const * words);
+
+/* useful */
+void search_clear(Search * search);
+int search_query(Search * search, char const * query);
+void search_remove(Search * search, unsigned int id);
+char * search_tokenize(char const * text);
+
+#endif /* !AUDITOR_SEARCH_H */
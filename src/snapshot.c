@@ -0,0 +1,343 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "snapshot.h"
+
+/* constants */
+#define SNAPSHOT_MAGIC		"AUDSNAP"
+#define SNAPSHOT_VERSION	2
+
+
+/* Snapshot */
+/* private */
+/* types */
+typedef struct _SnapshotHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t count;
+	int64_t mtime;
+	int64_t mtime_nsec;
+	uint64_t heap;
+	uint64_t heap_size;
+} SnapshotHeader;
+
+typedef struct _SnapshotRecord
+{
+	int64_t mtime;
+	int64_t size;
+	uint32_t filename;
+	uint32_t data;
+	uint32_t data_size;
+	uint32_t mtime_nsec;
+} SnapshotRecord;
+
+struct _Snapshot
+{
+	char * map;
+	size_t size;
+
+	SnapshotHeader const * header;
+	SnapshotRecord const * records;
+	char const * heap;
+	GHashTable * index;
+};
+
+
+/* prototypes */
+static int _snapshot_validate(Snapshot * snapshot, char const * filename);
+
+
+/* public */
+/* functions */
+/* snapshot_new */
+Snapshot * snapshot_new(char const * filename)
+{
+	Snapshot * snapshot;
+	int fd;
+	struct stat st;
+
+	if((fd = open(filename, O_RDONLY)) < 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		return NULL;
+	}
+	if(fstat(fd, &st) != 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		close(fd);
+		return NULL;
+	}
+	if((snapshot = object_new(sizeof(*snapshot))) == NULL)
+	{
+		close(fd);
+		return NULL;
+	}
+	snapshot->size = st.st_size;
+	snapshot->index = NULL;
+	if(snapshot->size < sizeof(*snapshot->header))
+	{
+		error_set_code(1, "%s: %s", filename, "Invalid snapshot");
+		snapshot->map = MAP_FAILED;
+	}
+	else if((snapshot->map = mmap(NULL, snapshot->size, PROT_READ,
+					MAP_PRIVATE, fd, 0)) == MAP_FAILED)
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+	close(fd);
+	if(snapshot->map == MAP_FAILED
+			|| _snapshot_validate(snapshot, filename) != 0)
+	{
+		snapshot_delete(snapshot);
+		return NULL;
+	}
+	return snapshot;
+}
+
+
+/* snapshot_delete */
+void snapshot_delete(Snapshot * snapshot)
+{
+	if(snapshot->index != NULL)
+		g_hash_table_destroy(snapshot->index);
+	if(snapshot->map != MAP_FAILED)
+		munmap(snapshot->map, snapshot->size);
+	object_delete(snapshot);
+}
+
+
+/* accessors */
+/* snapshot_get_count */
+size_t snapshot_get_count(Snapshot * snapshot)
+{
+	return snapshot->header->count;
+}
+
+
+/* snapshot_get_filename */
+char const * snapshot_get_filename(Snapshot * snapshot, size_t i)
+{
+	if(i >= snapshot->header->count)
+		return NULL;
+	return &snapshot->heap[snapshot->records[i].filename];
+}
+
+
+/* snapshot_get_mtime */
+struct timespec snapshot_get_mtime(Snapshot * snapshot)
+{
+	struct timespec ret;
+
+	ret.tv_sec = snapshot->header->mtime;
+	ret.tv_nsec = snapshot->header->mtime_nsec;
+	return ret;
+}
+
+
+/* snapshot_get_task */
+Task * snapshot_get_task(Snapshot * snapshot, size_t i, Arena * arena)
+{
+	SnapshotRecord const * record;
+	Task * task;
+	struct timespec mtime;
+
+	if(i >= snapshot->header->count)
+		return NULL;
+	record = &snapshot->records[i];
+	if((task = task_new_arena(arena)) == NULL)
+		return NULL;
+	if(task_set_filename(task, &snapshot->heap[record->filename]) != 0
+			|| task_load_header_data(task, &snapshot->heap[record->data],
+				record->data_size) != 0)
+	{
+		task_delete(task);
+		return NULL;
+	}
+	/* the header is as current as the record */
+	mtime.tv_sec = record->mtime;
+	mtime.tv_nsec = record->mtime_nsec;
+	task_set_stat(task, &mtime, record->size);
+	return task;
+}
+
+
+/* useful */
+/* snapshot_lookup */
+ssize_t snapshot_lookup(Snapshot * snapshot, char const * filename,
+		struct stat const * st)
+{
+	size_t i;
+	SnapshotRecord const * record;
+
+	if((i = GPOINTER_TO_SIZE(g_hash_table_lookup(snapshot->index,
+						filename))) == 0)
+		return -1;
+	record = &snapshot->records[i - 1];
+	/* only report entries that are still current */
+	if(st != NULL && (record->mtime != (int64_t)st->st_mtim.tv_sec
+				|| record->mtime_nsec
+				!= (uint32_t)st->st_mtim.tv_nsec
+				|| record->size != (int64_t)st->st_size))
+		return -1;
+	return i - 1;
+}
+
+
+/* snapshot_write */
+int snapshot_write(char const * filename, struct stat const * st,
+		Task ** tasks, size_t count)
+{
+	int ret = 0;
+	String * tmp;
+	SnapshotHeader header;
+	SnapshotRecord * records;
+	GString * heap;
+	size_t i;
+	size_t n;
+	struct timespec mtime;
+	off_t size;
+	char const * name;
+	char * data;
+	FILE * fp;
+
+	if((tmp = string_new_append(filename, ".tmp", NULL)) == NULL)
+		return -1;
+	if((records = malloc(sizeof(*records) * (count + 1))) == NULL)
+	{
+		string_delete(tmp);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	heap = g_string_new(NULL);
+	for(i = 0, n = 0; i < count; i++)
+	{
+		/* only the headers known to match their file are kept */
+		if((name = task_get_filename(tasks[i])) == NULL
+				|| task_get_dirty(tasks[i]) != 0
+				|| task_get_stat(tasks[i], &mtime, &size) != 0)
+			continue;
+		if((data = task_save_header_data(tasks[i])) == NULL)
+			continue;
+		records[n].mtime = mtime.tv_sec;
+		records[n].mtime_nsec = mtime.tv_nsec;
+		records[n].size = size;
+		records[n].filename = heap->len;
+		g_string_append_len(heap, name, strlen(name) + 1);
+		records[n].data = heap->len;
+		records[n].data_size = strlen(data);
+		g_string_append_len(heap, data, records[n].data_size + 1);
+		free(data);
+		if(heap->len > UINT32_MAX)
+			break;
+		n++;
+	}
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.version = SNAPSHOT_VERSION;
+	header.count = n;
+	header.mtime = st->st_mtim.tv_sec;
+	header.mtime_nsec = st->st_mtim.tv_nsec;
+	header.heap = sizeof(header) + sizeof(*records) * n;
+	header.heap_size = heap->len;
+	if((fp = fopen(tmp, "w")) == NULL)
+		ret = -error_set_code(1, "%s: %s", tmp, strerror(errno));
+	else if(fwrite(&header, sizeof(header), 1, fp) != 1
+			|| (n > 0 && fwrite(records, sizeof(*records), n, fp)
+				!= n)
+			|| (heap->len > 0 && fwrite(heap->str, heap->len, 1, fp)
+				!= 1)
+			|| fclose(fp) != 0)
+	{
+		ret = -error_set_code(1, "%s: %s", tmp, strerror(errno));
+		unlink(tmp);
+	}
+	else if(rename(tmp, filename) != 0)
+	{
+		ret = -error_set_code(1, "%s: %s", filename,
+				strerror(errno));
+		unlink(tmp);
+	}
+	g_string_free(heap, TRUE);
+	free(records);
+	string_delete(tmp);
+	return ret;
+}
+
+
+/* private */
+/* functions */
+/* snapshot_validate */
+static int _snapshot_validate(Snapshot * snapshot, char const * filename)
+{
+	SnapshotHeader const * header;
+	SnapshotRecord const * record;
+	size_t i;
+
+	snapshot->header = header = (SnapshotHeader const *)snapshot->map;
+	if(memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+			|| header->version != SNAPSHOT_VERSION
+			|| header->heap != sizeof(*header)
+			+ sizeof(*record) * (uint64_t)header->count
+			|| header->heap_size > snapshot->size
+			|| header->heap > snapshot->size - header->heap_size
+			|| (header->heap_size > 0 && snapshot->map[
+				header->heap + header->heap_size - 1] != '\0'))
+		return -error_set_code(1, "%s: %s", filename,
+				"Invalid snapshot");
+	snapshot->records = (SnapshotRecord const *)&snapshot->map[
+		sizeof(*header)];
+	snapshot->heap = &snapshot->map[header->heap];
+	snapshot->index = g_hash_table_new(g_str_hash, g_str_equal);
+	for(i = 0; i < header->count; i++)
+	{
+		record = &snapshot->records[i];
+		if(record->filename >= header->heap_size
+				|| record->data >= header->heap_size
+				|| record->data_size >= header->heap_size
+				- record->data
+				|| snapshot->heap[record->data
+				+ record->data_size] != '\0')
+			return -error_set_code(1, "%s: %s", filename,
+					"Invalid snapshot");
+		g_hash_table_insert(snapshot->index,
+				(gpointer)&snapshot->heap[record->filename],
+				GSIZE_TO_POINTER(i + 1));
+	}
+	return 0;
+}
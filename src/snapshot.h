@@ -0,0 +1,64 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#ifndef AUDITOR_SNAPSHOT_H
+# define AUDITOR_SNAPSHOT_H
+
+# include <sys/types.h>
+# include <sys/stat.h>
+# include "task.h"
+
+
+/* Snapshot */
+/* types */
+typedef struct _Snapshot Snapshot;
+
+
+/* functions */
+Snapshot * snapshot_new(char const * filename);
+void snapshot_delete(Snapshot * snapshot);
+
+
+/* accessors */
+size_t snapshot_get_count(Snapshot * snapshot);
+char const * snapshot_get_filename(Snapshot * snapshot, size_t i);
+struct timespec snapshot_get_mtime(Snapshot * snapshot);
+Task * snapshot_get_task(Snapshot * snapshot, size_t i, Arena * arena);
+
+
+/* useful */
+ssize_t snapshot_lookup(Snapshot * snapshot, char const * filename,
+		struct stat const * st);
+
+int snapshot_write(char const * filename, struct stat const * st,
+		Task ** tasks, size_t count);
+
+#endif /* !AUDITOR_SNAPSHOT_H */
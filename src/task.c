@@ -29,12 +29,21 @@
 
 
 #include <unistd.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <glib.h>
 #include <System.h>
+#include "trace.h"
 #include "task.h"
 
+/* constants */
+/* estimated overhead of the Config object, and of each of its variables */
+#define TASK_MEMORY_CONFIG	96
+#define TASK_MEMORY_VARIABLE	48
+
 
 /* Task */
 /* private */
@@ -44,38 +53,180 @@ struct _Task
 	Config * config;
 
 	/* internal */
+	Arena * arena;
 	char * filename;
+	Journal * journal;
 	String * description;
+	char * keywords;
+	int partial;
+	int dirty;
+
+	/* the file as it was when parsed, if known */
+	struct timespec mtime;
+	off_t size;
+
+	/* the memory accounted for the variables */
+	guint32 memory[TASK_MEMORY_COUNT];
 };
 
+typedef struct _TaskCounters
+{
+	gssize tasks;
+	gssize loads;
+	gssize load_time;
+	gssize saves;
+	gssize save_time;
+	gssize save_last;
+	gssize memory[TASK_MEMORY_COUNT];
+} TaskCounters;
+
+typedef struct _TaskCopyData
+{
+	Task * task;
+	int ret;
+} TaskCopyData;
+
+typedef struct _TaskSaveData
+{
+	String * data;
+	int header;
+} TaskSaveData;
+
 
 /* prototype */
+static int _task_load_data(Task * task, char const * data, size_t size,
+		int header);
+static int _task_load_description(Task * task);
+static int _task_load_priority(Task * task);
+static char * _task_read(Task * task, size_t * size, struct stat * st);
+static char * _task_save_data(Task * task, int header);
+static int _task_sync(char const * filename, int flags);
+
 static int _task_config_get_boolean(Task * task, char const * section,
 		char const * variable);
+static int _task_config_replace(Task * task, char const * variable,
+		char const * value);
+static int _task_config_set(Task * task, char const * section,
+		char const * variable, char const * value);
+
+static void _task_memory_add(TaskMemory field, ssize_t size);
+static void _task_memory_config(Task * task);
+static void _task_memory_reset(Task * task);
+static void _task_memory_update(Task * task,
+		ssize_t memory[TASK_MEMORY_COUNT]);
+static void _task_memory_variable(char const * variable, char const * value,
+		ssize_t memory[TASK_MEMORY_COUNT], int sign);
+static void _task_set_text(Task * task, String * description);
+
+static void _task_stats_add(gssize * counter, gssize value);
+static gint64 _task_stats_begin(void);
+static void _task_stats_load(Task * task, char const * name, gint64 start);
+static void _task_stats_save(Task * task, gint64 start);
+
+
+/* variables */
+/* updated atomically from the loader and writer threads as well */
+static TaskCounters _task_counters;
+static gint _task_stats_timing = 0;
 
 
 /* public */
 /* functions */
+/* task_arena_new */
+Arena * task_arena_new(void)
+{
+	return arena_new(sizeof(Task));
+}
+
+
 /* task_new */
 Task * task_new(void)
+{
+	return task_new_arena(NULL);
+}
+
+
+/* task_new_arena */
+Task * task_new_arena(Arena * arena)
 {
 	Task * task;
 
-	if((task = object_new(sizeof(*task))) == NULL)
+	if(arena == NULL)
+		task = object_new(sizeof(*task));
+	else
+		task = arena_alloc(arena);
+	if(task == NULL)
 		return NULL;
+	task->arena = arena;
 	task->config = config_new();
 	task->filename = NULL;
+	task->journal = NULL;
 	task->description = NULL;
+	task->keywords = NULL;
+	task->partial = 0;
+	task->dirty = 0;
+	task->size = -1;
+	memset(task->memory, 0, sizeof(task->memory));
 	if(task->config == NULL)
 	{
-		task_delete(task);
+		if(arena == NULL)
+			object_delete(task);
+		else
+			arena_free(arena, task);
 		return NULL;
 	}
+	_task_stats_add(&_task_counters.tasks, 1);
+	_task_memory_add(TASK_MEMORY_OBJECT, sizeof(*task)
+			+ TASK_MEMORY_CONFIG);
 	task_set_start(task, time(NULL));
 	return task;
 }
 
 
+/* task_new_copy */
+static void _new_copy_foreach(String const * variable, String const * value,
+		void * data);
+
+Task * task_new_copy(Task * task)
+{
+	Task * copy;
+	TaskCopyData data;
+
+	if((copy = task_new()) == NULL)
+		return NULL;
+	/* without the defaults of a new task */
+	_task_memory_reset(copy);
+	config_reset(copy->config);
+	data.task = copy;
+	data.ret = 0;
+	/* the description is read again when needed, as for the original */
+	config_foreach_section(task->config, "", _new_copy_foreach, &data);
+	_task_memory_config(copy);
+	if(data.ret != 0 || (task->filename != NULL
+				&& task_set_filename(copy, task->filename)
+				!= 0))
+	{
+		task_delete(copy);
+		return NULL;
+	}
+	copy->journal = task->journal;
+	copy->partial = task->partial;
+	copy->dirty = task->dirty;
+	return copy;
+}
+
+static void _new_copy_foreach(String const * variable, String const * value,
+		void * data)
+{
+	TaskCopyData * tcd = data;
+
+	if(tcd->ret != 0 || value == NULL)
+		return;
+	if(config_set(tcd->task->config, NULL, variable, value) != 0)
+		tcd->ret = -1;
+}
+
+
 /* task_new_from_file */
 Task * task_new_from_file(char const * filename)
 {
@@ -96,15 +247,83 @@ Task * task_new_from_file(char const * filename)
 /* task_delete */
 void task_delete(Task * task)
 {
-	string_delete(task->description);
-	free(task->filename);
-	if(task->config != NULL)
+	_task_memory_reset(task);
+	_task_set_text(task, NULL);
+	task_set_keywords(task, NULL);
+	if(task->filename != NULL)
+		_task_memory_add(TASK_MEMORY_FILENAME,
+				-(ssize_t)(strlen(task->filename) + 1));
+	/* the filename is released with the arena */
+	if(task->arena == NULL)
+		free(task->filename);
+	config_delete(task->config);
+	_task_stats_add(&_task_counters.tasks, -1);
+	_task_memory_add(TASK_MEMORY_OBJECT, -(ssize_t)(sizeof(*task)
+				+ TASK_MEMORY_CONFIG));
+	if(task->arena == NULL)
+		object_delete(task);
+	else
+		arena_free(task->arena, task);
+}
+
+
+/* task_delete_all */
+void task_delete_all(Task ** tasks, size_t count, Arena * arena)
+{
+	ssize_t memory[TASK_MEMORY_COUNT];
+	size_t i;
+	size_t j;
+	Task * task;
+
+	/* accounted for once, rather than for every task */
+	memset(memory, 0, sizeof(memory));
+	for(i = 0; i < count; i++)
+	{
+		task = tasks[i];
+		for(j = 0; j < TASK_MEMORY_COUNT; j++)
+			memory[j] += task->memory[j];
+		if(task->description != NULL)
+			memory[TASK_MEMORY_DESCRIPTION_TEXT] += string_get_length(
+					task->description) + 1;
+		string_delete(task->description);
+		if(task->keywords != NULL)
+			memory[TASK_MEMORY_DESCRIPTION_TEXT] += strlen(
+					task->keywords) + 1;
+		free(task->keywords);
+		if(task->filename != NULL)
+			memory[TASK_MEMORY_FILENAME] += strlen(task->filename)
+				+ 1;
+		memory[TASK_MEMORY_OBJECT] += sizeof(*task)
+			+ TASK_MEMORY_CONFIG;
 		config_delete(task->config);
-	object_delete(task);
+		/* the others are released along with their arena */
+		if(task->arena == NULL)
+		{
+			free(task->filename);
+			object_delete(task);
+		}
+	}
+	for(j = 0; j < TASK_MEMORY_COUNT; j++)
+		if(memory[j] != 0)
+			_task_memory_add(j, -memory[j]);
+	_task_stats_add(&_task_counters.tasks, -(gssize)count);
+	if(arena != NULL)
+		arena_delete(arena);
 }
 
 
 /* accessors */
+/* task_get_category */
+char const * task_get_category(Task * task)
+{
+	char const * ret;
+
+	if((ret = config_get(task->config, NULL, "category")) == NULL)
+		return "";
+	return ret;
+}
+
+
 /* task_get_description */
 char const * task_get_description(Task * task)
 {
@@ -113,16 +332,26 @@ char const * task_get_description(Task * task)
 
 	if(task->description != NULL)
 		return task->description;
+	/* only read from the disk when necessary */
+	if(task->partial && _task_load_description(task) != 0)
+		return NULL;
 	if((p = config_get(task->config, NULL, "description")) == NULL)
 		return "";
 	if((q = string_new_replace(p, "\\n", "\n")) == NULL
 			|| string_replace(&q, "\\\\", "\\") != 0)
 		return NULL;
-	task->description = q;
+	_task_set_text(task, q);
 	return task->description;
 }
 
 
+/* task_get_dirty */
+int task_get_dirty(Task * task)
+{
+	return task->dirty;
+}
+
+
 /* task_get_done */
 int task_get_done(Task * task)
 {
@@ -148,13 +377,30 @@ char const * task_get_filename(Task * task)
 }
 
 
+/* task_get_journal */
+Journal * task_get_journal(Task * task)
+{
+	return task->journal;
+}
+
+
+/* task_get_keywords */
+char const * task_get_keywords(Task * task)
+{
+	return task->keywords;
+}
+
+
 /* task_get_priority */
-char const * task_get_priority(Task * task)
+AuditorPriority task_get_priority(Task * task)
 {
-	char const * ret;
+	char const * priority;
+	unsigned long ret;
 
-	if((ret = config_get(task->config, NULL, "priority")) == NULL)
-		return "";
+	if((priority = config_get(task->config, NULL, "priority")) == NULL)
+		return AUDITOR_PRIORITY_UNKNOWN;
+	if((ret = strtoul(priority, NULL, 10)) > AUDITOR_PRIORITY_LAST)
+		return AUDITOR_PRIORITY_UNKNOWN;
 	return ret;
 }
 
@@ -170,6 +416,17 @@ time_t task_get_start(Task * task)
 }
 
 
+/* task_get_stat */
+int task_get_stat(Task * task, struct timespec * mtime, off_t * size)
+{
+	if(task->size < 0)
+		return -1;
+	*mtime = task->mtime;
+	*size = task->size;
+	return 0;
+}
+
+
 /* task_get_title */
 char const * task_get_title(Task * task)
 {
@@ -181,6 +438,15 @@ char const * task_get_title(Task * task)
 }
 
 
+/* task_set_category */
+int task_set_category(Task * task, char const * category)
+{
+	/* the tasks without a category do not store any */
+	return _task_config_set(task, NULL, "category", (category != NULL
+				&& category[0] != '\0') ? category : NULL);
+}
+
+
 /* task_set_description */
 int task_set_description(Task * task, char const * description)
 {
@@ -189,14 +455,25 @@ int task_set_description(Task * task, char const * description)
 	if((d = string_new_replace(description, "\\", "\\\\")) == NULL)
 		return -1;
 	if(string_replace(&d, "\n", "\\n") != 0
-			|| config_set(task->config, NULL, "description", d)
+			|| _task_config_set(task, NULL, "description", d)
 			!= 0)
 	{
 		string_delete(d);
 		return -1;
 	}
-	string_delete(task->description);
-	task->description = d;
+	string_delete(d);
+	/* the description is cached unescaped */
+	_task_set_text(task, string_new(description));
+	task_set_keywords(task, NULL);
+	task->partial = 0;
+	return 0;
+}
+
+
+/* task_set_dirty */
+int task_set_dirty(Task * task, int dirty)
+{
+	task->dirty = dirty ? 1 : 0;
 	return 0;
 }
 
@@ -205,7 +482,7 @@ int task_set_description(Task * task, char const * description)
 int task_set_done(Task * task, int done)
 {
 	task_set_end(task, done ? time(NULL) : 0);
-	return config_set(task->config, NULL, "done", done ? "1" : "0");
+	return _task_config_set(task, NULL, "done", done ? "1" : "0");
 }
 
 
@@ -215,9 +492,9 @@ int task_set_end(Task * task, time_t end)
 	char buf[32];
 
 	if(end == 0)
-		return config_set(task->config, NULL, "end", NULL);
+		return _task_config_set(task, NULL, "end", NULL);
 	snprintf(buf, sizeof(buf), "%lu", (unsigned long)end);
-	return config_set(task->config, NULL, "end", buf);
+	return _task_config_set(task, NULL, "end", buf);
 }
 
 
@@ -226,18 +503,59 @@ int task_set_filename(Task * task, char const * filename)
 {
 	char * p;
 
-	if((p = strdup(filename)) == NULL)
-		return -1; /* XXX set error */
-	free(task->filename);
+	if((p = (task->arena != NULL) ? arena_strdup(task->arena, filename)
+				: strdup(filename)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	_task_memory_add(TASK_MEMORY_FILENAME, (ssize_t)strlen(p)
+			- ((task->filename != NULL)
+				? (ssize_t)strlen(task->filename) : -1));
+	if(task->arena == NULL)
+		free(task->filename);
 	task->filename = p;
+	task->dirty = 1;
+	return 0;
+}
+
+
+/* task_set_journal */
+int task_set_journal(Task * task, Journal * journal)
+{
+	task->journal = journal;
+	return 0;
+}
+
+
+/* task_set_keywords */
+int task_set_keywords(Task * task, char const * keywords)
+{
+	char * p = NULL;
+	ssize_t size = 0;
+
+	/* the words of the description, until indexed */
+	if(keywords != NULL && (p = strdup(keywords)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	if(task->keywords != NULL)
+		size -= strlen(task->keywords) + 1;
+	if(p != NULL)
+		size += strlen(p) + 1;
+	if(size != 0)
+		_task_memory_add(TASK_MEMORY_DESCRIPTION_TEXT, size);
+	free(task->keywords);
+	task->keywords = p;
 	return 0;
 }
 
 
 /* task_set_priority */
-int task_set_priority(Task * task, char const * priority)
+int task_set_priority(Task * task, AuditorPriority priority)
 {
-	return config_set(task->config, NULL, "priority", priority);
+	char buf[16];
+
+	if(priority == AUDITOR_PRIORITY_UNKNOWN
+			|| priority > AUDITOR_PRIORITY_LAST)
+		return _task_config_set(task, NULL, "priority", NULL);
+	snprintf(buf, sizeof(buf), "%u", priority);
+	return _task_config_set(task, NULL, "priority", buf);
 }
 
 
@@ -247,14 +565,27 @@ int task_set_start(Task * task, time_t start)
 	char buf[16];
 
 	snprintf(buf, sizeof(buf), "%lu", (unsigned long)start);
-	return config_set(task->config, NULL, "start", buf);
+	return _task_config_set(task, NULL, "start", buf);
+}
+
+
+/* task_set_stat */
+void task_set_stat(Task * task, struct timespec const * mtime, off_t size)
+{
+	if(mtime == NULL)
+	{
+		task->size = -1;
+		return;
+	}
+	task->mtime = *mtime;
+	task->size = size;
 }
 
 
 /* task_set_title */
 int task_set_title(Task * task, char const * title)
 {
-	return config_set(task->config, NULL, "title", title);
+	return _task_config_set(task, NULL, "title", title);
 }
 
 
@@ -262,17 +593,140 @@ int task_set_title(Task * task, char const * title)
 /* task_load */
 int task_load(Task * task)
 {
-	config_reset(task->config);
-	return config_load(task->config, task->filename);
+	int ret;
+	gint64 start = _task_stats_begin();
+	char * data;
+	size_t size;
+	struct stat st;
+
+	if(task->journal == NULL)
+	{
+		_task_memory_reset(task);
+		config_reset(task->config);
+		_task_set_text(task, NULL);
+		task_set_keywords(task, NULL);
+		task->partial = 0;
+		/* a change after this point is noticed the next time */
+		if(task->filename != NULL && stat(task->filename, &st) == 0)
+			task_set_stat(task, &st.st_mtim, st.st_size);
+		else
+			task_set_stat(task, NULL, 0);
+		ret = config_load(task->config, task->filename);
+		_task_memory_config(task);
+		if(ret == 0)
+		{
+			task->dirty = 0;
+			ret = _task_load_priority(task);
+		}
+		_task_stats_load(task, "task_load", start);
+		return ret;
+	}
+	if((data = _task_read(task, &size, NULL)) == NULL)
+		return -1;
+	ret = task_load_data(task, data, size);
+	free(data);
+	_task_stats_load(task, "task_load", start);
+	return ret;
+}
+
+
+/* task_load_data */
+int task_load_data(Task * task, char const * data, size_t size)
+{
+	return _task_load_data(task, data, size, 0);
+}
+
+
+/* task_load_header */
+int task_load_header(Task * task)
+{
+	int ret;
+	gint64 start = _task_stats_begin();
+	char * data;
+	size_t size;
+	struct stat st;
+
+	if((data = _task_read(task, &size, &st)) == NULL)
+		return -1;
+	ret = task_load_header_data(task, data, size);
+	if(task->journal == NULL)
+		task_set_stat(task, &st.st_mtim, st.st_size);
+	free(data);
+	_task_stats_load(task, "task_load_header", start);
+	return ret;
+}
+
+
+/* task_load_header_data */
+int task_load_header_data(Task * task, char const * data, size_t size)
+{
+	return _task_load_data(task, data, size, 1);
 }
 
 
 /* task_save */
 int task_save(Task * task)
 {
+	int ret;
+	gint64 start = _task_stats_begin();
+	String * data;
+
+	if(task->dirty == 0)
+		return 0;
 	if(task->filename == NULL)
-		return -1; /* XXX set error */
-	return config_save(task->config, task->filename);
+		return -error_set_code(1, "%s", strerror(EINVAL));
+	/* the description would be lost otherwise */
+	if(task->partial && _task_load_description(task) != 0)
+		return -1;
+	if(task->journal == NULL)
+	{
+		/* parsed again the next time rather than trusted */
+		task_set_stat(task, NULL, 0);
+		ret = config_save(task->config, task->filename);
+	}
+	else if((data = task_save_data(task)) == NULL)
+		return -1;
+	else
+	{
+		ret = journal_set(task->journal, task->filename, data,
+				string_get_length(data));
+		string_delete(data);
+	}
+	if(ret == 0)
+		task->dirty = 0;
+	_task_stats_save(task, start);
+	return ret;
+}
+
+
+/* task_save_data */
+char * task_save_data(Task * task)
+{
+	if(task->partial && _task_load_description(task) != 0)
+		return NULL;
+	return _task_save_data(task, 0);
+}
+
+
+/* task_save_header_data */
+char * task_save_header_data(Task * task)
+{
+	return _task_save_data(task, 1);
+}
+
+
+/* task_sync_directory */
+int task_sync_directory(char const * directory)
+{
+	/* the entries of the tasks written or removed */
+	return _task_sync(directory, O_RDONLY);
+}
+
+
+/* task_sync_file */
+int task_sync_file(char const * filename)
+{
+	return _task_sync(filename, O_WRONLY);
 }
 
 
@@ -280,13 +734,310 @@ int task_save(Task * task)
 int task_unlink(Task * task)
 {
 	if(task->filename == NULL)
-		return -1; /* XXX set error */
-	return unlink(task->filename);
+		return -error_set_code(1, "%s", strerror(EINVAL));
+	if(task->journal != NULL)
+		return journal_remove(task->journal, task->filename);
+	if(unlink(task->filename) != 0)
+		return -error_set_code(1, "%s: %s", task->filename,
+				strerror(errno));
+	return 0;
+}
+
+
+/* task_unload_description */
+int task_unload_description(Task * task)
+{
+	_task_set_text(task, NULL);
+	/* keep the changes not saved yet */
+	if(task->partial || task->dirty
+			|| config_get(task->config, NULL, "description")
+			== NULL)
+		return 0;
+	if(_task_config_replace(task, "description", NULL) != 0)
+		return -1;
+	task->partial = 1;
+	return 0;
+}
+
+
+/* statistics */
+/* task_stats_get */
+void task_stats_get(TaskStats * stats)
+{
+	size_t i;
+
+	stats->tasks = (gssize)g_atomic_pointer_get(&_task_counters.tasks);
+	stats->loads = (gssize)g_atomic_pointer_get(&_task_counters.loads);
+	stats->load_time = (gssize)g_atomic_pointer_get(
+			&_task_counters.load_time);
+	stats->saves = (gssize)g_atomic_pointer_get(&_task_counters.saves);
+	stats->save_time = (gssize)g_atomic_pointer_get(
+			&_task_counters.save_time);
+	stats->save_last = (gssize)g_atomic_pointer_get(
+			&_task_counters.save_last);
+	for(i = 0; i < TASK_MEMORY_COUNT; i++)
+		stats->memory[i] = (gssize)g_atomic_pointer_get(
+				&_task_counters.memory[i]);
+}
+
+
+/* task_stats_set_timing */
+void task_stats_set_timing(int timing)
+{
+	/* the loads and saves are only timed when displayed or traced */
+	g_atomic_int_set(&_task_stats_timing, timing ? 1 : 0);
 }
 
 
 /* private */
 /* functions */
+/* task_load_data */
+static int _task_load_data(Task * task, char const * data, size_t size,
+		int header)
+{
+	int ret = 0;
+	char const * end = &data[size];
+	char const * p;
+	char const * eol;
+	char const * eq;
+	String * section = NULL;
+	String * variable;
+	String * value;
+	char const description[] = "description=";
+	ssize_t memory[TASK_MEMORY_COUNT];
+
+	_task_memory_reset(task);
+	memset(memory, 0, sizeof(memory));
+	config_reset(task->config);
+	_task_set_text(task, NULL);
+	task_set_keywords(task, NULL);
+	task->partial = 0;
+	for(p = data; ret == 0 && p < end; p = eol + 1)
+	{
+		if((eol = memchr(p, '\n', end - p)) == NULL)
+			eol = end;
+		if(p == eol || *p == '#')
+			continue;
+		if(*p == '[' && eol[-1] == ']')
+		{
+			string_delete(section);
+			if((section = string_new_length(p + 1, eol - p - 2))
+					== NULL)
+				ret = -1;
+			continue;
+		}
+		if((eq = memchr(p, '=', eol - p)) == NULL)
+			continue;
+		/* the description is only loaded when required */
+		if(header && section == NULL && (size_t)(eol - p)
+				>= sizeof(description) - 1
+				&& strncmp(p, description,
+					sizeof(description) - 1) == 0)
+		{
+			task->partial = 1;
+			continue;
+		}
+		variable = string_new_length(p, eq - p);
+		value = string_new_length(eq + 1, eol - eq - 1);
+		/* accounted while parsing, as a variable may be repeated */
+		if(variable != NULL && section == NULL)
+			_task_memory_variable(variable, config_get(
+						task->config, NULL, variable),
+					memory, -1);
+		if(variable == NULL || value == NULL
+				|| config_set(task->config, section, variable,
+					value) != 0)
+			ret = -1;
+		else if(section == NULL)
+			_task_memory_variable(variable, value, memory, 1);
+		string_delete(variable);
+		string_delete(value);
+	}
+	string_delete(section);
+	_task_memory_update(task, memory);
+	if(ret == 0)
+	{
+		task->dirty = 0;
+		ret = _task_load_priority(task);
+	}
+	return ret;
+}
+
+
+/* task_load_description */
+static int _task_load_description(Task * task)
+{
+	int ret = 0;
+	char * data;
+	size_t size;
+	char const * end;
+	char const * p;
+	char const * eol;
+	int section = 0;
+	char const description[] = "description=";
+	String * value;
+
+	if((data = _task_read(task, &size, NULL)) == NULL)
+		return -1;
+	end = &data[size];
+	for(p = data; p < end; p = eol + 1)
+	{
+		if((eol = memchr(p, '\n', end - p)) == NULL)
+			eol = end;
+		if(p != eol && *p == '[' && eol[-1] == ']')
+			section = 1;
+		if(section || (size_t)(eol - p) < sizeof(description) - 1
+				|| strncmp(p, description,
+					sizeof(description) - 1) != 0)
+			continue;
+		p += sizeof(description) - 1;
+		if((value = string_new_length(p, eol - p)) == NULL
+				|| _task_config_replace(task, "description",
+					value) != 0)
+			ret = -1;
+		string_delete(value);
+		break;
+	}
+	free(data);
+	if(ret == 0)
+		task->partial = 0;
+	return ret;
+}
+
+
+/* task_load_priority */
+static int _task_load_priority(Task * task)
+{
+	char const * priority;
+	AuditorPriority p;
+
+	if((priority = config_get(task->config, NULL, "priority")) == NULL
+			|| (priority[0] >= '0' && priority[0] <= '9'))
+		return 0;
+	/* migrate the former priorities, saved as translated titles */
+	p = priority_get(priority);
+	return task_set_priority(task, p);
+}
+
+
+/* task_read */
+static char * _task_read(Task * task, size_t * size, struct stat * st)
+{
+	char * ret = NULL;
+	FILE * fp;
+	char buf[BUFSIZ];
+	size_t s;
+	char * p;
+
+	if(task->filename == NULL)
+	{
+		error_set_code(1, "%s", strerror(EINVAL));
+		return NULL;
+	}
+	if(task->journal != NULL)
+		return (journal_get(task->journal, task->filename, &ret, size)
+				== 0) ? ret : NULL;
+	if((fp = fopen(task->filename, "r")) == NULL)
+	{
+		error_set_code(1, "%s: %s", task->filename, strerror(errno));
+		return NULL;
+	}
+	/* taken before reading, so that a concurrent change is noticed */
+	if(st != NULL && fstat(fileno(fp), st) != 0)
+	{
+		error_set_code(1, "%s: %s", task->filename, strerror(errno));
+		fclose(fp);
+		return NULL;
+	}
+	for(*size = 0; (s = fread(buf, sizeof(*buf), sizeof(buf), fp)) > 0;
+			*size += s)
+	{
+		if((p = realloc(ret, *size + s + 1)) == NULL)
+		{
+			error_set_code(1, "%s", strerror(errno));
+			free(ret);
+			fclose(fp);
+			return NULL;
+		}
+		ret = p;
+		memcpy(&ret[*size], buf, s);
+	}
+	if(ferror(fp))
+	{
+		error_set_code(1, "%s: %s", task->filename, strerror(errno));
+		free(ret);
+		ret = NULL;
+	}
+	else if(ret == NULL && (ret = malloc(1)) == NULL)
+		error_set_code(1, "%s", strerror(errno));
+	if(ret != NULL)
+		ret[*size] = '\0';
+	fclose(fp);
+	return ret;
+}
+
+
+/* task_save_data */
+static void _save_data_foreach(String const * variable,
+		String const * value, void * data);
+
+static char * _task_save_data(Task * task, int header)
+{
+	TaskSaveData data;
+	String * p;
+
+	if((data.data = string_new("")) == NULL)
+		return NULL;
+	data.header = header;
+	config_foreach_section(task->config, "", _save_data_foreach, &data);
+	if(header == 0 || data.data == NULL)
+		return data.data;
+	/* keep track of the description without its content */
+	if(task->partial || config_get(task->config, NULL, "description")
+			!= NULL)
+	{
+		p = string_new_append(data.data, "description=\n", NULL);
+		string_delete(data.data);
+		data.data = p;
+	}
+	return data.data;
+}
+
+static void _save_data_foreach(String const * variable,
+		String const * value, void * data)
+{
+	TaskSaveData * tsd = data;
+	String * p;
+
+	if(tsd->data == NULL || value == NULL)
+		return;
+	if(tsd->header && strcmp(variable, "description") == 0)
+		return;
+	p = string_new_append(tsd->data, variable, "=", value, "\n", NULL);
+	string_delete(tsd->data);
+	tsd->data = p;
+}
+
+
+/* task_sync */
+static int _task_sync(char const * filename, int flags)
+{
+	int fd;
+
+	if((fd = open(filename, flags)) < 0 || fsync(fd) != 0)
+	{
+		error_set_code(1, "%s: %s", filename, strerror(errno));
+		if(fd >= 0)
+			close(fd);
+		return -1;
+	}
+	if(close(fd) != 0)
+		return -error_set_code(1, "%s: %s", filename,
+				strerror(errno));
+	return 0;
+}
+
+
 /* task_config_get_boolean */
 static int _task_config_get_boolean(Task * task, char const * section,
 		char const * variable)
@@ -302,3 +1053,182 @@ static int _task_config_get_boolean(Task * task, char const * section,
 		return -1;
 	return ret ? 1 : 0;
 }
+
+
+/* task_config_replace */
+static int _task_config_replace(Task * task, char const * variable,
+		char const * value)
+{
+	ssize_t memory[TASK_MEMORY_COUNT];
+
+	memset(memory, 0, sizeof(memory));
+	_task_memory_variable(variable, config_get(task->config, NULL,
+				variable), memory, -1);
+	if(config_set(task->config, NULL, variable, value) != 0)
+		return -1;
+	_task_memory_variable(variable, value, memory, 1);
+	_task_memory_update(task, memory);
+	return 0;
+}
+
+
+/* task_config_set */
+static int _task_config_set(Task * task, char const * section,
+		char const * variable, char const * value)
+{
+	String const * p;
+
+	/* the task is not written again for nothing */
+	if((p = config_get(task->config, section, variable)) == NULL
+			? value == NULL
+			: (value != NULL && strcmp(p, value) == 0))
+		return 0;
+	if(section != NULL)
+	{
+		if(config_set(task->config, section, variable, value) != 0)
+			return -1;
+	}
+	else if(_task_config_replace(task, variable, value) != 0)
+		return -1;
+	task->dirty = 1;
+	return 0;
+}
+
+
+/* task_memory_add */
+static void _task_memory_add(TaskMemory field, ssize_t size)
+{
+	_task_stats_add(&_task_counters.memory[field], size);
+}
+
+
+/* task_memory_config */
+static void _memory_config_foreach(String const * variable,
+		String const * value, void * data);
+
+static void _task_memory_config(Task * task)
+{
+	ssize_t memory[TASK_MEMORY_COUNT];
+
+	/* only the default section is ever used */
+	memset(memory, 0, sizeof(memory));
+	config_foreach_section(task->config, "", _memory_config_foreach,
+			memory);
+	_task_memory_update(task, memory);
+}
+
+static void _memory_config_foreach(String const * variable,
+		String const * value, void * data)
+{
+	ssize_t * memory = data;
+
+	_task_memory_variable(variable, value, memory, 1);
+}
+
+
+/* task_memory_reset */
+static void _task_memory_reset(Task * task)
+{
+	size_t i;
+
+	/* as accounted so far, without walking the variables again */
+	for(i = 0; i < TASK_MEMORY_COUNT; i++)
+		if(task->memory[i] != 0)
+			_task_memory_add(i, -(ssize_t)task->memory[i]);
+	memset(task->memory, 0, sizeof(task->memory));
+}
+
+
+/* task_memory_update */
+static void _task_memory_update(Task * task,
+		ssize_t memory[TASK_MEMORY_COUNT])
+{
+	size_t i;
+
+	for(i = 0; i < TASK_MEMORY_COUNT; i++)
+		if(memory[i] != 0)
+		{
+			task->memory[i] += memory[i];
+			_task_memory_add(i, memory[i]);
+		}
+}
+
+
+/* task_memory_variable */
+static void _task_memory_variable(char const * variable, char const * value,
+		ssize_t memory[TASK_MEMORY_COUNT], int sign)
+{
+	TaskMemory field;
+	ssize_t size;
+
+	if(value == NULL)
+		return;
+	if(strcmp(variable, "title") == 0)
+		field = TASK_MEMORY_TITLE;
+	else if(strcmp(variable, "description") == 0)
+		field = TASK_MEMORY_DESCRIPTION;
+	else
+		field = TASK_MEMORY_OTHER;
+	size = strlen(variable) + 1 + strlen(value) + 1 + TASK_MEMORY_VARIABLE;
+	memory[field] += sign * size;
+}
+
+
+/* task_set_text */
+static void _task_set_text(Task * task, String * description)
+{
+	ssize_t size = 0;
+
+	/* the description unescaped, as cached */
+	if(task->description != NULL)
+		size -= string_get_length(task->description) + 1;
+	if(description != NULL)
+		size += string_get_length(description) + 1;
+	if(size != 0)
+		_task_memory_add(TASK_MEMORY_DESCRIPTION_TEXT, size);
+	string_delete(task->description);
+	task->description = description;
+}
+
+
+/* task_stats_add */
+static void _task_stats_add(gssize * counter, gssize value)
+{
+	g_atomic_pointer_add(counter, value);
+}
+
+
+/* task_stats_begin */
+static gint64 _task_stats_begin(void)
+{
+	/* the clock is only read when measuring */
+	return g_atomic_int_get(&_task_stats_timing)
+		? g_get_monotonic_time() : trace_begin();
+}
+
+
+/* task_stats_load */
+static void _task_stats_load(Task * task, char const * name, gint64 start)
+{
+	_task_stats_add(&_task_counters.loads, 1);
+	if(start == 0)
+		return;
+	_task_stats_add(&_task_counters.load_time, g_get_monotonic_time()
+			- start);
+	trace_end(start, "task", name, task->filename);
+}
+
+
+/* task_stats_save */
+static void _task_stats_save(Task * task, gint64 start)
+{
+	gint64 duration;
+
+	_task_stats_add(&_task_counters.saves, 1);
+	if(start == 0)
+		return;
+	duration = g_get_monotonic_time() - start;
+	_task_stats_add(&_task_counters.save_time, duration);
+	g_atomic_pointer_set(&_task_counters.save_last, (gssize)duration);
+	trace_end(start, "task", "task_save", task->filename);
+}
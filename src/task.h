@@ -31,41 +31,99 @@
 #ifndef AUDITOR_TASK_H
 # define AUDITOR_TASK_H
 
+# include <sys/types.h>
+# include <sys/stat.h>
 # include <time.h>
+# include "arena.h"
+# include "journal.h"
+# include "priority.h"
 
 
 /* Task */
 /* types */
 typedef struct _Task Task;
 
+typedef enum _TaskMemory
+{
+	TASK_MEMORY_OBJECT = 0,
+	TASK_MEMORY_FILENAME,
+	TASK_MEMORY_TITLE,
+	TASK_MEMORY_DESCRIPTION,
+	TASK_MEMORY_DESCRIPTION_TEXT,
+	TASK_MEMORY_OTHER
+} TaskMemory;
+# define TASK_MEMORY_LAST TASK_MEMORY_OTHER
+# define TASK_MEMORY_COUNT (TASK_MEMORY_LAST + 1)
+
+typedef struct _TaskStats
+{
+	unsigned long loads;
+	unsigned long long load_time;	/* in microseconds */
+	unsigned long saves;
+	unsigned long long save_time;	/* in microseconds */
+	unsigned long long save_last;	/* in microseconds */
+
+	/* memory, estimated in bytes */
+	unsigned long tasks;
+	size_t memory[TASK_MEMORY_COUNT];
+} TaskStats;
+
 
 /* functions */
+Arena * task_arena_new(void);
+
 Task * task_new(void);
+Task * task_new_arena(Arena * arena);
+Task * task_new_copy(Task * task);
 Task * task_new_from_file(char const * filename);
 void task_delete(Task * task);
+/* the tasks are from this arena, if any, or were allocated alone */
+void task_delete_all(Task ** tasks, size_t count, Arena * arena);
 
 
 /* accessors */
+char const * task_get_category(Task * task);
 char const * task_get_description(Task * task);
+int task_get_dirty(Task * task);
 int task_get_done(Task * task);
 time_t task_get_end(Task * task);
 char const * task_get_filename(Task * task);
-char const * task_get_priority(Task * task);
+Journal * task_get_journal(Task * task);
+char const * task_get_keywords(Task * task);
+AuditorPriority task_get_priority(Task * task);
 time_t task_get_start(Task * task);
+int task_get_stat(Task * task, struct timespec * mtime, off_t * size);
 char const * task_get_title(Task * task);
 
+int task_set_category(Task * task, char const * category);
 int task_set_description(Task * task, char const * description);
+int task_set_dirty(Task * task, int dirty);
 int task_set_done(Task * task, int done);
 int task_set_end(Task * task, time_t end);
 int task_set_filename(Task * task, char const * filename);
-int task_set_priority(Task * task, char const * priority);
+int task_set_journal(Task * task, Journal * journal);
+int task_set_keywords(Task * task, char const * keywords);
+int task_set_priority(Task * task, AuditorPriority priority);
 int task_set_start(Task * task, time_t start);
+void task_set_stat(Task * task, struct timespec const * mtime, off_t size);
 int task_set_title(Task * task, char const * title);
 
 
 /* useful */
 int task_load(Task * task);
+int task_load_data(Task * task, char const * data, size_t size);
+int task_load_header(Task * task);
+int task_load_header_data(Task * task, char const * data, size_t size);
 int task_save(Task * task);
+char * task_save_data(Task * task);
+char * task_save_header_data(Task * task);
+int task_sync_directory(char const * directory);
+int task_sync_file(char const * filename);
 int task_unlink(Task * task);
+int task_unload_description(Task * task);
+
+/* statistics */
+void task_stats_get(TaskStats * stats);
+void task_stats_set_timing(int timing);
 
 #endif /* !AUDITOR_TASK_H */
@@ -29,6 +29,8 @@
 
 
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
 #include <libintl.h>
 #include <gtk/gtk.h>
 #include <Desktop.h>
@@ -43,7 +45,8 @@
 struct _TaskEdit
 {
 	Auditor * auditor;
-	Task * task;
+	/* looked up again, as the task may be removed meanwhile */
+	char * filename;
 
 	/* widgets */
 	GtkWidget * window;
@@ -68,15 +71,24 @@ TaskEdit * taskedit_new(Auditor * auditor, Task * task)
 	GtkWidget * vbox;
 	GtkWidget * hbox;
 	GtkWidget * widget;
-	GtkWidget * entry;
+	AuditorPriority priority;
 	GtkWidget * bbox;
 	GtkWidget * scrolled;
 	char const * description;
 
+	if(task_get_filename(task) == NULL)
+	{
+		error_set_code(1, "%s", strerror(EINVAL));
+		return NULL;
+	}
 	if((taskedit = malloc(sizeof(*taskedit))) == NULL)
 		return NULL;
 	taskedit->auditor = auditor;
-	taskedit->task = task;
+	if((taskedit->filename = strdup(task_get_filename(task))) == NULL)
+	{
+		free(taskedit);
+		return NULL;
+	}
 	taskedit->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
 	snprintf(buf, sizeof(buf), "%s%s", _("Edit task: "), task_get_title(
 				task));
@@ -111,19 +123,22 @@ TaskEdit * taskedit_new(Auditor * auditor, Task * task)
 	gtk_size_group_add_widget(group, widget);
 	gtk_box_pack_start(GTK_BOX(hbox), widget, FALSE, TRUE, 0);
 #if GTK_CHECK_VERSION(3, 0, 0)
-	taskedit->priority = gtk_combo_box_text_new_with_entry();
+	taskedit->priority = gtk_combo_box_text_new();
 	for(i = 0; priorities[i].title != NULL; i++)
 		gtk_combo_box_text_append_text(GTK_COMBO_BOX_TEXT(
 					taskedit->priority),
-				_(priorities[i].title));
+				priority_get_title(priorities[i].priority));
 #else
-	taskedit->priority = gtk_combo_box_entry_new_text();
+	taskedit->priority = gtk_combo_box_new_text();
 	for(i = 0; priorities[i].title != NULL; i++)
 		gtk_combo_box_append_text(GTK_COMBO_BOX(taskedit->priority),
-				_(priorities[i].title));
+				priority_get_title(priorities[i].priority));
 #endif
-	entry = gtk_bin_get_child(GTK_BIN(taskedit->priority));
-	gtk_entry_set_text(GTK_ENTRY(entry), task_get_priority(task));
+	priority = task_get_priority(task);
+	for(i = 0; priorities[i].title != NULL; i++)
+		if(priorities[i].priority == priority)
+			gtk_combo_box_set_active(GTK_COMBO_BOX(
+						taskedit->priority), i);
 	gtk_box_pack_start(GTK_BOX(hbox), taskedit->priority, TRUE, TRUE, 0);
 	gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, TRUE, 0);
 	/* description */
@@ -145,6 +160,8 @@ TaskEdit * taskedit_new(Auditor * auditor, Task * task)
 		gtk_text_buffer_set_text(gtk_text_view_get_buffer(GTK_TEXT_VIEW(
 						taskedit->description)),
 				description, -1);
+	/* the text buffer holds its own copy */
+	task_unload_description(task);
 	gtk_container_add(GTK_CONTAINER(scrolled), taskedit->description);
 	gtk_box_pack_start(GTK_BOX(vbox), scrolled, TRUE, TRUE, 0);
 	bbox = gtk_button_box_new(GTK_ORIENTATION_HORIZONTAL);
@@ -175,24 +192,33 @@ static void _on_taskedit_cancel(gpointer data)
 static void _on_taskedit_ok(gpointer data)
 {
 	TaskEdit * taskedit = data;
-	GtkWidget * entry;
+	Task * task;
+	gint i;
 	GtkTextBuffer * tbuf;
 	GtkTextIter start;
 	GtkTextIter end;
 	gchar * description;
 	
-	task_set_title(taskedit->task, gtk_entry_get_text(GTK_ENTRY(
-					taskedit->title)));
-	entry = gtk_bin_get_child(GTK_BIN(taskedit->priority));
-	task_set_priority(taskedit->task, gtk_entry_get_text(GTK_ENTRY(entry)));
+	/* the changes are kept in the window if the task is gone */
+	if((task = auditor_task_get(taskedit->auditor, taskedit->filename))
+			== NULL)
+	{
+		auditor_error(NULL, error_get(NULL), 1);
+		return;
+	}
+	task_set_title(task, gtk_entry_get_text(GTK_ENTRY(taskedit->title)));
+	if((i = gtk_combo_box_get_active(GTK_COMBO_BOX(taskedit->priority)))
+			>= 0)
+		task_set_priority(task, priorities[i].priority);
 	tbuf = gtk_text_view_get_buffer(GTK_TEXT_VIEW(taskedit->description));
 	gtk_text_buffer_get_start_iter(tbuf, &start);
 	gtk_text_buffer_get_end_iter(tbuf, &end);
 	description = gtk_text_buffer_get_text(tbuf, &start, &end, FALSE);
-	task_set_description(taskedit->task, description);
+	task_set_description(task, description);
 	g_free(description);
-	task_save(taskedit->task);
-	auditor_task_reload_all(taskedit->auditor); /* XXX violent solution */
+	task_save(task);
+	if(auditor_task_update(taskedit->auditor, task) != 0)
+		auditor_error(NULL, error_get(NULL), 1);
 	_on_taskedit_cancel(taskedit);
 }
 
@@ -201,5 +227,6 @@ static void _on_taskedit_ok(gpointer data)
 void taskedit_delete(TaskEdit * taskedit)
 {
 	gtk_widget_destroy(taskedit->window);
+	free(taskedit->filename);
 	free(taskedit);
 }
@@ -0,0 +1,1564 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <System.h>
+#include "search.h"
+#include "trace.h"
+#include "taskstore.h"
+
+/* constants */
+#define TASKSTORE_BITS		32
+#define TASKSTORE_FILTER_CHUNK	16384
+/* estimated size of each node of the sequences */
+#define TASKSTORE_MEMORY_NODE	48
+
+
+/* TaskStore */
+/* private */
+/* types */
+typedef enum _TaskStoreIndex
+{
+	TASKSTORE_INDEX_ROWS = 0,
+	TASKSTORE_INDEX_DONE,
+	TASKSTORE_INDEX_TITLE,
+	TASKSTORE_INDEX_START,
+	TASKSTORE_INDEX_END,
+	TASKSTORE_INDEX_PRIORITY
+} TaskStoreIndex;
+#define TASKSTORE_INDEX_LAST TASKSTORE_INDEX_PRIORITY
+#define TASKSTORE_INDEX_COUNT (TASKSTORE_INDEX_LAST + 1)
+
+struct _TaskStore
+{
+	GObject parent;
+
+	gint stamp;
+
+	/* rows in the order inserted, then ordered for each sort key */
+	GSequence * indexes[TASKSTORE_INDEX_COUNT];
+	TaskStoreIndex index;
+	gint sort_id;
+	GtkSortType sort_order;
+
+	/* slots as parallel arrays */
+	guint size;
+	guint count;
+	Task ** tasks;
+	guint32 * done;
+	guint done_count;
+	gchar ** titles;
+	size_t titles_size;
+	guint64 * start;
+	guint64 * end;
+	guint8 * priority;
+	guint32 * indexed;
+	guint32 * filtered;
+	GSequenceIter ** iters[TASKSTORE_INDEX_COUNT];
+
+	/* slots available */
+	guint * available;
+	guint available_count;
+
+	/* full-text search, indexed progressively */
+	Search * search;
+	guint indexed_count;
+	guint indexed_slot;
+
+	/* filter, evaluated in parallel over the slots */
+	Filter * filter;
+	guint filtered_count;
+	unsigned int threads;
+
+	/* notifications deferred while frozen */
+	gboolean frozen;
+	gint * frozen_positions;
+	guint32 * frozen_changed;
+};
+
+typedef struct _TaskStoreFilterJob
+{
+	TaskStore * store;
+	guint from;
+	guint to;
+	guint count;
+	GThread * thread;
+} TaskStoreFilterJob;
+
+struct _TaskStoreClass
+{
+	GObjectClass parent_class;
+};
+
+
+/* prototypes */
+static void _taskstore_finalize(GObject * object);
+static void _taskstore_interface_init(GtkTreeModelIface * iface);
+static void _taskstore_sortable_init(GtkTreeSortableIface * iface);
+
+static gboolean _taskstore_get_done(TaskStore * store, guint slot);
+static gboolean _taskstore_get_filtered(TaskStore * store, guint slot);
+static gboolean _taskstore_get_indexed(TaskStore * store, guint slot);
+static GtkTreePath * _taskstore_get_path_slot(TaskStore * store, guint slot);
+static gint _taskstore_get_position(TaskStore * store, guint slot);
+static gint * _taskstore_get_positions(TaskStore * store, gint count);
+static gboolean _taskstore_get_slot_at(TaskStore * store, gint position,
+		guint * slot);
+static gboolean _taskstore_get_slot_next(TaskStore * store, guint slot,
+		guint * next);
+
+static guint _taskstore_filter(TaskStore * store, guint from, guint to);
+
+static void _taskstore_slot_filter(TaskStore * store, guint slot);
+static int _taskstore_slot_index(TaskStore * store, guint slot);
+static gboolean _taskstore_slot_match(TaskStore * store, guint slot);
+static int _taskstore_slot_new(TaskStore * store, guint * slot);
+static void _taskstore_slot_delete(TaskStore * store, guint slot);
+static int _taskstore_slot_set(TaskStore * store, guint slot, Task * task);
+
+static gint _taskstore_compare(gconstpointer a, gconstpointer b,
+		gpointer data, TaskStoreIndex index);
+static gint _taskstore_compare_done(gconstpointer a, gconstpointer b,
+		gpointer data);
+static gint _taskstore_compare_end(gconstpointer a, gconstpointer b,
+		gpointer data);
+static gint _taskstore_compare_priority(gconstpointer a, gconstpointer b,
+		gpointer data);
+static gint _taskstore_compare_start(gconstpointer a, gconstpointer b,
+		gpointer data);
+static gint _taskstore_compare_title(gconstpointer a, gconstpointer b,
+		gpointer data);
+
+/* callbacks */
+static gpointer _taskstore_on_filter(gpointer data);
+
+/* GtkTreeModel */
+static GtkTreeModelFlags _taskstore_get_flags(GtkTreeModel * model);
+static gint _taskstore_get_n_columns(GtkTreeModel * model);
+static GType _taskstore_get_column_type(GtkTreeModel * model, gint index);
+static gboolean _taskstore_get_iter(GtkTreeModel * model, GtkTreeIter * iter,
+		GtkTreePath * path);
+static GtkTreePath * _taskstore_get_path(GtkTreeModel * model,
+		GtkTreeIter * iter);
+static void _taskstore_get_value(GtkTreeModel * model, GtkTreeIter * iter,
+		gint column, GValue * value);
+static gboolean _taskstore_iter_next(GtkTreeModel * model,
+		GtkTreeIter * iter);
+static gboolean _taskstore_iter_children(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * parent);
+static gboolean _taskstore_iter_has_child(GtkTreeModel * model,
+		GtkTreeIter * iter);
+static gint _taskstore_iter_n_children(GtkTreeModel * model,
+		GtkTreeIter * iter);
+static gboolean _taskstore_iter_nth_child(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * parent, gint n);
+static gboolean _taskstore_iter_parent(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * child);
+
+/* GtkTreeSortable */
+static gboolean _taskstore_get_sort_column_id(GtkTreeSortable * sortable,
+		gint * sort_column_id, GtkSortType * order);
+static void _taskstore_set_sort_column_id(GtkTreeSortable * sortable,
+		gint sort_column_id, GtkSortType order);
+static void _taskstore_set_sort_func(GtkTreeSortable * sortable,
+		gint sort_column_id, GtkTreeIterCompareFunc func,
+		gpointer data, GDestroyNotify destroy);
+static void _taskstore_set_default_sort_func(GtkTreeSortable * sortable,
+		GtkTreeIterCompareFunc func, gpointer data,
+		GDestroyNotify destroy);
+static gboolean _taskstore_has_default_sort_func(GtkTreeSortable * sortable);
+
+
+/* constants */
+static const GCompareDataFunc _taskstore_compare_funcs[TASKSTORE_INDEX_COUNT] =
+{
+	NULL,
+	_taskstore_compare_done,
+	_taskstore_compare_title,
+	_taskstore_compare_start,
+	_taskstore_compare_end,
+	_taskstore_compare_priority
+};
+
+
+G_DEFINE_TYPE_WITH_CODE(TaskStore, taskstore, G_TYPE_OBJECT,
+		G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_MODEL,
+			_taskstore_interface_init)
+		G_IMPLEMENT_INTERFACE(GTK_TYPE_TREE_SORTABLE,
+			_taskstore_sortable_init))
+
+
+/* public */
+/* functions */
+/* taskstore_new */
+TaskStore * taskstore_new(void)
+{
+	return g_object_new(TASKSTORE_TYPE, NULL);
+}
+
+
+/* accessors */
+/* taskstore_get_count */
+guint taskstore_get_count(TaskStore * store)
+{
+	return g_sequence_get_length(store->indexes[TASKSTORE_INDEX_ROWS]);
+}
+
+
+/* taskstore_get_count_done */
+guint taskstore_get_count_done(TaskStore * store)
+{
+	return store->done_count;
+}
+
+
+/* taskstore_get_count_filtered */
+guint taskstore_get_count_filtered(TaskStore * store)
+{
+	return (store->filter != NULL) ? store->filtered_count
+		: taskstore_get_count(store);
+}
+
+
+/* taskstore_get_count_indexed */
+guint taskstore_get_count_indexed(TaskStore * store)
+{
+	return store->indexed_count;
+}
+
+
+/* taskstore_get_done */
+gboolean taskstore_get_done(TaskStore * store, GtkTreeIter * iter)
+{
+	g_return_val_if_fail(iter->stamp == store->stamp, FALSE);
+	return _taskstore_get_done(store, GPOINTER_TO_UINT(iter->user_data));
+}
+
+
+/* taskstore_get_filter */
+char const * taskstore_get_filter(TaskStore * store)
+{
+	return (store->filter != NULL) ? filter_get_expression(store->filter)
+		: NULL;
+}
+
+
+/* taskstore_get_memory */
+void taskstore_get_memory(TaskStore * store, TaskStoreMemory * memory)
+{
+	size_t bitmaps = store->size / TASKSTORE_BITS * sizeof(*store->done);
+
+	memory->rows = sizeof(*store) + store->size * (sizeof(*store->tasks)
+			+ sizeof(*store->titles) + sizeof(*store->start)
+			+ sizeof(*store->end) + sizeof(*store->priority)
+			+ sizeof(*store->available) + TASKSTORE_INDEX_COUNT
+			* sizeof(**store->iters)) + bitmaps * 3;
+	memory->indexes = g_sequence_get_length(
+			store->indexes[TASKSTORE_INDEX_ROWS])
+		* TASKSTORE_INDEX_COUNT * TASKSTORE_MEMORY_NODE;
+	memory->titles = store->titles_size;
+	memory->search = (store->search != NULL)
+		? search_get_size(store->search) : 0;
+}
+
+
+/* taskstore_get_filtered */
+gboolean taskstore_get_filtered(TaskStore * store, GtkTreeIter * iter)
+{
+	g_return_val_if_fail(iter->stamp == store->stamp, FALSE);
+	if(store->filter == NULL)
+		return TRUE;
+	return _taskstore_get_filtered(store,
+			GPOINTER_TO_UINT(iter->user_data));
+}
+
+
+/* taskstore_get_match */
+gboolean taskstore_get_match(TaskStore * store, GtkTreeIter * iter)
+{
+	g_return_val_if_fail(iter->stamp == store->stamp, FALSE);
+	if(store->search == NULL)
+		return TRUE;
+	return search_get_match(store->search,
+			GPOINTER_TO_UINT(iter->user_data)) ? TRUE : FALSE;
+}
+
+
+/* taskstore_get_search */
+char const * taskstore_get_search(TaskStore * store)
+{
+	return (store->search != NULL) ? search_get_query(store->search)
+		: NULL;
+}
+
+
+/* taskstore_get_task */
+Task * taskstore_get_task(TaskStore * store, GtkTreeIter * iter)
+{
+	g_return_val_if_fail(iter->stamp == store->stamp, NULL);
+	return store->tasks[GPOINTER_TO_UINT(iter->user_data)];
+}
+
+
+/* taskstore_set */
+int taskstore_set(TaskStore * store, GtkTreeIter * iter, Task * task)
+{
+	guint slot;
+	gint from;
+	gint to;
+	GtkTreePath * path;
+
+	g_return_val_if_fail(iter->stamp == store->stamp, -1);
+	slot = GPOINTER_TO_UINT(iter->user_data);
+	if(store->frozen)
+	{
+		if(_taskstore_slot_set(store, slot, task) != 0)
+			return -1;
+		/* notified all at once when thawed */
+		if(store->frozen_changed != NULL)
+			store->frozen_changed[slot / TASKSTORE_BITS]
+				|= 1u << (slot % TASKSTORE_BITS);
+		return 0;
+	}
+	from = _taskstore_get_position(store, slot);
+	if(_taskstore_slot_set(store, slot, task) != 0)
+		return -1;
+	if((to = _taskstore_get_position(store, slot)) != from)
+	{
+		/* only the row moved is notified, as removed then inserted */
+		path = gtk_tree_path_new_from_indices(from, -1);
+		gtk_tree_model_row_deleted(GTK_TREE_MODEL(store), path);
+		gtk_tree_path_free(path);
+		path = gtk_tree_path_new_from_indices(to, -1);
+		gtk_tree_model_row_inserted(GTK_TREE_MODEL(store), path, iter);
+	}
+	else
+	{
+		path = gtk_tree_path_new_from_indices(to, -1);
+		gtk_tree_model_row_changed(GTK_TREE_MODEL(store), path, iter);
+	}
+	gtk_tree_path_free(path);
+	return 0;
+}
+
+
+/* taskstore_set_filter */
+void taskstore_set_filter(TaskStore * store, Filter * filter)
+{
+	guint words;
+	guint threads;
+	TaskStoreFilterJob * jobs;
+	guint size;
+	guint i;
+	gint64 start;
+
+	if(store->filter != NULL)
+		filter_delete(store->filter);
+	store->filter = filter;
+	store->filtered_count = 0;
+	if(filter == NULL)
+		return;
+	/* split the slots across threads, one word of the bitmap at least */
+	words = (store->count + TASKSTORE_BITS - 1) / TASKSTORE_BITS;
+	threads = (store->threads > 0) ? store->threads
+		: g_get_num_processors();
+	threads = MIN(threads, store->count / TASKSTORE_FILTER_CHUNK);
+	if(threads <= 1 || (jobs = malloc(sizeof(*jobs) * threads)) == NULL)
+	{
+		start = trace_begin();
+		store->filtered_count = _taskstore_filter(store, 0, words);
+		trace_end(start, "taskstore", "filter", NULL);
+		return;
+	}
+	size = (words + threads - 1) / threads;
+	for(i = 0; i < threads; i++)
+	{
+		jobs[i].store = store;
+		jobs[i].from = MIN(i * size, words);
+		jobs[i].to = MIN(jobs[i].from + size, words);
+		jobs[i].count = 0;
+		/* the current thread takes the first range */
+		jobs[i].thread = (i > 0) ? g_thread_try_new("taskstore",
+				_taskstore_on_filter, &jobs[i], NULL) : NULL;
+	}
+	for(i = 0; i < threads; i++)
+	{
+		if(jobs[i].thread != NULL)
+			g_thread_join(jobs[i].thread);
+		else
+			_taskstore_on_filter(&jobs[i]);
+		store->filtered_count += jobs[i].count;
+	}
+	free(jobs);
+}
+
+
+/* taskstore_set_search */
+int taskstore_set_search(TaskStore * store, char const * query)
+{
+	if(store->search == NULL)
+		return -1;
+	/* the filters have to be refreshed accordingly */
+	return search_query(store->search, query);
+}
+
+
+/* taskstore_set_threads */
+void taskstore_set_threads(TaskStore * store, unsigned int threads)
+{
+	store->threads = threads;
+}
+
+
+/* useful */
+/* taskstore_clear */
+void taskstore_clear(TaskStore * store)
+{
+	GtkTreeIter iter;
+	guint slot;
+
+	if(store->search != NULL)
+		search_clear(store->search);
+	while(_taskstore_get_slot_at(store, 0, &slot))
+	{
+		iter.stamp = store->stamp;
+		iter.user_data = GUINT_TO_POINTER(slot);
+		taskstore_remove(store, &iter);
+	}
+	/* invalidate the remaining iterators */
+	store->stamp++;
+}
+
+
+/* taskstore_freeze */
+void taskstore_freeze(TaskStore * store)
+{
+	gint count;
+
+	g_return_if_fail(store->frozen == FALSE);
+	/* remember where every row was, to tell where they moved */
+	count = g_sequence_get_length(store->indexes[TASKSTORE_INDEX_ROWS]);
+	store->frozen = TRUE;
+	store->frozen_positions = _taskstore_get_positions(store, count);
+	store->frozen_changed = calloc((store->count + TASKSTORE_BITS - 1)
+			/ TASKSTORE_BITS, sizeof(*store->frozen_changed));
+}
+
+
+/* taskstore_index */
+int taskstore_index(TaskStore * store, guint count)
+{
+	guint slot;
+	GtkTreeIter iter;
+	GtkTreePath * path;
+
+	if(store->search == NULL)
+		return 0;
+	for(slot = store->indexed_slot; slot < store->count && count > 0;
+			slot++)
+	{
+		if(store->iters[TASKSTORE_INDEX_ROWS][slot] == NULL
+				|| _taskstore_get_indexed(store, slot))
+			continue;
+		if(_taskstore_slot_index(store, slot) != 0)
+		{
+			/* skipped, the task only matches once reindexed */
+			store->indexed_slot = slot + 1;
+			return -1;
+		}
+		count--;
+		/* the row may now match the current search */
+		if(search_get_query(store->search) == NULL)
+			continue;
+		iter.stamp = store->stamp;
+		iter.user_data = GUINT_TO_POINTER(slot);
+		path = _taskstore_get_path_slot(store, slot);
+		gtk_tree_model_row_changed(GTK_TREE_MODEL(store), path, &iter);
+		gtk_tree_path_free(path);
+	}
+	store->indexed_slot = slot;
+	return (slot < store->count) ? 1 : 0;
+}
+
+
+/* taskstore_insert */
+int taskstore_insert(TaskStore * store, GtkTreeIter * iter, gint position,
+		Task * task)
+{
+	guint slot;
+	GSequence * rows = store->indexes[TASKSTORE_INDEX_ROWS];
+	GSequenceIter * siter;
+	size_t i;
+	GtkTreePath * path;
+
+	iter->stamp = 0;
+	g_return_val_if_fail(store->frozen == FALSE, -1);
+	if(_taskstore_slot_new(store, &slot) != 0)
+		return -error_set_code(1, "%s", strerror(errno));
+	if(_taskstore_slot_set(store, slot, task) != 0)
+	{
+		_taskstore_slot_delete(store, slot);
+		return -1;
+	}
+	siter = (position < 0 || position >= g_sequence_get_length(rows))
+		? g_sequence_get_end_iter(rows)
+		: g_sequence_get_iter_at_pos(rows, position);
+	store->iters[TASKSTORE_INDEX_ROWS][slot] = g_sequence_insert_before(
+			siter, GUINT_TO_POINTER(slot));
+	for(i = TASKSTORE_INDEX_ROWS + 1; i < TASKSTORE_INDEX_COUNT; i++)
+		store->iters[i][slot] = g_sequence_insert_sorted(
+				store->indexes[i], GUINT_TO_POINTER(slot),
+				_taskstore_compare_funcs[i], store);
+	iter->stamp = store->stamp;
+	iter->user_data = GUINT_TO_POINTER(slot);
+	path = _taskstore_get_path_slot(store, slot);
+	gtk_tree_model_row_inserted(GTK_TREE_MODEL(store), path, iter);
+	gtk_tree_path_free(path);
+	return 0;
+}
+
+
+/* taskstore_reindex */
+int taskstore_reindex(TaskStore * store, GtkTreeIter * iter)
+{
+	guint slot;
+
+	g_return_val_if_fail(iter->stamp == store->stamp, -1);
+	slot = GPOINTER_TO_UINT(iter->user_data);
+	/* otherwise indexed later along with the other tasks */
+	if(!_taskstore_get_indexed(store, slot))
+		return 0;
+	store->indexed[slot / TASKSTORE_BITS] &= ~(1u << (slot
+				% TASKSTORE_BITS));
+	store->indexed_count--;
+	return _taskstore_slot_index(store, slot);
+}
+
+
+/* taskstore_remove */
+gboolean taskstore_remove(TaskStore * store, GtkTreeIter * iter)
+{
+	guint slot;
+	guint next;
+	gboolean ret;
+	GtkTreePath * path;
+	size_t i;
+
+	g_return_val_if_fail(iter->stamp == store->stamp, FALSE);
+	g_return_val_if_fail(store->frozen == FALSE, FALSE);
+	slot = GPOINTER_TO_UINT(iter->user_data);
+	path = _taskstore_get_path_slot(store, slot);
+	ret = _taskstore_get_slot_next(store, slot, &next);
+	for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+		g_sequence_remove(store->iters[i][slot]);
+	_taskstore_slot_delete(store, slot);
+	gtk_tree_model_row_deleted(GTK_TREE_MODEL(store), path);
+	gtk_tree_path_free(path);
+	if(ret != TRUE)
+	{
+		iter->stamp = 0;
+		return FALSE;
+	}
+	iter->user_data = GUINT_TO_POINTER(next);
+	return TRUE;
+}
+
+
+/* taskstore_thaw */
+static int _thaw_reordered(TaskStore * store);
+
+int taskstore_thaw(TaskStore * store)
+{
+	int ret = 0;
+	guint slot;
+	GtkTreeIter iter;
+	GtkTreePath * path;
+
+	g_return_val_if_fail(store->frozen == TRUE, -1);
+	store->frozen = FALSE;
+	if(store->frozen_positions != NULL)
+		ret = _thaw_reordered(store);
+	free(store->frozen_positions);
+	store->frozen_positions = NULL;
+	for(slot = 0; slot < store->count; slot++)
+	{
+		if(store->iters[TASKSTORE_INDEX_ROWS][slot] == NULL)
+			continue;
+		/* without the list of changes every row may have changed */
+		if(store->frozen_changed != NULL
+				&& (store->frozen_changed[slot / TASKSTORE_BITS]
+					& (1u << (slot % TASKSTORE_BITS))) == 0)
+			continue;
+		iter.stamp = store->stamp;
+		iter.user_data = GUINT_TO_POINTER(slot);
+		path = _taskstore_get_path_slot(store, slot);
+		gtk_tree_model_row_changed(GTK_TREE_MODEL(store), path, &iter);
+		gtk_tree_path_free(path);
+	}
+	free(store->frozen_changed);
+	store->frozen_changed = NULL;
+	return ret;
+}
+
+static int _thaw_reordered(TaskStore * store)
+{
+	gint count;
+	gint * reordered;
+	gboolean moved = FALSE;
+	guint slot;
+	gint i;
+	GtkTreePath * path;
+
+	count = g_sequence_get_length(store->indexes[TASKSTORE_INDEX_ROWS]);
+	if((reordered = malloc(sizeof(*reordered) * count)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	for(i = 0; i < count; i++)
+	{
+		_taskstore_get_slot_at(store, i, &slot);
+		if((reordered[i] = store->frozen_positions[slot]) != i)
+			moved = TRUE;
+	}
+	/* a single notification for every row moved */
+	if(moved)
+	{
+		path = gtk_tree_path_new();
+		gtk_tree_model_rows_reordered(GTK_TREE_MODEL(store), path,
+				NULL, reordered);
+		gtk_tree_path_free(path);
+	}
+	free(reordered);
+	return 0;
+}
+
+
+/* private */
+/* functions */
+/* taskstore_class_init */
+static void taskstore_class_init(TaskStoreClass * klass)
+{
+	GObjectClass * object_class = G_OBJECT_CLASS(klass);
+
+	object_class->finalize = _taskstore_finalize;
+}
+
+
+/* taskstore_init */
+static void taskstore_init(TaskStore * store)
+{
+	size_t i;
+
+	store->stamp = g_random_int();
+	for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+	{
+		store->indexes[i] = g_sequence_new(NULL);
+		store->iters[i] = NULL;
+	}
+	store->index = TASKSTORE_INDEX_ROWS;
+	store->sort_id = GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID;
+	store->sort_order = GTK_SORT_ASCENDING;
+	store->size = 0;
+	store->count = 0;
+	store->tasks = NULL;
+	store->done = NULL;
+	store->done_count = 0;
+	store->titles = NULL;
+	store->titles_size = 0;
+	store->start = NULL;
+	store->end = NULL;
+	store->priority = NULL;
+	store->available = NULL;
+	store->available_count = 0;
+	store->indexed = NULL;
+	store->search = search_new();
+	store->indexed_count = 0;
+	store->indexed_slot = 0;
+	store->filtered = NULL;
+	store->filter = NULL;
+	store->filtered_count = 0;
+	store->threads = 0;
+	store->frozen = FALSE;
+	store->frozen_positions = NULL;
+	store->frozen_changed = NULL;
+}
+
+
+/* taskstore_finalize */
+static void _taskstore_finalize(GObject * object)
+{
+	TaskStore * store = TASKSTORE(object);
+	size_t i;
+
+	for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+	{
+		g_sequence_free(store->indexes[i]);
+		free(store->iters[i]);
+	}
+	for(i = 0; i < store->count; i++)
+		g_free(store->titles[i]);
+	free(store->tasks);
+	free(store->done);
+	free(store->titles);
+	free(store->start);
+	free(store->end);
+	free(store->priority);
+	free(store->indexed);
+	free(store->filtered);
+	free(store->available);
+	free(store->frozen_positions);
+	free(store->frozen_changed);
+	if(store->search != NULL)
+		search_delete(store->search);
+	if(store->filter != NULL)
+		filter_delete(store->filter);
+	G_OBJECT_CLASS(taskstore_parent_class)->finalize(object);
+}
+
+
+/* taskstore_interface_init */
+static void _taskstore_interface_init(GtkTreeModelIface * iface)
+{
+	iface->get_flags = _taskstore_get_flags;
+	iface->get_n_columns = _taskstore_get_n_columns;
+	iface->get_column_type = _taskstore_get_column_type;
+	iface->get_iter = _taskstore_get_iter;
+	iface->get_path = _taskstore_get_path;
+	iface->get_value = _taskstore_get_value;
+	iface->iter_next = _taskstore_iter_next;
+	iface->iter_children = _taskstore_iter_children;
+	iface->iter_has_child = _taskstore_iter_has_child;
+	iface->iter_n_children = _taskstore_iter_n_children;
+	iface->iter_nth_child = _taskstore_iter_nth_child;
+	iface->iter_parent = _taskstore_iter_parent;
+}
+
+
+/* taskstore_sortable_init */
+static void _taskstore_sortable_init(GtkTreeSortableIface * iface)
+{
+	iface->get_sort_column_id = _taskstore_get_sort_column_id;
+	iface->set_sort_column_id = _taskstore_set_sort_column_id;
+	iface->set_sort_func = _taskstore_set_sort_func;
+	iface->set_default_sort_func = _taskstore_set_default_sort_func;
+	iface->has_default_sort_func = _taskstore_has_default_sort_func;
+}
+
+
+/* accessors */
+/* taskstore_get_done */
+static gboolean _taskstore_get_done(TaskStore * store, guint slot)
+{
+	return (store->done[slot / TASKSTORE_BITS]
+			& (1u << (slot % TASKSTORE_BITS))) ? TRUE : FALSE;
+}
+
+
+/* taskstore_get_filtered */
+static gboolean _taskstore_get_filtered(TaskStore * store, guint slot)
+{
+	return (store->filtered[slot / TASKSTORE_BITS]
+			& (1u << (slot % TASKSTORE_BITS))) ? TRUE : FALSE;
+}
+
+
+/* taskstore_get_indexed */
+static gboolean _taskstore_get_indexed(TaskStore * store, guint slot)
+{
+	return (store->indexed[slot / TASKSTORE_BITS]
+			& (1u << (slot % TASKSTORE_BITS))) ? TRUE : FALSE;
+}
+
+
+/* taskstore_get_path_slot */
+static GtkTreePath * _taskstore_get_path_slot(TaskStore * store, guint slot)
+{
+	return gtk_tree_path_new_from_indices(_taskstore_get_position(store,
+				slot), -1);
+}
+
+
+/* taskstore_get_position */
+static gint _taskstore_get_position(TaskStore * store, guint slot)
+{
+	gint position;
+
+	position = g_sequence_iter_get_position(
+			store->iters[store->index][slot]);
+	if(store->sort_order == GTK_SORT_DESCENDING)
+		position = g_sequence_get_length(store->indexes[store->index])
+			- 1 - position;
+	return position;
+}
+
+
+/* taskstore_get_positions */
+static gint * _taskstore_get_positions(TaskStore * store, gint count)
+{
+	gint * positions;
+	GSequenceIter * siter;
+	gint i;
+
+	if(count == 0 || (positions = malloc(sizeof(*positions)
+					* store->count)) == NULL)
+		return NULL;
+	/* walk the current order once */
+	siter = g_sequence_get_begin_iter(store->indexes[store->index]);
+	for(i = 0; i < count; i++, siter = g_sequence_iter_next(siter))
+		positions[GPOINTER_TO_UINT(g_sequence_get(siter))]
+			= (store->sort_order == GTK_SORT_DESCENDING)
+			? count - 1 - i : i;
+	return positions;
+}
+
+
+/* taskstore_get_slot_at */
+static gboolean _taskstore_get_slot_at(TaskStore * store, gint position,
+		guint * slot)
+{
+	GSequence * sequence = store->indexes[store->index];
+	gint count;
+
+	count = g_sequence_get_length(sequence);
+	if(position < 0 || position >= count)
+		return FALSE;
+	if(store->sort_order == GTK_SORT_DESCENDING)
+		position = count - 1 - position;
+	*slot = GPOINTER_TO_UINT(g_sequence_get(g_sequence_get_iter_at_pos(
+					sequence, position)));
+	return TRUE;
+}
+
+
+/* taskstore_get_slot_next */
+static gboolean _taskstore_get_slot_next(TaskStore * store, guint slot,
+		guint * next)
+{
+	GSequenceIter * siter = store->iters[store->index][slot];
+
+	if(store->sort_order == GTK_SORT_DESCENDING)
+	{
+		if(g_sequence_iter_is_begin(siter))
+			return FALSE;
+		siter = g_sequence_iter_prev(siter);
+	}
+	else if(g_sequence_iter_is_end(siter = g_sequence_iter_next(siter)))
+		return FALSE;
+	*next = GPOINTER_TO_UINT(g_sequence_get(siter));
+	return TRUE;
+}
+
+
+/* useful */
+/* taskstore_filter */
+static guint _taskstore_filter(TaskStore * store, guint from, guint to)
+{
+	guint count = 0;
+	guint i;
+	guint j;
+	guint slot;
+	guint32 word;
+
+	/* every word of the bitmap is only written by a single thread */
+	for(i = from; i < to; i++)
+	{
+		word = 0;
+		for(j = 0; j < TASKSTORE_BITS; j++)
+		{
+			slot = i * TASKSTORE_BITS + j;
+			if(slot >= store->count)
+				break;
+			if(store->iters[TASKSTORE_INDEX_ROWS][slot] == NULL
+					|| !_taskstore_slot_match(store, slot))
+				continue;
+			word |= 1u << j;
+			count++;
+		}
+		store->filtered[i] = word;
+	}
+	return count;
+}
+
+
+/* taskstore_slot_filter */
+static void _taskstore_slot_filter(TaskStore * store, guint slot)
+{
+	guint32 bit = 1u << (slot % TASKSTORE_BITS);
+	gboolean match;
+
+	match = _taskstore_slot_match(store, slot);
+	if(match == _taskstore_get_filtered(store, slot))
+		return;
+	if(match)
+	{
+		store->filtered[slot / TASKSTORE_BITS] |= bit;
+		store->filtered_count++;
+	}
+	else
+	{
+		store->filtered[slot / TASKSTORE_BITS] &= ~bit;
+		store->filtered_count--;
+	}
+}
+
+
+/* taskstore_slot_index */
+static int _taskstore_slot_index(TaskStore * store, guint slot)
+{
+	Task * task = store->tasks[slot];
+	char const * p;
+
+	if(search_set(store->search, slot, SEARCH_FIELD_TITLE,
+				task_get_title(task)) != 0)
+		return -1;
+	/* the words may have been extracted already while loading */
+	if((p = task_get_keywords(task)) != NULL)
+	{
+		if(search_set_words(store->search, slot,
+					SEARCH_FIELD_DESCRIPTION, p) != 0)
+			return -1;
+		task_set_keywords(task, NULL);
+	}
+	/* the descriptions read are not kept in memory */
+	else if((p = task_get_description(task)) != NULL
+			&& search_set(store->search, slot,
+				SEARCH_FIELD_DESCRIPTION, p) != 0)
+		return -1;
+	else
+		task_unload_description(task);
+	store->indexed[slot / TASKSTORE_BITS] |= 1u << (slot % TASKSTORE_BITS);
+	store->indexed_count++;
+	return 0;
+}
+
+
+/* taskstore_slot_match */
+static gboolean _taskstore_slot_match(TaskStore * store, guint slot)
+{
+	FilterRow row;
+
+	/* the titles are only kept as collation keys */
+	row.done = _taskstore_get_done(store, slot);
+	row.title = (store->tasks[slot] != NULL)
+		? task_get_title(store->tasks[slot]) : NULL;
+	row.start = store->start[slot];
+	row.end = store->end[slot];
+	row.priority = store->priority[slot];
+	return filter_match(store->filter, &row) ? TRUE : FALSE;
+}
+
+
+/* taskstore_slot_new */
+static int _taskstore_slot_new(TaskStore * store, guint * slot)
+{
+	guint size;
+	size_t i;
+	Task ** tasks;
+	guint32 * done;
+	gchar ** titles;
+	guint64 * start;
+	guint64 * end;
+	guint8 * priority;
+	guint32 * indexed;
+	guint32 * filtered;
+	GSequenceIter ** iters;
+	guint * available;
+
+	if(store->available_count > 0)
+	{
+		*slot = store->available[--store->available_count];
+		store->indexed_slot = MIN(store->indexed_slot, *slot);
+		return 0;
+	}
+	if(store->count == store->size)
+	{
+		size = (store->size == 0) ? 256 : store->size * 2;
+		/* XXX the arrays already grown are kept */
+		if((tasks = realloc(store->tasks, sizeof(*tasks) * size))
+				== NULL)
+			return -1;
+		store->tasks = tasks;
+		if((done = realloc(store->done, sizeof(*done)
+						* (size / TASKSTORE_BITS)))
+				== NULL)
+			return -1;
+		store->done = done;
+		if((titles = realloc(store->titles, sizeof(*titles) * size))
+				== NULL)
+			return -1;
+		store->titles = titles;
+		if((start = realloc(store->start, sizeof(*start) * size))
+				== NULL)
+			return -1;
+		store->start = start;
+		if((end = realloc(store->end, sizeof(*end) * size)) == NULL)
+			return -1;
+		store->end = end;
+		if((priority = realloc(store->priority, sizeof(*priority)
+						* size)) == NULL)
+			return -1;
+		store->priority = priority;
+		if((indexed = realloc(store->indexed, sizeof(*indexed)
+						* (size / TASKSTORE_BITS)))
+				== NULL)
+			return -1;
+		store->indexed = indexed;
+		if((filtered = realloc(store->filtered, sizeof(*filtered)
+						* (size / TASKSTORE_BITS)))
+				== NULL)
+			return -1;
+		store->filtered = filtered;
+		for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+		{
+			if((iters = realloc(store->iters[i], sizeof(*iters)
+							* size)) == NULL)
+				return -1;
+			store->iters[i] = iters;
+		}
+		if((available = realloc(store->available, sizeof(*available)
+						* size)) == NULL)
+			return -1;
+		store->available = available;
+		store->size = size;
+	}
+	*slot = store->count++;
+	store->tasks[*slot] = NULL;
+	store->done[*slot / TASKSTORE_BITS] &= ~(1u << (*slot
+				% TASKSTORE_BITS));
+	store->titles[*slot] = NULL;
+	store->start[*slot] = 0;
+	store->end[*slot] = 0;
+	store->priority[*slot] = 0;
+	store->indexed[*slot / TASKSTORE_BITS] &= ~(1u << (*slot
+				% TASKSTORE_BITS));
+	store->filtered[*slot / TASKSTORE_BITS] &= ~(1u << (*slot
+				% TASKSTORE_BITS));
+	for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+		store->iters[i][*slot] = NULL;
+	return 0;
+}
+
+
+/* taskstore_slot_delete */
+static void _taskstore_slot_delete(TaskStore * store, guint slot)
+{
+	size_t i;
+
+	store->tasks[slot] = NULL;
+	if(_taskstore_get_done(store, slot))
+		store->done_count--;
+	store->done[slot / TASKSTORE_BITS] &= ~(1u << (slot
+				% TASKSTORE_BITS));
+	if(store->titles[slot] != NULL)
+		store->titles_size -= strlen(store->titles[slot]) + 1;
+	g_free(store->titles[slot]);
+	store->titles[slot] = NULL;
+	store->start[slot] = 0;
+	store->end[slot] = 0;
+	store->priority[slot] = 0;
+	if(_taskstore_get_indexed(store, slot))
+	{
+		store->indexed_count--;
+		search_remove(store->search, slot);
+	}
+	store->indexed[slot / TASKSTORE_BITS] &= ~(1u << (slot
+				% TASKSTORE_BITS));
+	if(_taskstore_get_filtered(store, slot))
+		store->filtered_count--;
+	store->filtered[slot / TASKSTORE_BITS] &= ~(1u << (slot
+				% TASKSTORE_BITS));
+	for(i = 0; i < TASKSTORE_INDEX_COUNT; i++)
+		store->iters[i][slot] = NULL;
+	store->available[store->available_count++] = slot;
+}
+
+
+/* taskstore_slot_set */
+static int _taskstore_slot_set(TaskStore * store, guint slot, Task * task)
+{
+	guint32 bit = 1u << (slot % TASKSTORE_BITS);
+	gboolean done;
+	char const * p;
+	gchar * title;
+	guint64 start;
+	guint64 end;
+	guint8 priority;
+	gboolean changed[TASKSTORE_INDEX_COUNT];
+	size_t i;
+
+	done = (task != NULL && task_get_done(task) > 0) ? TRUE : FALSE;
+	p = (task != NULL) ? task_get_title(task) : NULL;
+	/* compare the titles according to the current locale */
+	if((title = g_utf8_collate_key((p != NULL) ? p : "", -1)) == NULL)
+		return -error_set_code(1, "%s", strerror(ENOMEM));
+	start = (task != NULL) ? task_get_start(task) : 0;
+	end = (task != NULL) ? task_get_end(task) : 0;
+	priority = (task != NULL) ? task_get_priority(task)
+		: AUDITOR_PRIORITY_UNKNOWN;
+	changed[TASKSTORE_INDEX_ROWS] = FALSE;
+	changed[TASKSTORE_INDEX_DONE] = (done != _taskstore_get_done(store,
+				slot));
+	changed[TASKSTORE_INDEX_TITLE] = (store->titles[slot] == NULL
+			|| strcmp(store->titles[slot], title) != 0);
+	changed[TASKSTORE_INDEX_START] = (start != store->start[slot]);
+	changed[TASKSTORE_INDEX_END] = (end != store->end[slot]);
+	changed[TASKSTORE_INDEX_PRIORITY] = (priority
+			!= store->priority[slot]);
+	store->tasks[slot] = task;
+	/* keep the count of each view up to date */
+	if(changed[TASKSTORE_INDEX_DONE] && done)
+		store->done_count++;
+	else if(changed[TASKSTORE_INDEX_DONE])
+		store->done_count--;
+	if(done)
+		store->done[slot / TASKSTORE_BITS] |= bit;
+	else
+		store->done[slot / TASKSTORE_BITS] &= ~bit;
+	if(store->titles[slot] != NULL)
+		store->titles_size -= strlen(store->titles[slot]) + 1;
+	store->titles_size += strlen(title) + 1;
+	g_free(store->titles[slot]);
+	store->titles[slot] = title;
+	store->start[slot] = start;
+	store->end[slot] = end;
+	store->priority[slot] = priority;
+	/* the description is only indexed once */
+	if(_taskstore_get_indexed(store, slot))
+		search_set(store->search, slot, SEARCH_FIELD_TITLE, p);
+	if(store->filter != NULL)
+		_taskstore_slot_filter(store, slot);
+	/* move the row in the indexes affected, if already inserted */
+	for(i = TASKSTORE_INDEX_ROWS + 1; i < TASKSTORE_INDEX_COUNT; i++)
+		if(changed[i] && store->iters[TASKSTORE_INDEX_ROWS][slot]
+				!= NULL)
+			g_sequence_sort_changed(store->iters[i][slot],
+					_taskstore_compare_funcs[i], store);
+	return 0;
+}
+
+
+/* taskstore_compare */
+static gint _taskstore_compare(gconstpointer a, gconstpointer b,
+		gpointer data, TaskStoreIndex index)
+{
+	TaskStore * store = data;
+	guint sa = GPOINTER_TO_UINT(a);
+	guint sb = GPOINTER_TO_UINT(b);
+	gint ret = 0;
+
+	switch(index)
+	{
+		case TASKSTORE_INDEX_DONE:
+			ret = _taskstore_get_done(store, sa)
+				- _taskstore_get_done(store, sb);
+			break;
+		case TASKSTORE_INDEX_TITLE:
+			ret = strcmp(store->titles[sa], store->titles[sb]);
+			break;
+		case TASKSTORE_INDEX_START:
+			ret = (store->start[sa] > store->start[sb])
+				- (store->start[sa] < store->start[sb]);
+			break;
+		case TASKSTORE_INDEX_END:
+			ret = (store->end[sa] > store->end[sb])
+				- (store->end[sa] < store->end[sb]);
+			break;
+		case TASKSTORE_INDEX_PRIORITY:
+			ret = store->priority[sa] - store->priority[sb];
+			break;
+		case TASKSTORE_INDEX_ROWS:
+			break;
+	}
+	/* keep the order stable for equal keys */
+	if(ret == 0)
+		ret = (sa > sb) - (sa < sb);
+	return ret;
+}
+
+static gint _taskstore_compare_done(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	return _taskstore_compare(a, b, data, TASKSTORE_INDEX_DONE);
+}
+
+static gint _taskstore_compare_end(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	return _taskstore_compare(a, b, data, TASKSTORE_INDEX_END);
+}
+
+static gint _taskstore_compare_priority(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	return _taskstore_compare(a, b, data, TASKSTORE_INDEX_PRIORITY);
+}
+
+static gint _taskstore_compare_start(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	return _taskstore_compare(a, b, data, TASKSTORE_INDEX_START);
+}
+
+static gint _taskstore_compare_title(gconstpointer a, gconstpointer b,
+		gpointer data)
+{
+	return _taskstore_compare(a, b, data, TASKSTORE_INDEX_TITLE);
+}
+
+
+/* GtkTreeModel */
+/* taskstore_get_flags */
+static GtkTreeModelFlags _taskstore_get_flags(GtkTreeModel * model)
+{
+	(void) model;
+
+	return GTK_TREE_MODEL_LIST_ONLY | GTK_TREE_MODEL_ITERS_PERSIST;
+}
+
+
+/* taskstore_get_n_columns */
+static gint _taskstore_get_n_columns(GtkTreeModel * model)
+{
+	(void) model;
+
+	return TASKSTORE_COL_COUNT;
+}
+
+
+/* taskstore_get_column_type */
+static GType _taskstore_get_column_type(GtkTreeModel * model, gint index)
+{
+	(void) model;
+
+	switch(index)
+	{
+		case TASKSTORE_COL_TASK:
+			return G_TYPE_POINTER;
+		case TASKSTORE_COL_DONE:
+			return G_TYPE_BOOLEAN;
+		case TASKSTORE_COL_START:
+		case TASKSTORE_COL_END:
+			return G_TYPE_UINT64;
+		case TASKSTORE_COL_PRIORITY:
+			return G_TYPE_UINT;
+		case TASKSTORE_COL_TITLE:
+		case TASKSTORE_COL_DISPLAY_PRIORITY:
+		case TASKSTORE_COL_CATEGORY:
+			return G_TYPE_STRING;
+		default:
+			return G_TYPE_INVALID;
+	}
+}
+
+
+/* taskstore_get_iter */
+static gboolean _taskstore_get_iter(GtkTreeModel * model, GtkTreeIter * iter,
+		GtkTreePath * path)
+{
+	if(gtk_tree_path_get_depth(path) != 1)
+		return FALSE;
+	return _taskstore_iter_nth_child(model, iter, NULL,
+			gtk_tree_path_get_indices(path)[0]);
+}
+
+
+/* taskstore_get_path */
+static GtkTreePath * _taskstore_get_path(GtkTreeModel * model,
+		GtkTreeIter * iter)
+{
+	TaskStore * store = TASKSTORE(model);
+
+	g_return_val_if_fail(iter->stamp == store->stamp, NULL);
+	return _taskstore_get_path_slot(store, GPOINTER_TO_UINT(
+				iter->user_data));
+}
+
+
+/* taskstore_get_value */
+static void _taskstore_get_value(GtkTreeModel * model, GtkTreeIter * iter,
+		gint column, GValue * value)
+{
+	TaskStore * store = TASKSTORE(model);
+	guint slot;
+	Task * task;
+
+	g_return_if_fail(iter->stamp == store->stamp);
+	slot = GPOINTER_TO_UINT(iter->user_data);
+	task = store->tasks[slot];
+	g_value_init(value, _taskstore_get_column_type(model, column));
+	/* read straight from the arrays or the task */
+	switch(column)
+	{
+		case TASKSTORE_COL_TASK:
+			g_value_set_pointer(value, task);
+			break;
+		case TASKSTORE_COL_DONE:
+			g_value_set_boolean(value, _taskstore_get_done(store,
+						slot));
+			break;
+		case TASKSTORE_COL_TITLE:
+			g_value_set_static_string(value, (task != NULL)
+					? task_get_title(task) : NULL);
+			break;
+		case TASKSTORE_COL_START:
+			g_value_set_uint64(value, store->start[slot]);
+			break;
+		case TASKSTORE_COL_END:
+			g_value_set_uint64(value, store->end[slot]);
+			break;
+		case TASKSTORE_COL_PRIORITY:
+			g_value_set_uint(value, store->priority[slot]);
+			break;
+		case TASKSTORE_COL_DISPLAY_PRIORITY:
+			g_value_set_static_string(value, priority_get_title(
+						store->priority[slot]));
+			break;
+		case TASKSTORE_COL_CATEGORY:
+			if(store->tasks[slot] != NULL)
+				g_value_set_string(value, task_get_category(
+							store->tasks[slot]));
+			break;
+		default:
+			break;
+	}
+}
+
+
+/* taskstore_iter_next */
+static gboolean _taskstore_iter_next(GtkTreeModel * model,
+		GtkTreeIter * iter)
+{
+	TaskStore * store = TASKSTORE(model);
+	guint next;
+
+	g_return_val_if_fail(iter->stamp == store->stamp, FALSE);
+	if(_taskstore_get_slot_next(store, GPOINTER_TO_UINT(iter->user_data),
+				&next) != TRUE)
+	{
+		iter->stamp = 0;
+		return FALSE;
+	}
+	iter->user_data = GUINT_TO_POINTER(next);
+	return TRUE;
+}
+
+
+/* taskstore_iter_children */
+static gboolean _taskstore_iter_children(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * parent)
+{
+	return _taskstore_iter_nth_child(model, iter, parent, 0);
+}
+
+
+/* taskstore_iter_has_child */
+static gboolean _taskstore_iter_has_child(GtkTreeModel * model,
+		GtkTreeIter * iter)
+{
+	(void) model;
+	(void) iter;
+
+	return FALSE;
+}
+
+
+/* taskstore_iter_n_children */
+static gint _taskstore_iter_n_children(GtkTreeModel * model,
+		GtkTreeIter * iter)
+{
+	TaskStore * store = TASKSTORE(model);
+
+	if(iter != NULL)
+		return 0;
+	return g_sequence_get_length(store->indexes[TASKSTORE_INDEX_ROWS]);
+}
+
+
+/* taskstore_iter_nth_child */
+static gboolean _taskstore_iter_nth_child(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * parent, gint n)
+{
+	TaskStore * store = TASKSTORE(model);
+	guint slot;
+
+	if(parent != NULL || _taskstore_get_slot_at(store, n, &slot) != TRUE)
+		return FALSE;
+	iter->stamp = store->stamp;
+	iter->user_data = GUINT_TO_POINTER(slot);
+	return TRUE;
+}
+
+
+/* taskstore_iter_parent */
+static gboolean _taskstore_iter_parent(GtkTreeModel * model,
+		GtkTreeIter * iter, GtkTreeIter * child)
+{
+	(void) model;
+	(void) iter;
+	(void) child;
+
+	return FALSE;
+}
+
+
+/* GtkTreeSortable */
+/* taskstore_get_sort_column_id */
+static gboolean _taskstore_get_sort_column_id(GtkTreeSortable * sortable,
+		gint * sort_column_id, GtkSortType * order)
+{
+	TaskStore * store = TASKSTORE(sortable);
+
+	if(sort_column_id != NULL)
+		*sort_column_id = store->sort_id;
+	if(order != NULL)
+		*order = store->sort_order;
+	return (store->sort_id >= 0) ? TRUE : FALSE;
+}
+
+
+/* taskstore_set_sort_column_id */
+static void _taskstore_set_sort_column_id(GtkTreeSortable * sortable,
+		gint sort_column_id, GtkSortType order)
+{
+	TaskStore * store = TASKSTORE(sortable);
+	TaskStoreIndex index;
+	gint count;
+	gint * positions;
+	gint * reordered;
+	guint slot;
+	gint i;
+	GtkTreePath * path;
+	gint64 start;
+
+	switch(sort_column_id)
+	{
+		case TASKSTORE_COL_DONE:
+			index = TASKSTORE_INDEX_DONE;
+			break;
+		case TASKSTORE_COL_TITLE:
+			index = TASKSTORE_INDEX_TITLE;
+			break;
+		case TASKSTORE_COL_START:
+			index = TASKSTORE_INDEX_START;
+			break;
+		case TASKSTORE_COL_END:
+			index = TASKSTORE_INDEX_END;
+			break;
+		case TASKSTORE_COL_PRIORITY:
+			index = TASKSTORE_INDEX_PRIORITY;
+			break;
+		case GTK_TREE_SORTABLE_DEFAULT_SORT_COLUMN_ID:
+		case GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID:
+			index = TASKSTORE_INDEX_ROWS;
+			order = GTK_SORT_ASCENDING;
+			break;
+		default:
+			g_warning("%d: Unsupported sort column",
+					sort_column_id);
+			return;
+	}
+	if(sort_column_id == store->sort_id && order == store->sort_order)
+		return;
+	/* the rows are already ordered: only tell where they moved */
+	start = trace_begin();
+	count = g_sequence_get_length(store->indexes[TASKSTORE_INDEX_ROWS]);
+	positions = _taskstore_get_positions(store, count);
+	store->index = index;
+	store->sort_id = sort_column_id;
+	store->sort_order = order;
+	gtk_tree_sortable_sort_column_changed(sortable);
+	if(positions == NULL)
+		return;
+	if((reordered = malloc(sizeof(*reordered) * count)) != NULL)
+	{
+		for(i = 0; i < count; i++)
+		{
+			_taskstore_get_slot_at(store, i, &slot);
+			reordered[i] = positions[slot];
+		}
+		path = gtk_tree_path_new();
+		gtk_tree_model_rows_reordered(GTK_TREE_MODEL(store), path,
+				NULL, reordered);
+		gtk_tree_path_free(path);
+		free(reordered);
+	}
+	free(positions);
+	trace_end(start, "taskstore", "sort", NULL);
+}
+
+
+/* taskstore_set_sort_func */
+static void _taskstore_set_sort_func(GtkTreeSortable * sortable,
+		gint sort_column_id, GtkTreeIterCompareFunc func,
+		gpointer data, GDestroyNotify destroy)
+{
+	(void) sortable;
+	(void) func;
+	(void) data;
+	(void) destroy;
+
+	g_warning("%d: Custom sort functions are not supported",
+			sort_column_id);
+}
+
+
+/* taskstore_set_default_sort_func */
+static void _taskstore_set_default_sort_func(GtkTreeSortable * sortable,
+		GtkTreeIterCompareFunc func, gpointer data,
+		GDestroyNotify destroy)
+{
+	(void) sortable;
+	(void) func;
+	(void) data;
+	(void) destroy;
+
+	g_warning("%s", "Custom sort functions are not supported");
+}
+
+
+/* taskstore_has_default_sort_func */
+static gboolean _taskstore_has_default_sort_func(GtkTreeSortable * sortable)
+{
+	(void) sortable;
+
+	/* the default order is the order of insertion */
+	return TRUE;
+}
+
+
+/* callbacks */
+/* taskstore_on_filter */
+static gpointer _taskstore_on_filter(gpointer data)
+{
+	TaskStoreFilterJob * job = data;
+	gint64 start = trace_begin();
+
+	job->count = _taskstore_filter(job->store, job->from, job->to);
+	trace_end(start, "taskstore", "filter", NULL);
+	return NULL;
+}
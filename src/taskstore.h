@@ -0,0 +1,106 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#ifndef AUDITOR_TASKSTORE_H
+# define AUDITOR_TASKSTORE_H
+
+# include <gtk/gtk.h>
+# include "filter.h"
+# include "task.h"
+
+
+/* TaskStore */
+/* types */
+typedef struct _TaskStore TaskStore;
+typedef struct _TaskStoreClass TaskStoreClass;
+
+typedef enum _TaskStoreColumn
+{
+	TASKSTORE_COL_TASK = 0,
+	TASKSTORE_COL_DONE,
+	TASKSTORE_COL_TITLE,
+	TASKSTORE_COL_START,
+	TASKSTORE_COL_END,
+	TASKSTORE_COL_PRIORITY,
+	TASKSTORE_COL_DISPLAY_PRIORITY,
+	TASKSTORE_COL_CATEGORY
+} TaskStoreColumn;
+# define TASKSTORE_COL_LAST TASKSTORE_COL_CATEGORY
+# define TASKSTORE_COL_COUNT (TASKSTORE_COL_LAST + 1)
+
+typedef struct _TaskStoreMemory
+{
+	size_t rows;		/* the slots, as parallel arrays */
+	size_t indexes;		/* the sequences for each sort key */
+	size_t titles;		/* the collation keys of the titles */
+	size_t search;		/* the full-text index */
+} TaskStoreMemory;
+
+# define TASKSTORE_TYPE		(taskstore_get_type())
+# define TASKSTORE(obj)		(G_TYPE_CHECK_INSTANCE_CAST((obj), \
+			TASKSTORE_TYPE, TaskStore))
+# define IS_TASKSTORE(obj)	(G_TYPE_CHECK_INSTANCE_TYPE((obj), \
+			TASKSTORE_TYPE))
+
+
+/* functions */
+GType taskstore_get_type(void);
+
+TaskStore * taskstore_new(void);
+
+
+/* accessors */
+guint taskstore_get_count(TaskStore * store);
+guint taskstore_get_count_done(TaskStore * store);
+guint taskstore_get_count_filtered(TaskStore * store);
+guint taskstore_get_count_indexed(TaskStore * store);
+gboolean taskstore_get_done(TaskStore * store, GtkTreeIter * iter);
+char const * taskstore_get_filter(TaskStore * store);
+void taskstore_get_memory(TaskStore * store, TaskStoreMemory * memory);
+gboolean taskstore_get_filtered(TaskStore * store, GtkTreeIter * iter);
+gboolean taskstore_get_match(TaskStore * store, GtkTreeIter * iter);
+char const * taskstore_get_search(TaskStore * store);
+Task * taskstore_get_task(TaskStore * store, GtkTreeIter * iter);
+
+int taskstore_set(TaskStore * store, GtkTreeIter * iter, Task * task);
+void taskstore_set_filter(TaskStore * store, Filter * filter);
+int taskstore_set_search(TaskStore * store, char const * query);
+void taskstore_set_threads(TaskStore * store, unsigned int threads);
+
+
+/* useful */
+void taskstore_clear(TaskStore * store);
+void taskstore_freeze(TaskStore * store);
+int taskstore_index(TaskStore * store, guint count);
+int taskstore_insert(TaskStore * store, GtkTreeIter * iter, gint position,
+		Task * task);
+int taskstore_reindex(TaskStore * store, GtkTreeIter * iter);
+gboolean taskstore_remove(TaskStore * store, GtkTreeIter * iter);
+int taskstore_thaw(TaskStore * store);
+
+#endif /* !AUDITOR_TASKSTORE_H */
@@ -0,0 +1,208 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <System.h>
+#include "trace.h"
+
+
+/* Trace */
+/* private */
+/* variables */
+/* shared with the loader and writer threads */
+static GMutex _trace_mutex;
+static FILE * _trace_fp = NULL;
+static gint64 _trace_origin;
+static guint _trace_threads;
+static GPrivate _trace_tid = G_PRIVATE_INIT(NULL);
+static GPrivate _trace_thread = G_PRIVATE_INIT(NULL);
+
+
+/* prototypes */
+static void _trace_escape(char const * string);
+static int _trace_finish(void);
+static guint _trace_get_tid(void);
+static void _trace_thread_name(char const * name);
+
+
+/* public */
+/* functions */
+/* trace_open */
+int trace_open(char const * filename)
+{
+	int ret = 0;
+
+	g_mutex_lock(&_trace_mutex);
+	/* the trace already open is completed first, as it may be the same */
+	if(_trace_fp != NULL)
+		ret = _trace_finish();
+	if(ret == 0 && (_trace_fp = fopen(filename, "w")) == NULL)
+		ret = -error_set_code(1, "%s: %s", filename, strerror(errno));
+	if(ret == 0)
+	{
+		_trace_origin = g_get_monotonic_time();
+		/* in the Trace Event Format, as read by Chrome or Perfetto */
+		fputc('[', _trace_fp);
+		_trace_thread_name("main");
+	}
+	g_mutex_unlock(&_trace_mutex);
+	return ret;
+}
+
+
+/* trace_close */
+int trace_close(void)
+{
+	int ret = 0;
+
+	g_mutex_lock(&_trace_mutex);
+	if(_trace_fp != NULL)
+		ret = _trace_finish();
+	g_mutex_unlock(&_trace_mutex);
+	return ret;
+}
+
+
+/* accessors */
+/* trace_set_thread */
+void trace_set_thread(char const * name)
+{
+	if(_trace_fp == NULL || g_private_get(&_trace_thread) == name)
+		return;
+	/* the threads of the pools may run different jobs */
+	g_private_set(&_trace_thread, (gpointer)name);
+	g_mutex_lock(&_trace_mutex);
+	if(_trace_fp != NULL)
+	{
+		fputs(",\n", _trace_fp);
+		_trace_thread_name(name);
+	}
+	g_mutex_unlock(&_trace_mutex);
+}
+
+
+/* useful */
+/* trace_begin */
+gint64 trace_begin(void)
+{
+	/* racy on purpose: tracing is enabled before any thread starts */
+	return (_trace_fp != NULL) ? g_get_monotonic_time() : 0;
+}
+
+
+/* trace_end */
+void trace_end(gint64 start, char const * category, char const * name,
+		char const * detail)
+{
+	gint64 end;
+
+	if(start == 0 || _trace_fp == NULL)
+		return;
+	end = g_get_monotonic_time();
+	g_mutex_lock(&_trace_mutex);
+	if(_trace_fp == NULL)
+	{
+		g_mutex_unlock(&_trace_mutex);
+		return;
+	}
+	fprintf(_trace_fp, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\","
+			"\"ts\":%" G_GINT64_FORMAT ",\"dur\":%" G_GINT64_FORMAT
+			",\"pid\":%ld,\"tid\":%u", name, category,
+			start - _trace_origin, end - start, (long)getpid(),
+			_trace_get_tid());
+	if(detail != NULL)
+	{
+		fputs(",\"args\":{\"detail\":\"", _trace_fp);
+		_trace_escape(detail);
+		fputs("\"}", _trace_fp);
+	}
+	fputc('}', _trace_fp);
+	g_mutex_unlock(&_trace_mutex);
+}
+
+
+/* private */
+/* functions */
+/* trace_escape */
+static void _trace_escape(char const * string)
+{
+	unsigned char c;
+
+	for(; (c = *string) != '\0'; string++)
+		if(c == '"' || c == '\\')
+			fprintf(_trace_fp, "\\%c", c);
+		else if(c < 0x20)
+			fprintf(_trace_fp, "\\u%04x", c);
+		else
+			fputc(c, _trace_fp);
+}
+
+
+/* trace_finish */
+static int _trace_finish(void)
+{
+	int ret = 0;
+
+	fputs("\n]\n", _trace_fp);
+	if(fclose(_trace_fp) != 0)
+		ret = -error_set_code(1, "%s", strerror(errno));
+	_trace_fp = NULL;
+	return ret;
+}
+
+
+/* trace_get_tid */
+static guint _trace_get_tid(void)
+{
+	gpointer p;
+
+	/* numbered in the order the threads are first seen */
+	if((p = g_private_get(&_trace_tid)) == NULL)
+	{
+		p = GUINT_TO_POINTER(++_trace_threads);
+		g_private_set(&_trace_tid, p);
+	}
+	return GPOINTER_TO_UINT(p);
+}
+
+
+/* trace_thread_name */
+static void _trace_thread_name(char const * name)
+{
+	fprintf(_trace_fp, "{\"name\":\"thread_name\",\"ph\":\"M\","
+			"\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":\"",
+			(long)getpid(), _trace_get_tid());
+	_trace_escape(name);
+	fputs("\"}}", _trace_fp);
+}
@@ -0,0 +1,223 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+
+
+#include <stdlib.h>
+#include <libintl.h>
+#include <gtk/gtk.h>
+#include <System.h>
+#include "viewedit.h"
+#define _(string) gettext(string)
+
+
+/* ViewEdit */
+/* private */
+/* types */
+struct _ViewEdit
+{
+	Auditor * auditor;
+
+	/* widgets */
+	GtkWidget * window;
+	GtkWidget * name;
+	GtkWidget * filter;
+};
+
+
+/* public */
+/* functions */
+/* viewedit_new */
+static void _on_viewedit_cancel(gpointer data);
+static void _on_viewedit_changed(gpointer data);
+static void _on_viewedit_delete(gpointer data);
+static void _on_viewedit_ok(gpointer data);
+
+ViewEdit * viewedit_new(Auditor * auditor, GtkTreeModel * views)
+{
+	ViewEdit * viewedit;
+	GtkSizeGroup * group;
+	GtkWidget * vbox;
+	GtkWidget * hbox;
+	GtkWidget * widget;
+	GtkWidget * bbox;
+	char const * filter;
+
+	if((viewedit = malloc(sizeof(*viewedit))) == NULL)
+		return NULL;
+	viewedit->auditor = auditor;
+	viewedit->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
+	gtk_window_set_default_size(GTK_WINDOW(viewedit->window), 400, -1);
+	gtk_window_set_title(GTK_WINDOW(viewedit->window), _("Custom view"));
+	g_signal_connect_swapped(viewedit->window, "delete-event", G_CALLBACK(
+				_on_viewedit_cancel), viewedit);
+	group = gtk_size_group_new(GTK_SIZE_GROUP_HORIZONTAL);
+	vbox = gtk_box_new(GTK_ORIENTATION_VERTICAL, 4);
+	/* name */
+	hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+	widget = gtk_label_new(_("Name:"));
+#if GTK_CHECK_VERSION(3, 0, 0)
+	g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+	gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+	gtk_size_group_add_widget(group, widget);
+	gtk_box_pack_start(GTK_BOX(hbox), widget, FALSE, TRUE, 0);
+	/* the views saved can be selected, or a new name entered */
+#if GTK_CHECK_VERSION(2, 24, 0)
+	viewedit->name = gtk_combo_box_new_with_model_and_entry(views);
+	gtk_combo_box_set_entry_text_column(GTK_COMBO_BOX(viewedit->name), 0);
+#else
+	viewedit->name = gtk_combo_box_entry_new_with_model(views, 0);
+#endif
+	g_signal_connect_swapped(viewedit->name, "changed", G_CALLBACK(
+				_on_viewedit_changed), viewedit);
+	gtk_box_pack_start(GTK_BOX(hbox), viewedit->name, TRUE, TRUE, 0);
+	gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, TRUE, 0);
+	/* filter */
+	hbox = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
+	widget = gtk_label_new(_("Filter:"));
+#if GTK_CHECK_VERSION(3, 0, 0)
+	g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+	gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+	gtk_size_group_add_widget(group, widget);
+	gtk_box_pack_start(GTK_BOX(hbox), widget, FALSE, TRUE, 0);
+	viewedit->filter = gtk_entry_new();
+	if((filter = auditor_get_filter(auditor)) != NULL)
+		gtk_entry_set_text(GTK_ENTRY(viewedit->filter), filter);
+	g_signal_connect_swapped(viewedit->filter, "activate", G_CALLBACK(
+				_on_viewedit_ok), viewedit);
+	gtk_box_pack_start(GTK_BOX(hbox), viewedit->filter, TRUE, TRUE, 0);
+	gtk_box_pack_start(GTK_BOX(vbox), hbox, FALSE, TRUE, 0);
+	/* help */
+	widget = gtk_label_new(_("Fields: done, title, start, end, priority\n"
+				"Operators: = != < <= > >= ~ and or not\n"
+				"Example: priority>=high and not done"
+				" and title~\"ssh\""));
+#if GTK_CHECK_VERSION(3, 0, 0)
+	g_object_set(widget, "halign", GTK_ALIGN_START, NULL);
+#else
+	gtk_misc_set_alignment(GTK_MISC(widget), 0.0, 0.5);
+#endif
+	gtk_widget_set_sensitive(widget, FALSE);
+	gtk_box_pack_start(GTK_BOX(vbox), widget, FALSE, TRUE, 0);
+	bbox = gtk_button_box_new(GTK_ORIENTATION_HORIZONTAL);
+	gtk_button_box_set_layout(GTK_BUTTON_BOX(bbox), GTK_BUTTONBOX_END);
+	gtk_box_set_spacing(GTK_BOX(bbox), 4);
+	widget = gtk_button_new_from_stock(GTK_STOCK_DELETE);
+	g_signal_connect_swapped(widget, "clicked", G_CALLBACK(
+				_on_viewedit_delete), viewedit);
+	gtk_container_add(GTK_CONTAINER(bbox), widget);
+	widget = gtk_button_new_from_stock(GTK_STOCK_CANCEL);
+	g_signal_connect_swapped(widget, "clicked", G_CALLBACK(
+				_on_viewedit_cancel), viewedit);
+	gtk_container_add(GTK_CONTAINER(bbox), widget);
+	widget = gtk_button_new_from_stock(GTK_STOCK_OK);
+	g_signal_connect_swapped(widget, "clicked", G_CALLBACK(_on_viewedit_ok),
+			viewedit);
+	gtk_container_add(GTK_CONTAINER(bbox), widget);
+	gtk_box_pack_end(GTK_BOX(vbox), bbox, FALSE, TRUE, 0);
+	gtk_container_set_border_width(GTK_CONTAINER(viewedit->window), 4);
+	gtk_container_add(GTK_CONTAINER(viewedit->window), vbox);
+	gtk_widget_show_all(viewedit->window);
+	return viewedit;
+}
+
+static void _on_viewedit_cancel(gpointer data)
+{
+	ViewEdit * viewedit = data;
+
+	viewedit_delete(viewedit);
+}
+
+static void _on_viewedit_changed(gpointer data)
+{
+	ViewEdit * viewedit = data;
+	GtkTreeModel * model;
+	GtkTreeIter iter;
+	gchar * filter;
+
+	/* only when selecting a view already saved */
+	if(gtk_combo_box_get_active_iter(GTK_COMBO_BOX(viewedit->name), &iter)
+			!= TRUE)
+		return;
+	model = gtk_combo_box_get_model(GTK_COMBO_BOX(viewedit->name));
+	gtk_tree_model_get(model, &iter, 1, &filter, -1);
+	gtk_entry_set_text(GTK_ENTRY(viewedit->filter), (filter != NULL)
+			? filter : "");
+	g_free(filter);
+}
+
+static void _on_viewedit_delete(gpointer data)
+{
+	ViewEdit * viewedit = data;
+	GtkWidget * entry;
+	char const * name;
+
+	entry = gtk_bin_get_child(GTK_BIN(viewedit->name));
+	name = gtk_entry_get_text(GTK_ENTRY(entry));
+	if(name[0] == '\0')
+		return;
+	if(auditor_view_remove(viewedit->auditor, name) != 0)
+	{
+		auditor_error(viewedit->auditor, error_get(NULL), 1);
+		return;
+	}
+	gtk_entry_set_text(GTK_ENTRY(entry), "");
+}
+
+static void _on_viewedit_ok(gpointer data)
+{
+	ViewEdit * viewedit = data;
+	GtkWidget * entry;
+	char const * name;
+	char const * filter;
+
+	entry = gtk_bin_get_child(GTK_BIN(viewedit->name));
+	name = gtk_entry_get_text(GTK_ENTRY(entry));
+	filter = gtk_entry_get_text(GTK_ENTRY(viewedit->filter));
+	/* let the user correct the filter */
+	if(auditor_set_filter(viewedit->auditor, filter) != 0)
+		return;
+	if(name[0] != '\0' && filter[0] != '\0'
+			&& auditor_view_save(viewedit->auditor, name, filter)
+			!= 0)
+		auditor_error(viewedit->auditor, error_get(NULL), 1);
+	_on_viewedit_cancel(viewedit);
+}
+
+
+/* viewedit_delete */
+void viewedit_delete(ViewEdit * viewedit)
+{
+	gtk_widget_destroy(viewedit->window);
+	free(viewedit);
+}
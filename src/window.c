@@ -70,10 +70,14 @@ static void _auditorwindow_on_preferences(gpointer data);
 /* file menu */
 static void _auditorwindow_on_file_new(gpointer data);
 static void _auditorwindow_on_file_edit(gpointer data);
+static void _auditorwindow_on_file_export(gpointer data);
+static void _auditorwindow_on_file_import(gpointer data);
 static void _auditorwindow_on_file_close(gpointer data);
 
 /* edit menu */
 static void _auditorwindow_on_edit_select_all(gpointer data);
+static void _auditorwindow_on_edit_completed(gpointer data);
+static void _auditorwindow_on_edit_not_completed(gpointer data);
 static void _auditorwindow_on_edit_delete(gpointer data);
 static void _auditorwindow_on_edit_preferences(gpointer data);
 
@@ -81,6 +85,8 @@ static void _auditorwindow_on_edit_preferences(gpointer data);
 static void _auditorwindow_on_view_all_tasks(gpointer data);
 static void _auditorwindow_on_view_completed_tasks(gpointer data);
 static void _auditorwindow_on_view_remaining_tasks(gpointer data);
+static void _auditorwindow_on_view_custom(gpointer data);
+static void _auditorwindow_on_view_performance(gpointer data);
 
 /* help menu */
 static void _auditorwindow_on_help_about(gpointer data);
@@ -109,6 +115,11 @@ static const DesktopMenu _file_menu[] =
 	{ N_("_Edit"), G_CALLBACK(_auditorwindow_on_file_edit), GTK_STOCK_EDIT,
 		GDK_CONTROL_MASK, GDK_KEY_E },
 	{ "", NULL, NULL, 0, 0 },
+	{ N_("_Import..."), G_CALLBACK(_auditorwindow_on_file_import), NULL, 0,
+		0 },
+	{ N_("E_xport..."), G_CALLBACK(_auditorwindow_on_file_export), NULL, 0,
+		0 },
+	{ "", NULL, NULL, 0, 0 },
 	{ N_("_Close"), G_CALLBACK(_auditorwindow_on_file_close), GTK_STOCK_CLOSE,
 		GDK_CONTROL_MASK, GDK_KEY_W },
 	{ NULL, NULL, NULL, 0, 0 }
@@ -123,6 +134,11 @@ static const DesktopMenu _edit_menu[] =
 #endif
 		GDK_CONTROL_MASK, GDK_KEY_A },
 	{ "", NULL, NULL, 0, 0 },
+	{ N_("Mark as _completed"), G_CALLBACK(
+			_auditorwindow_on_edit_completed), NULL, 0, 0 },
+	{ N_("Mark as _not completed"), G_CALLBACK(
+			_auditorwindow_on_edit_not_completed), NULL, 0, 0 },
+	{ "", NULL, NULL, 0, 0 },
 	{ N_("_Delete"), G_CALLBACK(_auditorwindow_on_edit_delete),
 		GTK_STOCK_DELETE, 0, 0 },
 	{ "", NULL, NULL, 0, 0 },
@@ -138,6 +154,12 @@ static const DesktopMenu _view_menu[] =
 			_auditorwindow_on_view_completed_tasks), NULL, 0, 0 },
 	{ N_("_Remaining tasks"), G_CALLBACK(
 			_auditorwindow_on_view_remaining_tasks), NULL, 0, 0 },
+	{ "", NULL, NULL, 0, 0 },
+	{ N_("C_ustom view..."), G_CALLBACK(_auditorwindow_on_view_custom),
+		NULL, GDK_CONTROL_MASK, GDK_KEY_L },
+	{ "", NULL, NULL, 0, 0 },
+	{ N_("_Performance"), G_CALLBACK(_auditorwindow_on_view_performance),
+		NULL, 0, 0 },
 	{ NULL, NULL, NULL, 0, 0 }
 };
 static const DesktopMenu _help_menu[] =
@@ -205,6 +227,7 @@ AuditorWindow * auditorwindow_new(void)
 	gtk_box_pack_start(GTK_BOX(vbox), widget, TRUE, TRUE, 0);
 	/* statusbar */
 	auditor->statusbar = gtk_statusbar_new();
+	auditor_set_statusbar(auditor->auditor, auditor->statusbar);
 	gtk_box_pack_start(GTK_BOX(vbox), auditor->statusbar, FALSE, TRUE, 0);
 	gtk_container_add(GTK_CONTAINER(auditor->window), vbox);
 	gtk_widget_show_all(auditor->window);
@@ -222,6 +245,22 @@ void auditorwindow_delete(AuditorWindow * auditor)
 }
 
 
+/* accessors */
+/* auditorwindow_set_threads */
+void auditorwindow_set_threads(AuditorWindow * auditor, unsigned int threads)
+{
+	auditor_set_threads(auditor->auditor, threads);
+}
+
+
+/* auditorwindow_set_write_delay */
+void auditorwindow_set_write_delay(AuditorWindow * auditor,
+		unsigned int delay)
+{
+	auditor_set_write_delay(auditor->auditor, delay);
+}
+
+
 /* private */
 /* functions */
 /* callbacks */
@@ -292,6 +331,24 @@ static void _auditorwindow_on_file_edit(gpointer data)
 }
 
 
+/* auditorwindow_on_file_export */
+static void _auditorwindow_on_file_export(gpointer data)
+{
+	AuditorWindow * auditor = data;
+
+	auditor_export(auditor->auditor);
+}
+
+
+/* auditorwindow_on_file_import */
+static void _auditorwindow_on_file_import(gpointer data)
+{
+	AuditorWindow * auditor = data;
+
+	auditor_import(auditor->auditor);
+}
+
+
 /* auditorwindow_on_file_new */
 static void _auditorwindow_on_file_new(gpointer data)
 {
@@ -302,6 +359,18 @@ static void _auditorwindow_on_file_new(gpointer data)
 
 
 /* edit menu */
+/* auditorwindow_on_edit_completed */
+static void _auditorwindow_on_edit_completed(gpointer data)
+{
+	AuditorWindow * auditor = data;
+	AuditorBulk bulk;
+
+	bulk.fields = AUDITOR_BULK_DONE;
+	bulk.done = 1;
+	auditor_task_update_selected(auditor->auditor, &bulk);
+}
+
+
 /* auditorwindow_on_edit_delete */
 static void _auditorwindow_on_edit_delete(gpointer data)
 {
@@ -311,6 +380,18 @@ static void _auditorwindow_on_edit_delete(gpointer data)
 }
 
 
+/* auditorwindow_on_edit_not_completed */
+static void _auditorwindow_on_edit_not_completed(gpointer data)
+{
+	AuditorWindow * auditor = data;
+	AuditorBulk bulk;
+
+	bulk.fields = AUDITOR_BULK_DONE;
+	bulk.done = 0;
+	auditor_task_update_selected(auditor->auditor, &bulk);
+}
+
+
 /* auditorwindow_on_edit_preferences */
 static void _auditorwindow_on_edit_preferences(gpointer data)
 {
@@ -348,6 +429,25 @@ static void _auditorwindow_on_view_completed_tasks(gpointer data)
 }
 
 
+/* auditorwindow_on_view_custom */
+static void _auditorwindow_on_view_custom(gpointer data)
+{
+	AuditorWindow * auditor = data;
+
+	auditor_view_edit(auditor->auditor);
+}
+
+
+/* auditorwindow_on_view_performance */
+static void _auditorwindow_on_view_performance(gpointer data)
+{
+	AuditorWindow * auditor = data;
+
+	auditor_show_performance(auditor->auditor,
+			!auditor_get_show_performance(auditor->auditor));
+}
+
+
 /* auditorwindow_on_view_remaining_tasks */
 static void _auditorwindow_on_view_remaining_tasks(gpointer data)
 {
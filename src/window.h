@@ -42,4 +42,9 @@ typedef struct _AuditorWindow AuditorWindow;
 AuditorWindow * auditorwindow_new(void);
 void auditorwindow_delete(AuditorWindow * auditor);
 
+/* accessors */
+void auditorwindow_set_threads(AuditorWindow * auditor, unsigned int threads);
+void auditorwindow_set_write_delay(AuditorWindow * auditor,
+		unsigned int delay);
+
 #endif /* !AUDITOR_WINDOW_H */
@@ -0,0 +1,538 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <glib.h>
+#include <System.h>
+#include "trace.h"
+#include "writer.h"
+
+/* constants */
+#define WRITER_INTERVAL	50
+#define WRITER_WAIT	10	/* postponed up to this many times the delay */
+
+
+/* Writer */
+/* private */
+/* types */
+typedef enum _WriterOperation
+{
+	WRITER_OPERATION_SAVE = 0,
+	WRITER_OPERATION_REMOVE,
+	WRITER_OPERATION_SYNC
+} WriterOperation;
+
+typedef struct _WriterJob
+{
+	WriterOperation operation;
+	char * filename;
+	Journal * journal;
+	Task * task;		/* a copy, serialized in the background */
+	char * error;
+	gint64 duration;
+} WriterJob;
+
+struct _Writer
+{
+	unsigned int delay;
+	WriterCallback callback;
+	void * data;
+
+	/* pending tasks */
+	GHashTable * tasks;
+	guint source;
+	gint64 queued;
+	int frozen;
+	Journal * journal;
+
+	/* background writes */
+	GThreadPool * pool;
+	GAsyncQueue * results;
+	size_t outstanding;
+	guint results_source;
+
+	/* statistics */
+	unsigned long long latency;
+};
+
+
+/* prototypes */
+static int _writer_dispatch(Writer * writer);
+static void _writer_error(WriterJob * job, int error);
+static int _writer_push(Writer * writer, WriterOperation operation,
+		char const * filename, Journal * journal, Task * task);
+static int _writer_results(Writer * writer, int wait);
+static int _writer_write(char const * filename, char const * data);
+
+/* callbacks */
+static gboolean _writer_on_results(gpointer data);
+static gboolean _writer_on_timeout(gpointer data);
+static void _writer_on_write(gpointer data, gpointer user_data);
+
+
+/* public */
+/* functions */
+/* writer_new */
+Writer * writer_new(unsigned int delay, WriterCallback callback, void * data)
+{
+	Writer * writer;
+	GError * error = NULL;
+
+	if((writer = object_new(sizeof(*writer))) == NULL)
+		return NULL;
+	writer->delay = delay;
+	writer->callback = callback;
+	writer->data = data;
+	writer->tasks = g_hash_table_new(g_direct_hash, g_direct_equal);
+	writer->source = 0;
+	writer->queued = 0;
+	writer->frozen = 0;
+	writer->journal = NULL;
+	writer->results = g_async_queue_new();
+	writer->outstanding = 0;
+	writer->results_source = 0;
+	writer->latency = 0;
+	/* a single thread keeps the writes in order */
+	if((writer->pool = g_thread_pool_new(_writer_on_write, writer, 1,
+					FALSE, &error)) == NULL)
+	{
+		error_set_code(1, "%s", error->message);
+		g_error_free(error);
+		g_async_queue_unref(writer->results);
+		g_hash_table_destroy(writer->tasks);
+		object_delete(writer);
+		return NULL;
+	}
+	return writer;
+}
+
+
+/* writer_delete */
+void writer_delete(Writer * writer)
+{
+	writer_flush(writer);
+	g_thread_pool_free(writer->pool, FALSE, TRUE);
+	g_async_queue_unref(writer->results);
+	g_hash_table_destroy(writer->tasks);
+	object_delete(writer);
+}
+
+
+/* accessors */
+/* writer_get_delay */
+unsigned int writer_get_delay(Writer * writer)
+{
+	return writer->delay;
+}
+
+
+/* writer_get_latency */
+unsigned long long writer_get_latency(Writer * writer)
+{
+	return writer->latency;
+}
+
+
+/* writer_get_pending */
+size_t writer_get_pending(Writer * writer)
+{
+	return g_hash_table_size(writer->tasks) + writer->outstanding;
+}
+
+
+/* writer_set_delay */
+void writer_set_delay(Writer * writer, unsigned int delay)
+{
+	writer->delay = delay;
+}
+
+
+/* useful */
+/* writer_cancel */
+void writer_cancel(Writer * writer, Task * task)
+{
+	g_hash_table_remove(writer->tasks, task);
+}
+
+
+/* writer_flush */
+int writer_flush(Writer * writer)
+{
+	int ret;
+
+	if(writer->source != 0)
+		g_source_remove(writer->source);
+	writer->source = 0;
+	ret = _writer_dispatch(writer);
+	if(writer->results_source != 0)
+		g_source_remove(writer->results_source);
+	writer->results_source = 0;
+	if(_writer_results(writer, 1) != 0)
+		ret = -1;
+	return ret;
+}
+
+
+/* writer_freeze */
+void writer_freeze(Writer * writer)
+{
+	writer->frozen = 1;
+}
+
+
+/* writer_queue */
+int writer_queue(Writer * writer, Task * task)
+{
+	gint64 now;
+
+	if(task_get_filename(task) == NULL)
+		return -error_set_code(1, "%s", strerror(EINVAL));
+	/* merges with the pending save of the same task if any */
+	g_hash_table_insert(writer->tasks, task, task);
+	/* written all at once when thawed */
+	if(writer->frozen)
+		return 0;
+	if(writer->delay == 0)
+		return writer_flush(writer);
+	/* postponed again with every change, though not indefinitely */
+	now = g_get_monotonic_time();
+	if(writer->source == 0)
+		writer->queued = now;
+	else if(now - writer->queued >= (gint64)writer->delay * 1000
+			* WRITER_WAIT)
+		return 0;
+	else
+		g_source_remove(writer->source);
+	writer->source = g_timeout_add(writer->delay, _writer_on_timeout,
+			writer);
+	return 0;
+}
+
+
+/* writer_remove */
+int writer_remove(Writer * writer, Task * task)
+{
+	/* the pending save of the task is obsolete */
+	g_hash_table_remove(writer->tasks, task);
+	if(task_get_filename(task) == NULL)
+		return -error_set_code(1, "%s", strerror(EINVAL));
+	/* removed after the writes queued, from the journal as well */
+	if(_writer_push(writer, WRITER_OPERATION_REMOVE,
+				task_get_filename(task), task_get_journal(task),
+				NULL) != 0)
+		return -1;
+	if(writer->results_source == 0)
+		writer->results_source = g_timeout_add(WRITER_INTERVAL,
+				_writer_on_results, writer);
+	return 0;
+}
+
+
+/* writer_sync */
+int writer_sync(Writer * writer)
+{
+	if(writer->source != 0)
+		g_source_remove(writer->source);
+	writer->source = 0;
+	if(_writer_dispatch(writer) != 0)
+		return -1;
+	/* the files are not synced individually */
+	if(writer->journal == NULL)
+		return 0;
+	if(_writer_push(writer, WRITER_OPERATION_SYNC, "journal",
+				writer->journal, NULL) != 0)
+		return -1;
+	writer->journal = NULL;
+	if(writer->results_source == 0)
+		writer->results_source = g_timeout_add(WRITER_INTERVAL,
+				_writer_on_results, writer);
+	return 0;
+}
+
+
+/* writer_thaw */
+int writer_thaw(Writer * writer)
+{
+	writer->frozen = 0;
+	if(writer->source != 0)
+		g_source_remove(writer->source);
+	writer->source = 0;
+	/* the results are collected in the background, as usual */
+	return _writer_dispatch(writer);
+}
+
+
+/* private */
+/* functions */
+/* writer_dispatch */
+static int _writer_dispatch(Writer * writer)
+{
+	int ret = 0;
+	GHashTableIter iter;
+	gpointer key;
+	Task * task;
+	Task * copy;
+
+	/* only copy the tasks here, they are saved in the background */
+	g_hash_table_iter_init(&iter, writer->tasks);
+	while(g_hash_table_iter_next(&iter, &key, NULL) == TRUE)
+	{
+		task = key;
+		if(task_get_dirty(task) == 0)
+			continue;
+		if((copy = task_new_copy(task)) == NULL)
+		{
+			writer->callback(task_get_filename(task),
+					error_get(NULL), writer->data);
+			ret = -1;
+			continue;
+		}
+		if(_writer_push(writer, WRITER_OPERATION_SAVE,
+					task_get_filename(task),
+					task_get_journal(task), copy) != 0)
+		{
+			writer->callback(task_get_filename(task),
+					error_get(NULL), writer->data);
+			task_delete(copy);
+			ret = -1;
+			continue;
+		}
+		/* the task is marked as saved until told otherwise */
+		task_set_dirty(task, 0);
+	}
+	g_hash_table_remove_all(writer->tasks);
+	if(writer->outstanding > 0 && writer->results_source == 0)
+		writer->results_source = g_timeout_add(WRITER_INTERVAL,
+				_writer_on_results, writer);
+	return ret;
+}
+
+
+/* writer_error */
+static void _writer_error(WriterJob * job, int error)
+{
+	/* not using error_get(), which is shared with the other threads */
+	if(error == 0)
+		error = EIO;
+	job->error = strdup(g_strerror(error));
+}
+
+
+/* writer_push */
+static int _writer_push(Writer * writer, WriterOperation operation,
+		char const * filename, Journal * journal, Task * task)
+{
+	WriterJob * job;
+	GError * error = NULL;
+
+	if((job = malloc(sizeof(*job))) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	job->operation = operation;
+	if((job->filename = strdup(filename)) == NULL)
+	{
+		free(job);
+		return -error_set_code(1, "%s", strerror(errno));
+	}
+	job->journal = journal;
+	job->task = task;
+	job->error = NULL;
+	job->duration = 0;
+	if(g_thread_pool_push(writer->pool, job, &error) != TRUE)
+	{
+		error_set_code(1, "%s: %s", filename, error->message);
+		g_error_free(error);
+		free(job->filename);
+		free(job);
+		return -1;
+	}
+	/* to be synced eventually */
+	if(journal != NULL && operation != WRITER_OPERATION_SYNC)
+		writer->journal = journal;
+	writer->outstanding++;
+	return 0;
+}
+
+
+/* writer_results */
+static int _writer_results(Writer * writer, int wait)
+{
+	int ret = 0;
+	WriterJob * job;
+
+	while(writer->outstanding > 0)
+	{
+		if(wait)
+			job = g_async_queue_pop(writer->results);
+		else if((job = g_async_queue_try_pop(writer->results)) == NULL)
+			break;
+		writer->outstanding--;
+		writer->latency = job->duration;
+		/* also told of the writes completed */
+		writer->callback(job->filename, job->error, writer->data);
+		if(job->error != NULL)
+			ret = -1;
+		free(job->error);
+		free(job->filename);
+		free(job);
+	}
+	return ret;
+}
+
+
+/* writer_write */
+static int _writer_write(char const * filename, char const * data)
+{
+	char * tmp;
+	char const * p;
+	struct stat st;
+	int fd;
+	size_t size = strlen(data);
+	ssize_t len;
+	int error;
+
+	/* the errors are reported from errno */
+	if((p = strrchr(filename, '/')) != NULL)
+		p++;
+	else
+		p = filename;
+	/* hidden from the directory, and replacing the file only once
+	 * complete */
+	if((tmp = malloc(strlen(filename) + 9)) == NULL)
+		return -1;
+	snprintf(tmp, strlen(filename) + 9, "%.*s.%s.XXXXXX",
+			(int)(p - filename), filename, p);
+	if((fd = mkstemp(tmp)) < 0)
+	{
+		free(tmp);
+		return -1;
+	}
+	for(; size > 0; data += len, size -= len)
+		if((len = write(fd, data, size)) < 0)
+			break;
+	/* keeping the permissions of the file replaced */
+	if(size > 0 || (stat(filename, &st) == 0
+				&& fchmod(fd, st.st_mode & 07777) != 0)
+			|| fsync(fd) != 0)
+	{
+		error = errno;
+		close(fd);
+		unlink(tmp);
+		free(tmp);
+		errno = error;
+		return -1;
+	}
+	if(close(fd) != 0 || rename(tmp, filename) != 0)
+	{
+		error = errno;
+		unlink(tmp);
+		free(tmp);
+		errno = error;
+		return -1;
+	}
+	free(tmp);
+	return 0;
+}
+
+
+/* callbacks */
+/* writer_on_results */
+static gboolean _writer_on_results(gpointer data)
+{
+	Writer * writer = data;
+
+	_writer_results(writer, 0);
+	if(writer->outstanding > 0)
+		return TRUE;
+	writer->results_source = 0;
+	return FALSE;
+}
+
+
+/* writer_on_timeout */
+static gboolean _writer_on_timeout(gpointer data)
+{
+	Writer * writer = data;
+
+	writer->source = 0;
+	_writer_dispatch(writer);
+	return FALSE;
+}
+
+
+/* writer_on_write */
+static void _writer_on_write(gpointer data, gpointer user_data)
+{
+	WriterJob * job = data;
+	Writer * writer = user_data;
+	int res = 0;
+	char * p = NULL;
+	gint64 start = g_get_monotonic_time();
+	char const * name = "write";
+
+	/* runs in the background thread */
+	trace_set_thread("writer");
+	errno = 0;
+	switch(job->operation)
+	{
+		case WRITER_OPERATION_SAVE:
+			/* the description is read first if not in memory */
+			if((p = task_save_data(job->task)) == NULL)
+				res = -1;
+			else if(job->journal != NULL)
+				res = journal_set(job->journal, job->filename,
+						p, strlen(p));
+			else
+				res = _writer_write(job->filename, p);
+			break;
+		case WRITER_OPERATION_REMOVE:
+			name = "unlink";
+			res = (job->journal != NULL)
+				? journal_remove(job->journal, job->filename)
+				: unlink(job->filename);
+			break;
+		case WRITER_OPERATION_SYNC:
+			name = "sync";
+			res = journal_sync(job->journal);
+			break;
+	}
+	if(res != 0)
+		_writer_error(job, errno);
+	string_delete(p);
+	if(job->task != NULL)
+		task_delete(job->task);
+	job->task = NULL;
+	job->duration = g_get_monotonic_time() - start;
+	trace_end(start, "writer", name, job->filename);
+	g_async_queue_push(writer->results, job);
+}
@@ -0,0 +1,65 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#ifndef AUDITOR_WRITER_H
+# define AUDITOR_WRITER_H
+
+# include "task.h"
+
+
+/* Writer */
+/* types */
+typedef struct _Writer Writer;
+
+/* the error is NULL once written successfully */
+typedef void (*WriterCallback)(char const * filename, char const * error,
+		void * data);
+
+
+/* functions */
+Writer * writer_new(unsigned int delay, WriterCallback callback, void * data);
+void writer_delete(Writer * writer);
+
+
+/* accessors */
+unsigned int writer_get_delay(Writer * writer);
+unsigned long long writer_get_latency(Writer * writer);
+size_t writer_get_pending(Writer * writer);
+void writer_set_delay(Writer * writer, unsigned int delay);
+
+
+/* useful */
+int writer_queue(Writer * writer, Task * task);
+void writer_cancel(Writer * writer, Task * task);
+int writer_flush(Writer * writer);
+int writer_remove(Writer * writer, Task * task);
+int writer_sync(Writer * writer);
+void writer_freeze(Writer * writer);
+int writer_thaw(Writer * writer);
+
+#endif /* !AUDITOR_WRITER_H */
@@ -0,0 +1,770 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <gtk/gtk.h>
+#include <System.h>
+
+#include "../src/arena.c"
+#include "../src/datecache.c"
+#include "../src/filter.c"
+#include "../src/journal.c"
+#include "../src/loader.c"
+#include "../src/priority.c"
+#include "../src/search.c"
+#include "../src/task.c"
+#include "../src/taskstore.c"
+#include "../src/trace.c"
+
+#ifndef PROGNAME_BENCHMARK
+# define PROGNAME_BENCHMARK	"benchmark"
+#endif
+
+
+/* private */
+/* types */
+typedef struct _Benchmark
+{
+	/* corpus */
+	size_t count;
+	size_t description;
+	unsigned int done;
+	unsigned int weights[AUDITOR_PRIORITY_COUNT];
+	GRand * rand;
+
+	/* measurements */
+	unsigned int threads;
+	int machine;
+	char const * tag;
+} Benchmark;
+
+
+/* constants */
+static char const * _benchmark_words[] =
+{
+	"access", "account", "audit", "backup", "certificate", "check",
+	"cipher", "client", "configuration", "control", "database",
+	"deprecated", "disk", "domain", "email", "encryption", "finding",
+	"firewall", "group", "hardening", "host", "kernel", "key", "log",
+	"logging", "mail", "network", "package", "password", "patch",
+	"permission", "policy", "port", "privilege", "protocol", "review",
+	"root", "rotation", "server", "service", "session", "shell", "ssh",
+	"storage", "system", "token", "update", "user", "vulnerability",
+	"web"
+};
+
+static char const * _benchmark_filters[] =
+{
+	"done",
+	"priority>=high and not done",
+	"title~\"ssh\" or priority=urgent"
+};
+
+
+/* prototypes */
+static int _benchmark(Benchmark * benchmark);
+static int _benchmark_arena(Benchmark * benchmark, char const * directory);
+static int _benchmark_corpus(Benchmark * benchmark, char const * directory);
+static int _benchmark_escape(Benchmark * benchmark);
+static int _benchmark_load(Benchmark * benchmark, char const * directory);
+static int _benchmark_loader(Benchmark * benchmark, char const * directory,
+		unsigned int threads);
+static int _benchmark_reload(Benchmark * benchmark, char const * directory);
+static void _benchmark_result(Benchmark * benchmark, char const * name,
+		char const * argument, unsigned int threads, size_t count,
+		double duration);
+static void _benchmark_unlink(Benchmark * benchmark,
+		char const * directory);
+
+static char * _corpus_description(Benchmark * benchmark);
+static void _corpus_filename(char * buf, size_t size,
+		char const * directory, size_t i);
+static Task * _corpus_task(Benchmark * benchmark, size_t i);
+
+static int _error(char const * message, int ret);
+static double _now(void);
+static int _usage(void);
+
+
+/* functions */
+/* benchmark */
+static int _benchmark(Benchmark * benchmark)
+{
+	int ret = 0;
+	char directory[] = "/tmp/" PROGNAME_BENCHMARK ".XXXXXX";
+	unsigned int i;
+
+	if(mkdtemp(directory) == NULL)
+		return -_error(directory, 1);
+	if(_benchmark_corpus(benchmark, directory) != 0
+			|| _benchmark_load(benchmark, directory) != 0
+			|| _benchmark_escape(benchmark) != 0)
+		ret = -error_print(PROGNAME_BENCHMARK);
+	/* double the number of threads until the one requested */
+	for(i = 1; ret == 0; i *= 2)
+	{
+		if(i > benchmark->threads)
+			i = benchmark->threads;
+		if((ret = _benchmark_loader(benchmark, directory, i)) != 0)
+			error_print(PROGNAME_BENCHMARK);
+		if(i == benchmark->threads)
+			break;
+	}
+	if(ret == 0 && (ret = _benchmark_reload(benchmark, directory)) != 0)
+		error_print(PROGNAME_BENCHMARK);
+	if(ret == 0 && (ret = _benchmark_arena(benchmark, directory)) != 0)
+		error_print(PROGNAME_BENCHMARK);
+	_benchmark_unlink(benchmark, directory);
+	if(rmdir(directory) != 0)
+		_error(directory, 1);
+	return ret;
+}
+
+
+/* benchmark_arena */
+static void _arena_on_task(Task * task, char const * filename, void * data);
+
+static int _benchmark_arena(Benchmark * benchmark, char const * directory)
+{
+	int ret = 0;
+	char const * names[] = { "malloc", "arena" };
+	size_t i;
+	size_t j;
+	Arena * arena;
+	Loader * loader;
+	GPtrArray * tasks;
+	double before;
+	char filename[256];
+
+	/* a whole generation of tasks, allocated then released */
+	for(i = 0; ret == 0 && i < sizeof(names) / sizeof(*names); i++)
+	{
+		arena = NULL;
+		if((i > 0 && (arena = task_arena_new()) == NULL)
+				|| (loader = loader_new(benchmark->threads))
+				== NULL)
+		{
+			if(arena != NULL)
+				arena_delete(arena);
+			return -1;
+		}
+		loader_set_arena(loader, arena);
+		tasks = g_ptr_array_sized_new(benchmark->count);
+		before = _now();
+		for(j = 0; j < benchmark->count; j++)
+		{
+			_corpus_filename(filename, sizeof(filename), directory,
+					j);
+			if((ret = loader_push(loader, filename)) != 0)
+				break;
+		}
+		while(loader_get_pending(loader) > 0)
+			loader_collect(loader, benchmark->count, 1,
+					_arena_on_task, tasks);
+		_benchmark_result(benchmark, "allocate", names[i],
+				benchmark->threads, tasks->len,
+				_now() - before);
+		loader_delete(loader);
+		before = _now();
+		for(j = 0; j < tasks->len; j++)
+			task_delete(g_ptr_array_index(tasks, j));
+		if(arena != NULL)
+			arena_delete(arena);
+		_benchmark_result(benchmark, "release", names[i], 1,
+				tasks->len, _now() - before);
+		if(ret == 0 && tasks->len != benchmark->count)
+			ret = -error_set_code(1, "%zu: %s", benchmark->count
+					- tasks->len,
+					"Tasks could not be loaded");
+		g_ptr_array_free(tasks, TRUE);
+	}
+	return ret;
+}
+
+static void _arena_on_task(Task * task, char const * filename, void * data)
+{
+	GPtrArray * tasks = data;
+	(void) filename;
+
+	if(task != NULL)
+		g_ptr_array_add(tasks, task);
+}
+
+
+/* benchmark_corpus */
+static int _benchmark_corpus(Benchmark * benchmark, char const * directory)
+{
+	size_t i;
+	char filename[256];
+	Task * task;
+	int res;
+	double before;
+	double duration = 0.0;
+
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if((task = _corpus_task(benchmark, i)) == NULL)
+			return -1;
+		res = task_set_filename(task, filename);
+		before = _now();
+		res |= task_save(task);
+		duration += _now() - before;
+		task_delete(task);
+		if(res != 0)
+			return -1;
+	}
+	_benchmark_result(benchmark, "task_save", NULL, 1, benchmark->count,
+			duration);
+	return 0;
+}
+
+
+/* benchmark_escape */
+static int _benchmark_escape(Benchmark * benchmark)
+{
+	int ret = 0;
+	Task * task;
+	char * description;
+	char * data;
+	size_t i;
+	double before;
+	double escape = 0.0;
+	double unescape = 0.0;
+
+	if((task = task_new()) == NULL)
+		return -1;
+	if((description = _corpus_description(benchmark)) == NULL)
+	{
+		task_delete(task);
+		return -1;
+	}
+	/* serialize then parse the same description back */
+	for(i = 0; ret == 0 && i < benchmark->count; i++)
+	{
+		before = _now();
+		if(task_set_description(task, description) != 0
+				|| (data = task_save_data(task)) == NULL)
+		{
+			ret = -1;
+			break;
+		}
+		escape += _now() - before;
+		before = _now();
+		if(task_load_data(task, data, string_get_length(data)) != 0
+				|| task_get_description(task) == NULL)
+			ret = -1;
+		unescape += _now() - before;
+		string_delete(data);
+	}
+	if(ret == 0)
+	{
+		_benchmark_result(benchmark, "escape", NULL, 1,
+				benchmark->count, escape);
+		_benchmark_result(benchmark, "unescape", NULL, 1,
+				benchmark->count, unescape);
+	}
+	g_free(description);
+	task_delete(task);
+	return ret;
+}
+
+
+/* benchmark_load */
+static int _benchmark_load(Benchmark * benchmark, char const * directory)
+{
+	size_t i;
+	char filename[256];
+	Task * task;
+	double before;
+	double duration;
+
+	before = _now();
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if((task = task_new_from_file(filename)) == NULL)
+			return -1;
+		task_delete(task);
+	}
+	duration = _now() - before;
+	_benchmark_result(benchmark, "task_new_from_file", NULL, 1,
+			benchmark->count, duration);
+	/* without the descriptions, as when populating the list */
+	before = _now();
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if((task = task_new()) == NULL)
+			return -1;
+		if(task_set_filename(task, filename) != 0
+				|| task_load_header(task) != 0)
+		{
+			task_delete(task);
+			return -1;
+		}
+		task_delete(task);
+	}
+	duration = _now() - before;
+	_benchmark_result(benchmark, "task_load_header", NULL, 1,
+			benchmark->count, duration);
+	return 0;
+}
+
+
+/* benchmark_loader */
+static void _loader_on_task(Task * task, char const * filename, void * data);
+
+static int _benchmark_loader(Benchmark * benchmark, char const * directory,
+		unsigned int threads)
+{
+	Loader * loader;
+	double before;
+	size_t i;
+	char filename[256];
+	size_t failed = 0;
+
+	if((loader = loader_new(threads)) == NULL)
+		return -1;
+	before = _now();
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if(loader_push(loader, filename) != 0)
+		{
+			loader_delete(loader);
+			return -1;
+		}
+	}
+	while(loader_get_pending(loader) > 0)
+		loader_collect(loader, benchmark->count, 1, _loader_on_task,
+				&failed);
+	_benchmark_result(benchmark, "loader", NULL, threads,
+			benchmark->count, _now() - before);
+	loader_delete(loader);
+	if(failed > 0)
+		return -error_set_code(1, "%zu: %s", failed,
+				"Tasks could not be loaded");
+	return 0;
+}
+
+static void _loader_on_task(Task * task, char const * filename, void * data)
+{
+	size_t * failed = data;
+	(void) filename;
+
+	if(task == NULL)
+		(*failed)++;
+	else
+		task_delete(task);
+}
+
+
+/* benchmark_reload */
+static void _reload_on_task(Task * task, char const * filename, void * data);
+
+static int _benchmark_reload(Benchmark * benchmark, char const * directory)
+{
+	TaskStore * store;
+	Loader * loader;
+	double before;
+	size_t i;
+	char filename[256];
+	Filter * filter;
+	gint columns[] = { TASKSTORE_COL_TITLE, TASKSTORE_COL_PRIORITY,
+		TASKSTORE_COL_START };
+	char const * names[] = { "title", "priority", "start" };
+
+	/* as auditor_task_reload_all() does, without any view attached */
+	store = taskstore_new();
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store),
+			TASKSTORE_COL_START, GTK_SORT_DESCENDING);
+	if((loader = loader_new(benchmark->threads)) == NULL)
+	{
+		g_object_unref(store);
+		return -1;
+	}
+	before = _now();
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if(loader_push(loader, filename) != 0)
+			break;
+	}
+	while(loader_get_pending(loader) > 0)
+		loader_collect(loader, benchmark->count, 1, _reload_on_task,
+				store);
+	_benchmark_result(benchmark, "reload", NULL, benchmark->threads,
+			taskstore_get_count(store), _now() - before);
+	loader_delete(loader);
+	for(i = 0; i < sizeof(columns) / sizeof(*columns); i++)
+	{
+		before = _now();
+		gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store),
+				columns[i], GTK_SORT_ASCENDING);
+		_benchmark_result(benchmark, "sort", names[i], 1,
+				taskstore_get_count(store), _now() - before);
+	}
+	for(i = 0; i < sizeof(_benchmark_filters)
+			/ sizeof(*_benchmark_filters); i++)
+	{
+		if((filter = filter_new(_benchmark_filters[i])) == NULL)
+			break;
+		taskstore_set_threads(store, benchmark->threads);
+		before = _now();
+		taskstore_set_filter(store, filter);
+		_benchmark_result(benchmark, "filter", _benchmark_filters[i],
+				benchmark->threads, taskstore_get_count(store),
+				_now() - before);
+	}
+	taskstore_set_filter(store, NULL);
+	g_object_unref(store);
+	return (i == sizeof(_benchmark_filters) / sizeof(*_benchmark_filters))
+		? 0 : -1;
+}
+
+static void _reload_on_task(Task * task, char const * filename, void * data)
+{
+	TaskStore * store = data;
+	GtkTreeIter iter;
+	(void) filename;
+
+	if(task != NULL)
+		taskstore_insert(store, &iter, 0, task);
+}
+
+
+/* benchmark_result */
+static void _benchmark_result(Benchmark * benchmark, char const * name,
+		char const * argument, unsigned int threads, size_t count,
+		double duration)
+{
+	double rate = (duration > 0.0) ? count / duration : 0.0;
+	char const * p;
+
+	if(!benchmark->machine)
+	{
+		printf("%s%s%s%s: %zu tasks in %.3f s (%.0f tasks/s, %u"
+				" thread%s)\n", name, (argument != NULL)
+				? " \"" : "", (argument != NULL) ? argument
+				: "", (argument != NULL) ? "\"" : "", count,
+				duration, rate, threads, (threads == 1)
+				? "" : "s");
+		return;
+	}
+	/* one JSON object per line */
+	printf("{\"benchmark\":\"%s\",", name);
+	if(argument != NULL)
+	{
+		fputs("\"argument\":\"", stdout);
+		for(p = argument; *p != '\0'; p++)
+			if(*p == '"' || *p == '\\')
+				printf("\\%c", *p);
+			else
+				putchar(*p);
+		fputs("\",", stdout);
+	}
+	if(benchmark->tag != NULL)
+		printf("\"tag\":\"%s\",", benchmark->tag);
+	printf("\"threads\":%u,\"count\":%zu,\"description\":%zu,"
+			"\"seconds\":%.6f,\"rate\":%.1f}\n", threads, count,
+			benchmark->description, duration, rate);
+}
+
+
+/* benchmark_unlink */
+static void _benchmark_unlink(Benchmark * benchmark, char const * directory)
+{
+	size_t i;
+	char filename[256];
+
+	for(i = 0; i < benchmark->count; i++)
+	{
+		_corpus_filename(filename, sizeof(filename), directory, i);
+		if(unlink(filename) != 0 && errno != ENOENT)
+			_error(filename, 1);
+	}
+}
+
+
+/* corpus */
+/* corpus_description */
+static char * _corpus_description(Benchmark * benchmark)
+{
+	GString * description;
+	size_t size;
+	char const * word;
+
+	if(benchmark->description == 0)
+		return g_strdup("");
+	/* between half and one and a half times the size requested */
+	size = g_rand_int_range(benchmark->rand, benchmark->description / 2,
+			benchmark->description * 3 / 2 + 1);
+	description = g_string_sized_new(size + 16);
+	while(description->len < size)
+	{
+		word = _benchmark_words[g_rand_int_range(benchmark->rand, 0,
+				sizeof(_benchmark_words)
+				/ sizeof(*_benchmark_words))];
+		g_string_append(description, word);
+		/* with the characters to escape */
+		switch(g_rand_int_range(benchmark->rand, 0, 16))
+		{
+			case 0:
+				g_string_append(description, ".\n");
+				break;
+			case 1:
+				g_string_append(description, " C:\\");
+				break;
+			default:
+				g_string_append_c(description, ' ');
+				break;
+		}
+	}
+	return g_string_free(description, FALSE);
+}
+
+
+/* corpus_filename */
+static void _corpus_filename(char * buf, size_t size,
+		char const * directory, size_t i)
+{
+	snprintf(buf, size, "%s/task.%07zu", directory, i);
+}
+
+
+/* corpus_task */
+static Task * _corpus_task(Benchmark * benchmark, size_t i)
+{
+	Task * task;
+	char title[128];
+	size_t len;
+	gint32 words;
+	unsigned int total = 0;
+	unsigned int p;
+	size_t j;
+	time_t start;
+	char * description;
+	int res;
+
+	if((task = task_new()) == NULL)
+		return NULL;
+	/* a few words, numbered to be told apart */
+	len = snprintf(title, sizeof(title), "#%zu", i);
+	for(words = g_rand_int_range(benchmark->rand, 2, 8); words > 0
+			&& len < sizeof(title); words--)
+		len += snprintf(&title[len], sizeof(title) - len, " %s",
+				_benchmark_words[g_rand_int_range(
+					benchmark->rand, 0,
+					sizeof(_benchmark_words)
+					/ sizeof(*_benchmark_words))]);
+	for(j = 0; j < AUDITOR_PRIORITY_COUNT; j++)
+		total += benchmark->weights[j];
+	p = (total > 0) ? g_rand_int_range(benchmark->rand, 0, total) : 0;
+	for(j = 0; j < AUDITOR_PRIORITY_LAST && p >= benchmark->weights[j];
+			j++)
+		p -= benchmark->weights[j];
+	/* started within the last year */
+	start = time(NULL) - g_rand_int_range(benchmark->rand, 0,
+			365 * 24 * 60 * 60);
+	if((description = _corpus_description(benchmark)) == NULL)
+	{
+		task_delete(task);
+		return NULL;
+	}
+	res = task_set_title(task, title);
+	res |= task_set_priority(task, j);
+	res |= task_set_start(task, start);
+	res |= task_set_description(task, description);
+	/* completed within a month */
+	if((unsigned int)g_rand_int_range(benchmark->rand, 0, 100)
+			< benchmark->done)
+	{
+		res |= task_set_done(task, 1);
+		res |= task_set_end(task, start + g_rand_int_range(
+					benchmark->rand, 0, 30 * 24 * 60 * 60));
+	}
+	g_free(description);
+	if(res != 0)
+	{
+		task_delete(task);
+		return NULL;
+	}
+	return task;
+}
+
+
+/* error */
+static int _error(char const * message, int ret)
+{
+	fputs(PROGNAME_BENCHMARK ": ", stderr);
+	perror(message);
+	return ret;
+}
+
+
+/* now */
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_BENCHMARK " [-m][-n count][-j threads]"
+"[-d size][-D done][-p weights][-s seed][-t tag]\n"
+"       " PROGNAME_BENCHMARK " -g directory [-n count][-d size][-D done]"
+"[-p weights][-s seed]\n"
+"  -g	Only generate the tasks into this directory\n"
+"  -m	Output the results in the JSON Lines format\n"
+"  -n	Number of tasks to generate (default: 10000)\n"
+"  -j	Maximum number of threads (default: one per CPU)\n"
+"  -d	Average size of the descriptions, in bytes (default: 256)\n"
+"  -D	Percentage of completed tasks (default: 30)\n"
+"  -p	Weights of the priorities, from unknown to urgent\n"
+"	(default: 10,30,35,20,5)\n"
+"  -s	Seed of the generator (default: 1)\n"
+"  -t	Tag the results, typically with the revision measured\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+static int _main_generate(Benchmark * benchmark, char const * directory);
+static int _main_weights(Benchmark * benchmark, char const * weights);
+
+int main(int argc, char * argv[])
+{
+	int ret;
+	int o;
+	Benchmark benchmark;
+	unsigned long seed = 1;
+	char const * directory = NULL;
+	char * p;
+
+	memset(&benchmark, 0, sizeof(benchmark));
+	benchmark.count = 10000;
+	benchmark.description = 256;
+	benchmark.done = 30;
+	_main_weights(&benchmark, "10,30,35,20,5");
+	while((o = getopt(argc, argv, "D:d:g:j:mn:p:s:t:")) != -1)
+		switch(o)
+		{
+			case 'D':
+				benchmark.done = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0'
+						|| benchmark.done > 100)
+					return _usage();
+				break;
+			case 'd':
+				benchmark.description = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			case 'g':
+				directory = optarg;
+				break;
+			case 'j':
+				benchmark.threads = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			case 'm':
+				benchmark.machine = 1;
+				break;
+			case 'n':
+				benchmark.count = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			case 'p':
+				if(_main_weights(&benchmark, optarg) != 0)
+					return _usage();
+				break;
+			case 's':
+				seed = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			case 't':
+				benchmark.tag = optarg;
+				break;
+			default:
+				return _usage();
+		}
+	if(optind != argc)
+		return _usage();
+	if(benchmark.threads == 0)
+		benchmark.threads = g_get_num_processors();
+	/* the same corpus for the same options */
+	benchmark.rand = g_rand_new_with_seed(seed);
+	ret = (directory != NULL) ? _main_generate(&benchmark, directory)
+		: _benchmark(&benchmark);
+	g_rand_free(benchmark.rand);
+	return (ret == 0) ? 0 : 2;
+}
+
+static int _main_generate(Benchmark * benchmark, char const * directory)
+{
+	if(mkdir(directory, 0777) != 0 && errno != EEXIST)
+		return -_error(directory, 1);
+	if(_benchmark_corpus(benchmark, directory) != 0)
+		return -error_print(PROGNAME_BENCHMARK);
+	return 0;
+}
+
+static int _main_weights(Benchmark * benchmark, char const * weights)
+{
+	unsigned int w[AUDITOR_PRIORITY_COUNT];
+	size_t i;
+	char const * p = weights;
+	char * q;
+
+	/* one weight per priority, separated by commas */
+	for(i = 0; i < AUDITOR_PRIORITY_COUNT; i++)
+	{
+		w[i] = strtoul(p, &q, 10);
+		if(q == p || *q != ((i == AUDITOR_PRIORITY_LAST) ? '\0' : ','))
+			return -1;
+		p = q + 1;
+	}
+	memcpy(benchmark->weights, w, sizeof(w));
+	return 0;
+}
@@ -0,0 +1,253 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <System.h>
+
+#include "../src/arena.c"
+#include "../src/exchange.c"
+#include "../src/filter.c"
+#include "../src/journal.c"
+#include "../src/priority.c"
+#include "../src/task.c"
+#include "../src/trace.c"
+
+#ifndef PROGNAME_EXCHANGE
+# define PROGNAME_EXCHANGE	"exchange"
+#endif
+
+
+/* private */
+/* prototypes */
+static int _exchange(ExchangeFormat format);
+static int _exchange_compare(Task * task, Task * expected);
+static Task * _exchange_task(size_t i);
+
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* constants */
+/* the values which have to be quoted or escaped */
+static const struct
+{
+	char const * title;
+	char const * category;
+	char const * description;
+} _exchange_tasks[] =
+{
+	{ "Plain",		"work",		"Plain description"	},
+	{ "Comma, here",	"a,b",		"One, two, three"	},
+	{ "\"Quoted\" title",	"\"q\"",	"She said \"hi\""	},
+	{ "Back\\slash",	"C:\\tmp",	"Ends with \\"		},
+	{ "Tab\there",		NULL,		"Line 1\nLine 2\r\n"	},
+	{ "Control \x01",	NULL,		"\x1f"			},
+	{ "Caf\xc3\xa9 \xe2\x82\xac", "\xe6\x97\xa5\xe6\x9c\xac",
+		"\xf0\x9f\x98\x80 emoji"				},
+	{ " spaces ",		" ",		"  "			},
+	{ "Trailing,",		"",		""			},
+	{ "'single' \"\"",	"{}[]",		"{\"json\": [1, 2]}"	}
+};
+#define EXCHANGE_TEST_COUNT \
+	(sizeof(_exchange_tasks) / sizeof(*_exchange_tasks))
+
+
+/* functions */
+/* exchange */
+static int _exchange(ExchangeFormat format)
+{
+	int ret = 0;
+	FILE * fp;
+	Exchange * exchange;
+	Task * tasks[EXCHANGE_TEST_COUNT];
+	Task * task;
+	size_t i;
+	int res;
+	char id[16];
+
+	memset(tasks, 0, sizeof(tasks));
+	if((fp = tmpfile()) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	if((exchange = exchange_new(fp, format)) == NULL)
+	{
+		fclose(fp);
+		return -1;
+	}
+	for(i = 0; ret == 0 && i < EXCHANGE_TEST_COUNT; i++)
+	{
+		snprintf(id, sizeof(id), "%zu", i);
+		if((tasks[i] = _exchange_task(i)) == NULL
+				|| exchange_write(exchange, id, tasks[i]) != 0)
+			ret = -1;
+	}
+	exchange_delete(exchange);
+	if(ret == 0 && fflush(fp) != 0)
+		ret = -error_set_code(1, "%s", strerror(errno));
+	if(ret == 0 && (exchange = exchange_new(fp, format)) != NULL)
+	{
+		rewind(fp);
+		for(i = 0; ret == 0; i++)
+		{
+			if((task = task_new()) == NULL)
+			{
+				ret = -1;
+				break;
+			}
+			if((res = exchange_read(exchange, task)) < 0)
+				ret = -1;
+			else if(res == 0 && i != EXCHANGE_TEST_COUNT)
+				ret = -error_set_code(1, "%zu: %s", i,
+						"Records missing");
+			else if(res > 0 && i >= EXCHANGE_TEST_COUNT)
+				ret = -error_set_code(1, "%zu: %s", i,
+						"Unexpected record");
+			else if(res > 0)
+				ret = _exchange_compare(task, tasks[i]);
+			task_delete(task);
+			if(res == 0)
+				break;
+		}
+		exchange_delete(exchange);
+	}
+	else if(ret == 0)
+		ret = -1;
+	for(i = 0; i < EXCHANGE_TEST_COUNT; i++)
+		if(tasks[i] != NULL)
+			task_delete(tasks[i]);
+	fclose(fp);
+	return ret;
+}
+
+
+/* exchange_compare */
+static int _exchange_compare_string(char const * title, char const * name,
+		char const * value, char const * expected);
+
+static int _exchange_compare(Task * task, Task * expected)
+{
+	char const * title = task_get_title(expected);
+
+	if(_exchange_compare_string(title, "title", task_get_title(task),
+				title) != 0
+			|| _exchange_compare_string(title, "category",
+				task_get_category(task),
+				task_get_category(expected)) != 0
+			|| _exchange_compare_string(title, "description",
+				task_get_description(task),
+				task_get_description(expected)) != 0)
+		return -1;
+	if((task_get_done(task) > 0) != (task_get_done(expected) > 0)
+			|| task_get_priority(task)
+			!= task_get_priority(expected)
+			|| task_get_start(task) != task_get_start(expected)
+			|| task_get_end(task) != task_get_end(expected))
+		return -error_set_code(1, "%s: %s", title,
+				"Unexpected attributes");
+	return 0;
+}
+
+static int _exchange_compare_string(char const * title, char const * name,
+		char const * value, char const * expected)
+{
+	/* an empty value is not told apart from a missing one */
+	if(value == NULL)
+		value = "";
+	if(expected == NULL)
+		expected = "";
+	if(strcmp(value, expected) == 0)
+		return 0;
+	return -error_set_code(1, "%s: %s: \"%s\" instead of \"%s\"", title,
+			name, value, expected);
+}
+
+
+/* exchange_task */
+static Task * _exchange_task(size_t i)
+{
+	Task * task;
+	/* whole seconds only */
+	time_t start = 1700000000 + i * 86400;
+
+	if((task = task_new()) == NULL)
+		return NULL;
+	if(task_set_title(task, _exchange_tasks[i].title) != 0
+			|| task_set_category(task, _exchange_tasks[i].category)
+			!= 0
+			|| task_set_description(task,
+				_exchange_tasks[i].description) != 0
+			|| task_set_priority(task, i % AUDITOR_PRIORITY_COUNT)
+			!= 0
+			|| task_set_start(task, start) != 0
+			|| (i % 2 == 0 && task_set_done(task, 1) != 0)
+			|| (i % 2 == 0 && task_set_end(task, start + 3600)
+				!= 0))
+	{
+		task_delete(task);
+		return NULL;
+	}
+	return task;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_EXCHANGE, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_EXCHANGE);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_EXCHANGE "\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret = 0;
+
+	(void) argv;
+
+	if(argc != 1)
+		return _usage();
+	ret |= _test("csv", _exchange(EXCHANGE_FORMAT_CSV));
+	ret |= _test("jsonl", _exchange(EXCHANGE_FORMAT_JSONL));
+	return (ret == 0) ? 0 : 2;
+}
@@ -0,0 +1,286 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#include <gtk/gtk.h>
+#include <System.h>
+
+#include "../src/arena.c"
+#include "../src/datecache.c"
+#include "../src/filter.c"
+#include "../src/journal.c"
+#include "../src/priority.c"
+#include "../src/search.c"
+#include "../src/task.c"
+#include "../src/taskstore.c"
+#include "../src/trace.c"
+
+#ifndef PROGNAME_FILTER
+# define PROGNAME_FILTER	"filter"
+#endif
+
+/* constants */
+/* enough tasks for four filtering threads */
+#define FILTER_TEST_COUNT	(TASKSTORE_FILTER_CHUNK * 4 + 1000)
+#define FILTER_TEST_THREADS	4
+
+
+/* private */
+/* prototypes */
+static int _filter_invalid(void);
+static int _filter_valid(void);
+static int _filter_threads(Task ** tasks, size_t count);
+
+static Task ** _filter_corpus(size_t count);
+
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* constants */
+static char const * _filter_expressions[] =
+{
+	"done",
+	"not done",
+	"priority>=high and not done",
+	"title~\"task 42\" or priority=urgent",
+	"(done or priority<medium) and title~\"7\"",
+	"start < \"2020-01-01\"",
+	"title == \"Task 4096\""
+};
+
+
+/* functions */
+/* filter_invalid */
+static int _filter_invalid(void)
+{
+	char const * expressions[] =
+	{
+		"",
+		"done and",
+		"(done",
+		"done)",
+		"not",
+		"done or or done",
+		"title",
+		"title ~",
+		"unknown = 1",
+		"done = maybe",
+		"priority = x",
+		"((((((((((((((((((((((((((((((((((done"
+			"))))))))))))))))))))))))))))))))))"
+	};
+	size_t i;
+	Filter * filter;
+
+	for(i = 0; i < sizeof(expressions) / sizeof(*expressions); i++)
+		if((filter = filter_new(expressions[i])) != NULL)
+		{
+			filter_delete(filter);
+			return -error_set_code(1, "%s: %s", expressions[i],
+					"Invalid expression accepted");
+		}
+	return 0;
+}
+
+
+/* filter_valid */
+static int _filter_valid(void)
+{
+	int ret = 0;
+	size_t i;
+	Filter * filter;
+	FilterRow row;
+
+	for(i = 0; i < sizeof(_filter_expressions)
+			/ sizeof(*_filter_expressions); i++)
+	{
+		if((filter = filter_new(_filter_expressions[i])) == NULL)
+			return -1;
+		filter_delete(filter);
+	}
+	/* the operators apply as expected */
+	row.done = 0;
+	row.title = "Task 42";
+	row.start = 0;
+	row.end = 0;
+	row.priority = AUDITOR_PRIORITY_HIGH;
+	if((filter = filter_new(_filter_expressions[2])) == NULL)
+		return -1;
+	if(filter_match(filter, &row) == 0)
+		ret = -error_set_code(1, "%s: %s", _filter_expressions[2],
+				"Expected match");
+	row.done = 1;
+	if(ret == 0 && filter_match(filter, &row) != 0)
+		ret = -error_set_code(1, "%s: %s", _filter_expressions[2],
+				"Unexpected match");
+	filter_delete(filter);
+	return ret;
+}
+
+
+/* filter_threads */
+static int _filter_threads(Task ** tasks, size_t count)
+{
+	int ret = 0;
+	TaskStore * store;
+	GtkTreeIter iter;
+	size_t i;
+	size_t j;
+	guint expected;
+	guint single;
+	Filter * filter;
+	FilterRow row;
+
+	store = taskstore_new();
+	for(i = 0; i < count; i++)
+		taskstore_insert(store, &iter, -1, tasks[i]);
+	for(i = 0; ret == 0 && i < sizeof(_filter_expressions)
+			/ sizeof(*_filter_expressions); i++)
+	{
+		if((filter = filter_new(_filter_expressions[i])) == NULL)
+		{
+			ret = -1;
+			break;
+		}
+		for(j = 0, expected = 0; j < count; j++)
+		{
+			row.done = task_get_done(tasks[j]) > 0;
+			row.title = task_get_title(tasks[j]);
+			row.start = task_get_start(tasks[j]);
+			row.end = task_get_end(tasks[j]);
+			row.priority = task_get_priority(tasks[j]);
+			if(filter_match(filter, &row))
+				expected++;
+		}
+		/* the store takes ownership of the filter */
+		taskstore_set_threads(store, 1);
+		taskstore_set_filter(store, filter);
+		single = taskstore_get_count_filtered(store);
+		if((filter = filter_new(_filter_expressions[i])) == NULL)
+		{
+			ret = -1;
+			break;
+		}
+		taskstore_set_threads(store, FILTER_TEST_THREADS);
+		taskstore_set_filter(store, filter);
+		if(single != expected)
+			ret = -error_set_code(1, "%s: %u/%u %s",
+					_filter_expressions[i], single,
+					expected, "matches (single-threaded)");
+		else if(taskstore_get_count_filtered(store) != expected)
+			ret = -error_set_code(1, "%s: %u/%u %s",
+					_filter_expressions[i],
+					taskstore_get_count_filtered(store),
+					expected, "matches (multi-threaded)");
+	}
+	g_object_unref(store);
+	return ret;
+}
+
+
+/* filter_corpus */
+static Task ** _filter_corpus(size_t count)
+{
+	Task ** tasks;
+	size_t i;
+	char title[32];
+	time_t now = time(NULL);
+
+	if((tasks = malloc(sizeof(*tasks) * count)) == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		return NULL;
+	}
+	for(i = 0; i < count; i++)
+	{
+		if((tasks[i] = task_new()) == NULL)
+		{
+			while(i > 0)
+				task_delete(tasks[--i]);
+			free(tasks);
+			return NULL;
+		}
+		snprintf(title, sizeof(title), "Task %zu", i);
+		task_set_title(tasks[i], title);
+		task_set_priority(tasks[i], i % AUDITOR_PRIORITY_COUNT);
+		task_set_start(tasks[i], now - i * 3600);
+		if(i % 3 == 0)
+			task_set_done(tasks[i], 1);
+	}
+	return tasks;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_FILTER, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_FILTER);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_FILTER "\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret = 0;
+	Task ** tasks;
+	size_t i;
+
+	(void) argv;
+
+	if(argc != 1)
+		return _usage();
+	ret |= _test("invalid", _filter_invalid());
+	ret |= _test("valid", _filter_valid());
+	if((tasks = _filter_corpus(FILTER_TEST_COUNT)) == NULL)
+		return error_print(PROGNAME_FILTER);
+	ret |= _test("threads", _filter_threads(tasks, FILTER_TEST_COUNT));
+	for(i = 0; i < FILTER_TEST_COUNT; i++)
+		task_delete(tasks[i]);
+	free(tasks);
+	return (ret == 0) ? 0 : 2;
+}
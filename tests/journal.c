@@ -0,0 +1,254 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <System.h>
+
+#include "../src/journal.c"
+
+#ifndef PROGNAME_JOURNAL
+# define PROGNAME_JOURNAL	"journal"
+#endif
+
+/* constants */
+#define JOURNAL_TEST_COUNT	1000
+
+
+/* private */
+/* prototypes */
+static int _journal(char const * filename);
+static int _journal_check(Journal * journal, char const * id,
+		char const * data);
+static int _journal_compaction(char const * filename);
+static int _journal_torn(char const * filename);
+
+static int _error(char const * message, int ret);
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* functions */
+/* journal */
+static int _journal(char const * filename)
+{
+	int ret = 0;
+
+	ret |= _test("torn tail", _journal_torn(filename));
+	unlink(filename);
+	ret |= _test("compaction", _journal_compaction(filename));
+	unlink(filename);
+	return ret;
+}
+
+
+/* journal_check */
+static int _journal_check(Journal * journal, char const * id,
+		char const * data)
+{
+	int ret;
+	char * d;
+	size_t size;
+
+	if(data == NULL)
+		return journal_has(journal, id) ? -error_set_code(1,
+				"%s: %s", id, "Unexpected record") : 0;
+	if(journal_get(journal, id, &d, &size) != 0)
+		return -1;
+	ret = (size == strlen(data) && memcmp(d, data, size) == 0) ? 0
+		: -error_set_code(1, "%s: %s", id, "Unexpected content");
+	free(d);
+	return ret;
+}
+
+
+/* journal_compaction */
+static int _journal_compaction(char const * filename)
+{
+	Journal * journal;
+	unsigned int i;
+	char data[32];
+	struct stat before;
+	struct stat after;
+
+	/* every record is overwritten many times, one is removed */
+	if((journal = journal_new(filename)) == NULL)
+		return -1;
+	for(i = 0; i < JOURNAL_TEST_COUNT; i++)
+	{
+		snprintf(data, sizeof(data), "title=%u\n", i);
+		if(journal_set(journal, (i % 2) ? "task.odd" : "task.even",
+					data, strlen(data)) != 0
+				|| journal_set(journal, "task.gone", data,
+					strlen(data)) != 0)
+		{
+			journal_delete(journal);
+			return -1;
+		}
+	}
+	if(journal_remove(journal, "task.gone") != 0
+			|| stat(filename, &before) != 0
+			|| journal_compact(journal) != 0
+			|| stat(filename, &after) != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	journal_delete(journal);
+	if(after.st_size >= before.st_size || after.st_size > 128)
+		return -error_set_code(1, "%s: %s", filename,
+				"Not compacted");
+	/* only the latest records remain, also once replayed */
+	if((journal = journal_new(filename)) == NULL)
+		return -1;
+	snprintf(data, sizeof(data), "title=%u\n", JOURNAL_TEST_COUNT - 1);
+	if(_journal_check(journal, "task.odd", data) != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	snprintf(data, sizeof(data), "title=%u\n", JOURNAL_TEST_COUNT - 2);
+	if(_journal_check(journal, "task.even", data) != 0
+			|| _journal_check(journal, "task.gone", NULL) != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	journal_delete(journal);
+	return 0;
+}
+
+
+/* journal_torn */
+static int _journal_torn(char const * filename)
+{
+	Journal * journal;
+	struct stat st;
+	FILE * fp;
+
+	if((journal = journal_new(filename)) == NULL)
+		return -1;
+	if(journal_set(journal, "task.a", "title=A\n", 8) != 0
+			|| journal_set(journal, "task.b", "title=B\n", 8) != 0
+			|| journal_set(journal, "task.a", "title=A2\n", 9) != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	journal_delete(journal);
+	if(stat(filename, &st) != 0)
+		return -error_set_code(1, "%s: %s", filename, strerror(errno));
+	/* as if interrupted while appending */
+	if((fp = fopen(filename, "a")) == NULL)
+		return -error_set_code(1, "%s: %s", filename, strerror(errno));
+	fputs("+ task.c 20 00000000\ntitle=", fp);
+	if(fclose(fp) != 0)
+		return -error_set_code(1, "%s: %s", filename, strerror(errno));
+	/* the torn record is dropped, and the file truncated accordingly */
+	if((journal = journal_new(filename)) == NULL)
+		return -1;
+	if(_journal_check(journal, "task.a", "title=A2\n") != 0
+			|| _journal_check(journal, "task.b", "title=B\n") != 0
+			|| _journal_check(journal, "task.c", NULL) != 0
+			|| journal_set(journal, "task.c", "title=C\n", 8) != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	journal_delete(journal);
+	if((journal = journal_new(filename)) == NULL)
+		return -1;
+	if(_journal_check(journal, "task.c", "title=C\n") != 0)
+	{
+		journal_delete(journal);
+		return -1;
+	}
+	journal_delete(journal);
+	return 0;
+}
+
+
+/* error */
+static int _error(char const * message, int ret)
+{
+	fputs(PROGNAME_JOURNAL ": ", stderr);
+	perror(message);
+	return ret;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_JOURNAL, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_JOURNAL);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_JOURNAL "\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret;
+	char directory[] = "/tmp/" PROGNAME_JOURNAL ".XXXXXX";
+	String * filename;
+
+	(void) argv;
+
+	if(argc != 1)
+		return _usage();
+	if(mkdtemp(directory) == NULL)
+		return _error(directory, 2);
+	if((filename = string_new_append(directory, "/journal", NULL))
+			== NULL)
+		ret = error_print(PROGNAME_JOURNAL);
+	else
+		ret = _journal(filename);
+	string_delete(filename);
+	if(rmdir(directory) != 0)
+		_error(directory, 1);
+	return (ret == 0) ? 0 : 2;
+}
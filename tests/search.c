@@ -0,0 +1,231 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <stdio.h>
+#include <string.h>
+#include <System.h>
+
+#include "../src/search.c"
+
+#ifndef PROGNAME_SEARCH
+# define PROGNAME_SEARCH	"search"
+#endif
+
+
+/* private */
+/* types */
+typedef struct _SearchTest
+{
+	char const * query;
+	char const * matches;	/* the identifiers expected, space-separated */
+} SearchTest;
+
+
+/* prototypes */
+static int _search_corpus(Search * search);
+static int _search_queries(Search * search, SearchTest const * tests,
+		size_t count);
+static int _search_tokens(void);
+
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* constants */
+/* the last identifier lands in another word of the bitmaps */
+static const struct
+{
+	unsigned int id;
+	char const * title;
+	char const * description;
+} _search_documents[] =
+{
+	{ 0,	"Hello World",		"first document"		},
+	{ 1,	"World peace",		"Caf\xc3\xa9 au lait"		},
+	{ 2,	"Worldwide shipping",	NULL				},
+	{ 3,	"Other",		"contains hello in description"	},
+	{ 40,	"Hello again",		"W\xc3\xb6rld-wide, unicode"	}
+};
+
+static const SearchTest _search_prefixes[] =
+{
+	{ "",			"0 1 2 3 40"	},
+	{ "wor",		"0 1 2"		},
+	{ "world",		"0 1 2"		},
+	{ "worldwide",		"2"		},
+	{ "hello",		"0 3 40"	},
+	{ "HELLO wor",		"0"		},
+	{ "hel wor doc",	"0"		},
+	{ "caf\xc3\xa9",	"1"		},
+	{ "CAF\xc3\x89",	"1"		},
+	{ "w\xc3\xb6",		"40"		},
+	{ "missing",		""		},
+	{ "hello missing",	""		}
+};
+
+static const SearchTest _search_updates[] =
+{
+	{ "hello",		"40"		},
+	{ "goodbye",		"0"		},
+	{ "desc",		""		},
+	{ "deliv",		"2"		},
+	{ "fast",		"2"		}
+};
+
+
+/* functions */
+/* search_corpus */
+static int _search_corpus(Search * search)
+{
+	size_t i;
+
+	for(i = 0; i < sizeof(_search_documents) / sizeof(*_search_documents);
+			i++)
+		if(search_set(search, _search_documents[i].id,
+					SEARCH_FIELD_TITLE,
+					_search_documents[i].title) != 0
+				|| search_set(search, _search_documents[i].id,
+					SEARCH_FIELD_DESCRIPTION,
+					_search_documents[i].description) != 0)
+			return -1;
+	return 0;
+}
+
+
+/* search_queries */
+static int _search_queries(Search * search, SearchTest const * tests,
+		size_t count)
+{
+	size_t i;
+	size_t j;
+	unsigned int id;
+	int expected;
+	char matches[64];
+	char buf[16];
+
+	for(i = 0; i < count; i++)
+	{
+		if(search_query(search, tests[i].query) != 0)
+			return -1;
+		snprintf(matches, sizeof(matches), " %s ", tests[i].matches);
+		for(j = 0; j < sizeof(_search_documents)
+				/ sizeof(*_search_documents); j++)
+		{
+			id = _search_documents[j].id;
+			snprintf(buf, sizeof(buf), " %u ", id);
+			expected = (strstr(matches, buf) != NULL);
+			if(search_get_match(search, id) != expected)
+				return -error_set_code(1, "\"%s\": %u: %s",
+						tests[i].query, id, expected
+						? "Match expected"
+						: "Unexpected match");
+		}
+	}
+	return 0;
+}
+
+
+/* search_tokens */
+static int _search_tokens(void)
+{
+	int ret = 0;
+	char * words;
+
+	if((words = search_tokenize("Fast, FAST delivery! Delivery."))
+			== NULL)
+		return -1;
+	if(strcmp(words, "fast delivery") != 0)
+		ret = -error_set_code(1, "\"%s\": %s", words,
+				"Unexpected words");
+	g_free(words);
+	return ret;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_SEARCH, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_SEARCH);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_SEARCH "\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret = 0;
+	Search * search;
+
+	(void) argv;
+
+	if(argc != 1)
+		return _usage();
+	ret |= _test("tokens", _search_tokens());
+	if((search = search_new()) == NULL)
+		return error_print(PROGNAME_SEARCH);
+	if(_search_corpus(search) != 0)
+		ret |= _test("corpus", -1);
+	else
+	{
+		ret |= _test("prefixes", _search_queries(search,
+					_search_prefixes,
+					sizeof(_search_prefixes)
+					/ sizeof(*_search_prefixes)));
+		/* the documents are matched again as they change */
+		search_query(search, "hello");
+		if(search_set(search, 0, SEARCH_FIELD_TITLE, "Goodbye") != 0
+				|| search_set_words(search, 2,
+					SEARCH_FIELD_DESCRIPTION,
+					"fast delivery") != 0)
+			ret |= _test("updates", -1);
+		else
+		{
+			search_remove(search, 3);
+			ret |= _test("updates", _search_queries(search,
+						_search_updates,
+						sizeof(_search_updates)
+						/ sizeof(*_search_updates)));
+		}
+	}
+	search_delete(search);
+	return (ret == 0) ? 0 : 2;
+}
@@ -0,0 +1,322 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+
+#include <sys/stat.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <System.h>
+
+#include "../src/arena.c"
+#include "../src/journal.c"
+#include "../src/priority.c"
+#include "../src/snapshot.c"
+#include "../src/task.c"
+#include "../src/trace.c"
+
+#ifndef PROGNAME_SNAPSHOT
+# define PROGNAME_SNAPSHOT	"snapshot"
+#endif
+
+/* constants */
+#define SNAPSHOT_TEST_COUNT	16
+
+
+/* private */
+/* types */
+typedef struct _SnapshotTest
+{
+	char const * name;
+	size_t offset;		/* of the byte changed, or SIZE_MAX */
+	int value;		/* or -1 to truncate at the offset */
+} SnapshotTest;
+
+
+/* prototypes */
+static int _snapshot(char const * directory);
+static int _snapshot_corrupt(char const * filename, char const * corrupt,
+		SnapshotTest const * test);
+static int _snapshot_corpus(char const * directory, Task ** tasks);
+static int _snapshot_current(char const * filename, Task ** tasks);
+
+static int _error(char const * message, int ret);
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* functions */
+/* snapshot */
+static int _snapshot(char const * directory)
+{
+	int ret = 0;
+	Task * tasks[SNAPSHOT_TEST_COUNT];
+	String * filename;
+	String * corrupt;
+	struct stat st;
+	/* the heap ends with the header of the last task */
+	size_t heap = sizeof(SnapshotHeader) + sizeof(SnapshotRecord)
+		* SNAPSHOT_TEST_COUNT;
+	SnapshotTest const tests[] =
+	{
+		{ "empty", 0, -1 },
+		{ "truncated header", sizeof(SnapshotHeader) - 1, -1 },
+		{ "truncated records", heap - 1, -1 },
+		{ "truncated heap", heap + 1, -1 },
+		{ "magic", offsetof(SnapshotHeader, magic), 'X' },
+		{ "version", offsetof(SnapshotHeader, version), 0xff },
+		{ "count", offsetof(SnapshotHeader, count), 0xff },
+		{ "heap offset", offsetof(SnapshotHeader, heap), 0xff },
+		{ "heap size", offsetof(SnapshotHeader, heap_size) + 3, 0x01 },
+		{ "record filename", sizeof(SnapshotHeader)
+			+ offsetof(SnapshotRecord, filename) + 3, 0x01 },
+		{ "record data", sizeof(SnapshotHeader)
+			+ offsetof(SnapshotRecord, data) + 3, 0x01 },
+		{ "record size", sizeof(SnapshotHeader)
+			+ offsetof(SnapshotRecord, data_size) + 3, 0x01 },
+		{ "heap end", SIZE_MAX, 'X' }
+	};
+	size_t i;
+	char buf[64];
+
+	if((filename = string_new_append(directory, "/snapshot", NULL))
+			== NULL || (corrupt = string_new_append(directory,
+					"/corrupt", NULL)) == NULL)
+	{
+		string_delete(filename);
+		return error_print(PROGNAME_SNAPSHOT);
+	}
+	if(_snapshot_corpus(directory, tasks) != 0
+			|| stat(directory, &st) != 0
+			|| snapshot_write(filename, &st, tasks,
+				SNAPSHOT_TEST_COUNT) != 0)
+		ret = error_print(PROGNAME_SNAPSHOT);
+	else
+	{
+		ret |= _test("current", _snapshot_current(filename, tasks));
+		for(i = 0; i < sizeof(tests) / sizeof(*tests); i++)
+		{
+			snprintf(buf, sizeof(buf), "corrupt %s",
+					tests[i].name);
+			ret |= _test(buf, _snapshot_corrupt(filename, corrupt,
+						&tests[i]));
+		}
+	}
+	for(i = 0; i < SNAPSHOT_TEST_COUNT && tasks[i] != NULL; i++)
+	{
+		unlink(task_get_filename(tasks[i]));
+		task_delete(tasks[i]);
+	}
+	unlink(corrupt);
+	unlink(filename);
+	string_delete(corrupt);
+	string_delete(filename);
+	return ret;
+}
+
+
+/* snapshot_corpus */
+static int _snapshot_corpus(char const * directory, Task ** tasks)
+{
+	size_t i;
+	char buf[64];
+	String * filename;
+
+	memset(tasks, 0, sizeof(*tasks) * SNAPSHOT_TEST_COUNT);
+	for(i = 0; i < SNAPSHOT_TEST_COUNT; i++)
+	{
+		snprintf(buf, sizeof(buf), "/task.%zu", i);
+		if((tasks[i] = task_new()) == NULL
+				|| (filename = string_new_append(directory,
+						buf, NULL)) == NULL)
+			return -1;
+		snprintf(buf, sizeof(buf), "Task %zu", i);
+		/* the stat is only known once parsed again */
+		if(task_set_filename(tasks[i], filename) != 0
+				|| task_set_title(tasks[i], buf) != 0
+				|| task_set_description(tasks[i], buf) != 0
+				|| task_save(tasks[i]) != 0
+				|| task_load_header(tasks[i]) != 0)
+		{
+			string_delete(filename);
+			return -1;
+		}
+		string_delete(filename);
+	}
+	return 0;
+}
+
+
+/* snapshot_corrupt */
+static int _snapshot_corrupt(char const * filename, char const * corrupt,
+		SnapshotTest const * test)
+{
+	int ret = 0;
+	char * data;
+	size_t size;
+	size_t offset;
+	FILE * fp;
+	Snapshot * snapshot;
+
+	if(g_file_get_contents(filename, &data, &size, NULL) != TRUE)
+		return -error_set_code(1, "%s: %s", filename,
+				"Could not read the snapshot");
+	offset = (test->offset == SIZE_MAX) ? size - 1 : test->offset;
+	if(offset >= size)
+		ret = -error_set_code(1, "%s: %s", test->name,
+				"Offset out of the snapshot");
+	else if(test->value < 0)
+		size = offset;
+	else
+		data[offset] ^= test->value;
+	if(ret == 0 && ((fp = fopen(corrupt, "w")) == NULL
+				|| (size > 0 && fwrite(data, size, 1, fp) != 1)
+				|| fclose(fp) != 0))
+		ret = -error_set_code(1, "%s: %s", corrupt, strerror(errno));
+	g_free(data);
+	if(ret != 0)
+		return ret;
+	/* the snapshot must be rejected as a whole */
+	if((snapshot = snapshot_new(corrupt)) == NULL)
+		return 0;
+	snapshot_delete(snapshot);
+	return -error_set_code(1, "%s: %s", test->name,
+			"Corrupt snapshot accepted");
+}
+
+
+/* snapshot_current */
+static int _snapshot_current(char const * filename, Task ** tasks)
+{
+	int ret = 0;
+	Snapshot * snapshot;
+	size_t i;
+	ssize_t j;
+	struct stat st;
+	Task * task;
+	struct timespec ts[2];
+
+	if((snapshot = snapshot_new(filename)) == NULL)
+		return -1;
+	if(snapshot_get_count(snapshot) != SNAPSHOT_TEST_COUNT)
+		ret = -error_set_code(1, "%s: %s", filename, "Tasks missing");
+	for(i = 0; ret == 0 && i < SNAPSHOT_TEST_COUNT; i++)
+	{
+		if(stat(task_get_filename(tasks[i]), &st) != 0)
+			ret = -error_set_code(1, "%s: %s", task_get_filename(
+						tasks[i]), strerror(errno));
+		else if((j = snapshot_lookup(snapshot, task_get_filename(
+							tasks[i]), &st)) < 0
+				|| (task = snapshot_get_task(snapshot, j,
+						NULL)) == NULL)
+			ret = -error_set_code(1, "%s: %s", task_get_filename(
+						tasks[i]), "Not current");
+		else
+		{
+			if(strcmp(task_get_title(task), task_get_title(
+							tasks[i])) != 0)
+				ret = -error_set_code(1, "%s: %s",
+						task_get_filename(tasks[i]),
+						"Unexpected title");
+			task_delete(task);
+		}
+	}
+	/* a file modified since is no longer current */
+	if(ret == 0 && stat(task_get_filename(tasks[0]), &st) == 0)
+	{
+		ts[0] = st.st_atim;
+		ts[1] = st.st_mtim;
+		ts[1].tv_nsec = (ts[1].tv_nsec + 1) % 1000000000;
+		if(utimensat(AT_FDCWD, task_get_filename(tasks[0]), ts, 0)
+				!= 0 || stat(task_get_filename(tasks[0]), &st)
+				!= 0)
+			ret = -error_set_code(1, "%s: %s", task_get_filename(
+						tasks[0]), strerror(errno));
+		else if(snapshot_lookup(snapshot, task_get_filename(tasks[0]),
+					&st) >= 0)
+			ret = -error_set_code(1, "%s: %s", task_get_filename(
+						tasks[0]), "Stale entry");
+	}
+	snapshot_delete(snapshot);
+	return ret;
+}
+
+
+/* error */
+static int _error(char const * message, int ret)
+{
+	fputs(PROGNAME_SNAPSHOT ": ", stderr);
+	perror(message);
+	return ret;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_SNAPSHOT, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_SNAPSHOT);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_SNAPSHOT "\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret;
+	char directory[] = "/tmp/" PROGNAME_SNAPSHOT ".XXXXXX";
+
+	(void) argv;
+
+	if(argc != 1)
+		return _usage();
+	if(mkdtemp(directory) == NULL)
+		return _error(directory, 2);
+	ret = _snapshot(directory);
+	if(rmdir(directory) != 0)
+		_error(directory, 1);
+	return (ret == 0) ? 0 : 2;
+}
@@ -0,0 +1,911 @@
+/* $Id$ */
+/* Copyright (c) 2026 Pierre Pronchery <khorben@defora.org> */
+/* This file is part of DeforaOS Desktop Auditor */
+/* All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ * IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+ * TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ * PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ * TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ * LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ * SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. */
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <errno.h>
+#ifdef __GLIBC__
+# include <malloc.h>
+#endif
+#include <gtk/gtk.h>
+#include <System.h>
+
+#include "../src/arena.c"
+#include "../src/datecache.c"
+#include "../src/filter.c"
+#include "../src/journal.c"
+#include "../src/priority.c"
+#include "../src/search.c"
+#include "../src/task.c"
+#include "../src/taskstore.c"
+#include "../src/trace.c"
+
+#ifndef PROGNAME_TASKSTORE
+# define PROGNAME_TASKSTORE	"taskstore"
+#endif
+
+/* constants */
+#define TASKSTORE_CHECK_COUNT	100
+#define TASKSTORE_PAGE		40
+#define TASKSTORE_SCROLLS	1000
+
+
+/* types */
+/* the columns formerly used by the task list */
+typedef enum _ListStoreColumn
+{
+	LS_COL_TASK = 0,
+	LS_COL_DONE,
+	LS_COL_TITLE,
+	LS_COL_START,
+	LS_COL_DISPLAY_START,
+	LS_COL_END,
+	LS_COL_DISPLAY_END,
+	LS_COL_PRIORITY,
+	LS_COL_DISPLAY_PRIORITY,
+	LS_COL_CATEGORY
+} ListStoreColumn;
+#define LS_COL_LAST LS_COL_CATEGORY
+#define LS_COL_COUNT (LS_COL_LAST + 1)
+
+/* the rows as notified to the views */
+typedef struct _TaskStoreCheck
+{
+	TaskStore * store;
+	GPtrArray * rows;
+	guint signals;
+	int error;
+} TaskStoreCheck;
+
+
+/* private */
+/* prototypes */
+static int _taskstore(size_t count);
+static Task ** _taskstore_corpus(size_t count);
+static GtkTreeModel * _taskstore_liststore(Task ** tasks, size_t count);
+static GtkTreeModel * _taskstore_taskstore(Task ** tasks, size_t count);
+static void _taskstore_report(char const * name, size_t memory,
+		GtkTreeModel * model, size_t count, DateCache * dates);
+static void _taskstore_bulk(TaskStore * store, size_t count);
+static void _taskstore_filtering(TaskStore * store);
+static void _taskstore_search(TaskStore * store, size_t count);
+
+static int _check(Task ** tasks, size_t count);
+
+static size_t _memory(void);
+static double _now(void);
+
+static int _test(char const * name, int res);
+static int _usage(void);
+
+
+/* functions */
+/* taskstore */
+static int _taskstore(size_t count)
+{
+	Task ** tasks;
+	size_t i;
+	size_t memory;
+	GtkTreeModel * model;
+	DateCache * dates;
+
+	if((tasks = _taskstore_corpus(count)) == NULL)
+		return -error_print(PROGNAME_TASKSTORE);
+	memory = _memory();
+	model = _taskstore_liststore(tasks, count);
+	_taskstore_report("GtkListStore", _memory() - memory, model, count,
+			NULL);
+	g_object_unref(model);
+	memory = _memory();
+	model = _taskstore_taskstore(tasks, count);
+	if((dates = datecache_new(1024)) == NULL)
+		error_print(PROGNAME_TASKSTORE);
+	else
+	{
+		_taskstore_report("TaskStore", _memory() - memory, model,
+				count, dates);
+		datecache_delete(dates);
+	}
+	_taskstore_filtering(TASKSTORE(model));
+	_taskstore_search(TASKSTORE(model), count);
+	_taskstore_bulk(TASKSTORE(model), count);
+	g_object_unref(model);
+	for(i = 0; i < count; i++)
+		task_delete(tasks[i]);
+	free(tasks);
+	return 0;
+}
+
+
+/* taskstore_corpus */
+static Task ** _taskstore_corpus(size_t count)
+{
+	Task ** tasks;
+	size_t i;
+	char title[32];
+	time_t now = time(NULL);
+
+	if((tasks = malloc(sizeof(*tasks) * count)) == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		return NULL;
+	}
+	for(i = 0; i < count; i++)
+	{
+		if((tasks[i] = task_new()) == NULL)
+		{
+			while(i > 0)
+				task_delete(tasks[--i]);
+			free(tasks);
+			return NULL;
+		}
+		snprintf(title, sizeof(title), "Task %zu", i);
+		task_set_title(tasks[i], title);
+		task_set_priority(tasks[i], i % AUDITOR_PRIORITY_COUNT);
+		task_set_start(tasks[i], now - i * 60);
+		if(i % 3 == 0)
+			task_set_done(tasks[i], 1);
+	}
+	return tasks;
+}
+
+
+/* taskstore_liststore */
+static GtkTreeModel * _taskstore_liststore(Task ** tasks, size_t count)
+{
+	GtkListStore * store;
+	GtkTreeIter iter;
+	size_t i;
+	time_t start;
+	time_t end;
+	struct tm t;
+	char beginning[32];
+	char completion[32];
+
+	store = gtk_list_store_new(LS_COL_COUNT, G_TYPE_POINTER,
+			G_TYPE_BOOLEAN, G_TYPE_STRING, G_TYPE_UINT64,
+			G_TYPE_STRING, G_TYPE_UINT64, G_TYPE_STRING,
+			G_TYPE_UINT, G_TYPE_STRING, G_TYPE_STRING);
+	for(i = 0; i < count; i++)
+	{
+		beginning[0] = '\0';
+		if((start = task_get_start(tasks[i])) != 0)
+		{
+			localtime_r(&start, &t);
+			strftime(beginning, sizeof(beginning), "%c", &t);
+		}
+		completion[0] = '\0';
+		if((end = task_get_end(tasks[i])) != 0)
+		{
+			localtime_r(&end, &t);
+			strftime(completion, sizeof(completion), "%c", &t);
+		}
+		gtk_list_store_insert(store, &iter, 0);
+		gtk_list_store_set(store, &iter,
+				LS_COL_TASK, tasks[i],
+				LS_COL_DONE, task_get_done(tasks[i]) > 0,
+				LS_COL_TITLE, task_get_title(tasks[i]),
+				LS_COL_START, start,
+				LS_COL_DISPLAY_START, beginning,
+				LS_COL_END, end,
+				LS_COL_DISPLAY_END, completion,
+				LS_COL_PRIORITY, task_get_priority(tasks[i]),
+				LS_COL_DISPLAY_PRIORITY,
+				priority_get_title(task_get_priority(
+						tasks[i])), -1);
+	}
+	return GTK_TREE_MODEL(store);
+}
+
+
+/* taskstore_taskstore */
+static GtkTreeModel * _taskstore_taskstore(Task ** tasks, size_t count)
+{
+	TaskStore * store;
+	GtkTreeIter iter;
+	size_t i;
+
+	store = taskstore_new();
+	for(i = 0; i < count; i++)
+		taskstore_insert(store, &iter, 0, tasks[i]);
+	return GTK_TREE_MODEL(store);
+}
+
+
+/* taskstore_report */
+static void _taskstore_report(char const * name, size_t memory,
+		GtkTreeModel * model, size_t count, DateCache * dates)
+{
+	GtkTreeModel * sort;
+	GtkTreeIter iter;
+	double before;
+	double duration;
+	double worst = 0.0;
+	double total = 0.0;
+	size_t i;
+	size_t j;
+	gboolean done;
+	gchar * title;
+	gchar * start;
+	gchar * end;
+	gchar * priority;
+	guint64 s;
+	guint64 e;
+
+	/* sort the rows as the view does */
+	before = _now();
+	sort = IS_TASKSTORE(model) ? g_object_ref(model)
+		: gtk_tree_model_sort_new_with_model(model);
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(sort),
+			TASKSTORE_COL_TITLE, GTK_SORT_ASCENDING);
+	duration = _now() - before;
+	printf("%s: %zu tasks, %zu bytes (%.1f bytes/task), sorted in %.3f s\n",
+			name, count, memory, (count > 0)
+			? (double)memory / count : 0.0, duration);
+	/* render pages of visible rows at random offsets */
+	srand(count);
+	for(i = 0; count > 0 && i < TASKSTORE_SCROLLS; i++)
+	{
+		before = _now();
+		if(gtk_tree_model_iter_nth_child(sort, &iter, NULL,
+					rand() % count) != TRUE)
+			continue;
+		for(j = 0; j < TASKSTORE_PAGE; j++)
+		{
+			if(dates == NULL)
+			{
+				gtk_tree_model_get(sort, &iter,
+						LS_COL_DONE, &done,
+						LS_COL_TITLE, &title,
+						LS_COL_DISPLAY_START, &start,
+						LS_COL_DISPLAY_END, &end,
+						LS_COL_DISPLAY_PRIORITY,
+						&priority, -1);
+				g_free(start);
+				g_free(end);
+			}
+			else
+			{
+				/* the dates are formatted on demand */
+				gtk_tree_model_get(sort, &iter,
+						TASKSTORE_COL_DONE, &done,
+						TASKSTORE_COL_TITLE, &title,
+						TASKSTORE_COL_START, &s,
+						TASKSTORE_COL_END, &e,
+						TASKSTORE_COL_DISPLAY_PRIORITY,
+						&priority, -1);
+				datecache_format(dates, s);
+				datecache_format(dates, e);
+			}
+			g_free(title);
+			g_free(priority);
+			if(gtk_tree_model_iter_next(sort, &iter) != TRUE)
+				break;
+		}
+		duration = _now() - before;
+		total += duration;
+		if(duration > worst)
+			worst = duration;
+	}
+	printf("%s: %u pages of %u rows, %.1f us/page (worst %.1f us)\n",
+			name, TASKSTORE_SCROLLS, TASKSTORE_PAGE,
+			total * 1000000.0 / TASKSTORE_SCROLLS,
+			worst * 1000000.0);
+	g_object_unref(sort);
+}
+
+
+/* taskstore_bulk */
+static void _bulk_done(TaskStore * store, GtkTreeIter * iters, size_t count,
+		gboolean frozen);
+
+static void _taskstore_bulk(TaskStore * store, size_t count)
+{
+	GtkTreeIter * iters;
+	gboolean valid;
+	size_t i;
+
+	if(count == 0)
+		return;
+	if((iters = malloc(sizeof(*iters) * count)) == NULL)
+	{
+		error_set_code(1, "%s", strerror(errno));
+		error_print(PROGNAME_TASKSTORE);
+		return;
+	}
+	/* the iterators of the store persist as the rows move */
+	valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store), &iters[0]);
+	for(i = 0; valid == TRUE && i + 1 < count; i++)
+	{
+		iters[i + 1] = iters[i];
+		valid = gtk_tree_model_iter_next(GTK_TREE_MODEL(store),
+				&iters[i + 1]);
+	}
+	/* every change moves the row */
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store),
+			TASKSTORE_COL_DONE, GTK_SORT_ASCENDING);
+	_bulk_done(store, iters, (valid == TRUE) ? count : i, FALSE);
+	_bulk_done(store, iters, (valid == TRUE) ? count : i, TRUE);
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(store),
+			GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID,
+			GTK_SORT_ASCENDING);
+	free(iters);
+}
+
+static void _bulk_done(TaskStore * store, GtkTreeIter * iters, size_t count,
+		gboolean frozen)
+{
+	double before;
+	double duration;
+	size_t i;
+	Task * task;
+
+	before = _now();
+	if(frozen)
+		taskstore_freeze(store);
+	for(i = 0; i < count; i++)
+	{
+		task = taskstore_get_task(store, &iters[i]);
+		task_set_done(task, (task_get_done(task) > 0) ? 0 : 1);
+		taskstore_set(store, &iters[i], task);
+	}
+	if(frozen)
+		taskstore_thaw(store);
+	duration = _now() - before;
+	printf("TaskStore: %zu tasks toggled %s in %.3f ms\n", count,
+			frozen ? "in one batch" : "one by one",
+			duration * 1000.0);
+}
+
+
+/* taskstore_filtering */
+static void _taskstore_filtering(TaskStore * store)
+{
+	char const * expressions[] = { "done", "priority>=high and not done",
+		"title~\"task 42\" or priority=urgent" };
+	unsigned int threads[] = { 1, 0 };
+	size_t i;
+	size_t j;
+	Filter * filter;
+	double before;
+	double duration;
+
+	for(i = 0; i < sizeof(expressions) / sizeof(*expressions); i++)
+		for(j = 0; j < sizeof(threads) / sizeof(*threads); j++)
+		{
+			if((filter = filter_new(expressions[i])) == NULL)
+			{
+				error_print(PROGNAME_TASKSTORE);
+				return;
+			}
+			taskstore_set_threads(store, threads[j]);
+			before = _now();
+			taskstore_set_filter(store, filter);
+			duration = _now() - before;
+			printf("TaskStore: filter \"%s\" (%s), %u matches in"
+					" %.3f ms\n", expressions[i],
+					(threads[j] == 1) ? "1 thread"
+					: "threads", taskstore_get_count_filtered(
+						store), duration * 1000.0);
+		}
+	taskstore_set_filter(store, NULL);
+	taskstore_set_threads(store, 0);
+}
+
+
+/* taskstore_search */
+static void _taskstore_search(TaskStore * store, size_t count)
+{
+	char const * queries[] = { "task 4242", "42", "task", "missing" };
+	size_t memory;
+	double before;
+	double duration;
+	size_t i;
+	GtkTreeIter iter;
+	gboolean valid;
+	guint matches;
+
+	memory = _memory();
+	before = _now();
+	while(taskstore_index(store, 1024) > 0);
+	duration = _now() - before;
+	printf("TaskStore: %zu tasks indexed in %.3f s, %zu bytes\n", count,
+			duration, _memory() - memory);
+	for(i = 0; i < sizeof(queries) / sizeof(*queries); i++)
+	{
+		before = _now();
+		taskstore_set_search(store, queries[i]);
+		duration = _now() - before;
+		matches = 0;
+		valid = gtk_tree_model_get_iter_first(GTK_TREE_MODEL(store),
+				&iter);
+		for(; valid == TRUE; valid = gtk_tree_model_iter_next(
+					GTK_TREE_MODEL(store), &iter))
+			if(taskstore_get_match(store, &iter))
+				matches++;
+		printf("TaskStore: search \"%s\", %u matches in %.3f ms\n",
+				queries[i], matches, duration * 1000.0);
+	}
+	taskstore_set_search(store, NULL);
+}
+
+
+/* check */
+static int _check_freeze(TaskStoreCheck * check);
+static int _check_remove(TaskStoreCheck * check);
+static int _check_rows(TaskStoreCheck * check);
+static int _check_set(TaskStoreCheck * check);
+static int _check_sort(TaskStoreCheck * check);
+static int _check_sorted(TaskStoreCheck * check);
+static void _check_on_row_changed(GtkTreeModel * model, GtkTreePath * path,
+		GtkTreeIter * iter, gpointer data);
+static void _check_on_row_deleted(GtkTreeModel * model, GtkTreePath * path,
+		gpointer data);
+static void _check_on_row_inserted(GtkTreeModel * model, GtkTreePath * path,
+		GtkTreeIter * iter, gpointer data);
+static void _check_on_rows_reordered(GtkTreeModel * model,
+		GtkTreePath * path, GtkTreeIter * iter, gpointer new_order,
+		gpointer data);
+
+static int _check(Task ** tasks, size_t count)
+{
+	int ret = 0;
+	TaskStoreCheck check;
+	GtkTreeIter iter;
+	size_t i;
+
+	check.store = taskstore_new();
+	check.rows = g_ptr_array_new();
+	check.signals = 0;
+	check.error = 0;
+	g_signal_connect(check.store, "row-changed", G_CALLBACK(
+				_check_on_row_changed), &check);
+	g_signal_connect(check.store, "row-deleted", G_CALLBACK(
+				_check_on_row_deleted), &check);
+	g_signal_connect(check.store, "row-inserted", G_CALLBACK(
+				_check_on_row_inserted), &check);
+	g_signal_connect(check.store, "rows-reordered", G_CALLBACK(
+				_check_on_rows_reordered), &check);
+	/* at the beginning, at the end and in the middle */
+	for(i = 0; i < count; i++)
+		if(taskstore_insert(check.store, &iter, (i % 3 == 0) ? 0
+					: ((i % 3 == 1) ? -1 : (gint)(i / 2)),
+					tasks[i]) != 0)
+			break;
+	ret |= _test("insert", (i == count) ? _check_rows(&check) : -1);
+	ret |= _test("sort", _check_sort(&check));
+	ret |= _test("set", _check_set(&check));
+	ret |= _test("remove", _check_remove(&check));
+	ret |= _test("freeze", _check_freeze(&check));
+	g_object_unref(check.store);
+	g_ptr_array_free(check.rows, TRUE);
+	return ret;
+}
+
+static int _check_freeze(TaskStoreCheck * check)
+{
+	GtkTreeModel * model = GTK_TREE_MODEL(check->store);
+	GtkTreeIter * iters;
+	guint count = check->rows->len;
+	guint i;
+	Task * task;
+
+	if((iters = malloc(sizeof(*iters) * count)) == NULL)
+		return -error_set_code(1, "%s", strerror(errno));
+	for(i = 0; i < count; i++)
+		gtk_tree_model_iter_nth_child(model, &iters[i], NULL, i);
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(check->store),
+			TASKSTORE_COL_DONE, GTK_SORT_ASCENDING);
+	/* the views are only notified once thawed */
+	check->signals = 0;
+	taskstore_freeze(check->store);
+	for(i = 0; i < count; i += 2)
+	{
+		task = taskstore_get_task(check->store, &iters[i]);
+		task_set_done(task, (task_get_done(task) > 0) ? 0 : 1);
+		taskstore_set(check->store, &iters[i], task);
+	}
+	free(iters);
+	if(check->signals != 0)
+	{
+		taskstore_thaw(check->store);
+		return -error_set_code(1, "%u %s", check->signals,
+				"notifications while frozen");
+	}
+	if(taskstore_thaw(check->store) != 0)
+		return -1;
+	if(check->signals == 0)
+		return -error_set_code(1, "%s", "No notification once thawed");
+	return _check_sorted(check);
+}
+
+static int _check_remove(TaskStoreCheck * check)
+{
+	GtkTreeModel * model = GTK_TREE_MODEL(check->store);
+	GtkTreeIter iter;
+	guint slots = check->store->count;
+	guint removed[3];
+	Task * tasks[3];
+	size_t i;
+	size_t j;
+
+	/* the first, last and another row */
+	for(i = 0; i < sizeof(removed) / sizeof(*removed); i++)
+	{
+		if(gtk_tree_model_iter_nth_child(model, &iter, NULL,
+					(i == 0) ? 0 : ((i == 1)
+						? check->rows->len - 1
+						: check->rows->len / 2))
+				!= TRUE)
+			return -error_set_code(1, "%s", "Row not found");
+		removed[i] = GPOINTER_TO_UINT(iter.user_data);
+		tasks[i] = taskstore_get_task(check->store, &iter);
+		taskstore_remove(check->store, &iter);
+	}
+	if(_check_rows(check) != 0)
+		return -1;
+	/* the slots released are used again */
+	for(i = 0; i < sizeof(removed) / sizeof(*removed); i++)
+	{
+		if(taskstore_insert(check->store, &iter, 0, tasks[i]) != 0)
+			return -1;
+		for(j = 0; j < sizeof(removed) / sizeof(*removed); j++)
+			if(GPOINTER_TO_UINT(iter.user_data) == removed[j])
+				break;
+		if(j == sizeof(removed) / sizeof(*removed))
+			return -error_set_code(1, "%s", "Slot not reused");
+	}
+	if(check->store->count != slots)
+		return -error_set_code(1, "%u/%u %s", check->store->count,
+				slots, "slots");
+	return _check_sorted(check);
+}
+
+static int _check_rows(TaskStoreCheck * check)
+{
+	GtkTreeModel * model = GTK_TREE_MODEL(check->store);
+	GtkTreeIter iter;
+	GtkTreeIter iter2;
+	GtkTreePath * path;
+	gboolean valid;
+	guint i;
+
+	if(check->error != 0)
+		return check->error;
+	if(gtk_tree_model_iter_n_children(model, NULL)
+			!= (gint)check->rows->len)
+		return -error_set_code(1, "%d/%u %s",
+				gtk_tree_model_iter_n_children(model, NULL),
+				check->rows->len, "rows");
+	/* the paths and iterators agree with the notifications */
+	for(valid = gtk_tree_model_get_iter_first(model, &iter), i = 0;
+			valid == TRUE;
+			valid = gtk_tree_model_iter_next(model, &iter), i++)
+	{
+		if(i >= check->rows->len || taskstore_get_task(check->store,
+					&iter) != g_ptr_array_index(
+					check->rows, i))
+			return -error_set_code(1, "%u: %s", i,
+					"Unexpected row");
+		path = gtk_tree_model_get_path(model, &iter);
+		valid = (gtk_tree_path_get_indices(path)[0] == (gint)i
+				&& gtk_tree_model_get_iter(model, &iter2, path)
+				&& iter2.user_data == iter.user_data);
+		gtk_tree_path_free(path);
+		if(valid != TRUE || gtk_tree_model_iter_nth_child(model,
+					&iter2, NULL, i) != TRUE
+				|| iter2.user_data != iter.user_data)
+			return -error_set_code(1, "%u: %s", i,
+					"Unexpected path");
+	}
+	if(i != check->rows->len)
+		return -error_set_code(1, "%u/%u %s", i, check->rows->len,
+				"rows iterated");
+	return 0;
+}
+
+static int _check_set(TaskStoreCheck * check)
+{
+	char const * titles[] = { "A", "Zz", NULL };
+	GtkTreeModel * model = GTK_TREE_MODEL(check->store);
+	GtkTreeIter iter;
+	Task * task;
+	size_t i;
+
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(check->store),
+			TASKSTORE_COL_TITLE, GTK_SORT_ASCENDING);
+	/* to the beginning, to the end, then in place */
+	for(i = 0; i < sizeof(titles) / sizeof(*titles); i++)
+	{
+		gtk_tree_model_iter_nth_child(model, &iter, NULL,
+				check->rows->len / 2);
+		task = taskstore_get_task(check->store, &iter);
+		if(titles[i] != NULL)
+			task_set_title(task, titles[i]);
+		check->signals = 0;
+		if(taskstore_set(check->store, &iter, task) != 0)
+			return -1;
+		/* only this row is notified */
+		if(check->signals != ((titles[i] != NULL) ? 2 : 1))
+			return -error_set_code(1, "%u %s", check->signals,
+					"notifications");
+		if(_check_sorted(check) != 0)
+			return -1;
+	}
+	return 0;
+}
+
+static int _check_sort(TaskStoreCheck * check)
+{
+	TaskStoreColumn columns[] = { TASKSTORE_COL_TITLE, TASKSTORE_COL_DONE,
+		TASKSTORE_COL_START, TASKSTORE_COL_END,
+		TASKSTORE_COL_PRIORITY };
+	GtkSortType orders[] = { GTK_SORT_ASCENDING, GTK_SORT_DESCENDING };
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < sizeof(columns) / sizeof(*columns); i++)
+		for(j = 0; j < sizeof(orders) / sizeof(*orders); j++)
+		{
+			gtk_tree_sortable_set_sort_column_id(
+					GTK_TREE_SORTABLE(check->store),
+					columns[i], orders[j]);
+			if(_check_sorted(check) != 0)
+				return -1;
+		}
+	gtk_tree_sortable_set_sort_column_id(GTK_TREE_SORTABLE(check->store),
+			GTK_TREE_SORTABLE_UNSORTED_SORT_COLUMN_ID,
+			GTK_SORT_ASCENDING);
+	return _check_rows(check);
+}
+
+static int _check_sorted(TaskStoreCheck * check)
+{
+	gint column;
+	GtkSortType order;
+	guint i;
+	Task * a;
+	Task * b;
+	gint res;
+
+	if(_check_rows(check) != 0)
+		return -1;
+	if(gtk_tree_sortable_get_sort_column_id(GTK_TREE_SORTABLE(
+					check->store), &column, &order) != TRUE)
+		return 0;
+	for(i = 1; i < check->rows->len; i++)
+	{
+		a = g_ptr_array_index(check->rows, i - 1);
+		b = g_ptr_array_index(check->rows, i);
+		switch(column)
+		{
+			case TASKSTORE_COL_DONE:
+				res = (task_get_done(a) > 0)
+					- (task_get_done(b) > 0);
+				break;
+			case TASKSTORE_COL_TITLE:
+				res = g_utf8_collate(task_get_title(a),
+						task_get_title(b));
+				break;
+			case TASKSTORE_COL_START:
+				res = (task_get_start(a) > task_get_start(b))
+					- (task_get_start(a)
+							< task_get_start(b));
+				break;
+			case TASKSTORE_COL_END:
+				res = (task_get_end(a) > task_get_end(b))
+					- (task_get_end(a) < task_get_end(b));
+				break;
+			case TASKSTORE_COL_PRIORITY:
+				res = (int)task_get_priority(a)
+					- (int)task_get_priority(b);
+				break;
+			default:
+				res = 0;
+				break;
+		}
+		if((order == GTK_SORT_ASCENDING) ? res > 0 : res < 0)
+			return -error_set_code(1, "%d: %u: %s", column, i,
+					"Rows not sorted");
+	}
+	return 0;
+}
+
+static void _check_on_row_changed(GtkTreeModel * model, GtkTreePath * path,
+		GtkTreeIter * iter, gpointer data)
+{
+	TaskStoreCheck * check = data;
+	gint i = gtk_tree_path_get_indices(path)[0];
+
+	check->signals++;
+	if(i < 0 || (guint)i >= check->rows->len
+			|| g_ptr_array_index(check->rows, i)
+			!= taskstore_get_task(TASKSTORE(model), iter))
+		check->error = -error_set_code(1, "%d: %s", i,
+				"Unexpected row changed");
+}
+
+static void _check_on_row_deleted(GtkTreeModel * model, GtkTreePath * path,
+		gpointer data)
+{
+	TaskStoreCheck * check = data;
+	gint i = gtk_tree_path_get_indices(path)[0];
+	(void) model;
+
+	check->signals++;
+	if(i < 0 || (guint)i >= check->rows->len)
+		check->error = -error_set_code(1, "%d: %s", i,
+				"Unexpected row deleted");
+	else
+		g_ptr_array_remove_index(check->rows, i);
+}
+
+static void _check_on_row_inserted(GtkTreeModel * model, GtkTreePath * path,
+		GtkTreeIter * iter, gpointer data)
+{
+	TaskStoreCheck * check = data;
+	gint i = gtk_tree_path_get_indices(path)[0];
+
+	check->signals++;
+	if(i < 0 || (guint)i > check->rows->len)
+		check->error = -error_set_code(1, "%d: %s", i,
+				"Unexpected row inserted");
+	else
+		g_ptr_array_insert(check->rows, i, taskstore_get_task(
+					TASKSTORE(model), iter));
+}
+
+static void _check_on_rows_reordered(GtkTreeModel * model,
+		GtkTreePath * path, GtkTreeIter * iter, gpointer new_order,
+		gpointer data)
+{
+	TaskStoreCheck * check = data;
+	gint * order = new_order;
+	GPtrArray * rows;
+	gboolean * moved;
+	guint i;
+	(void) model;
+	(void) path;
+	(void) iter;
+
+	check->signals++;
+	/* every former position appears exactly once */
+	rows = g_ptr_array_sized_new(check->rows->len);
+	moved = g_new0(gboolean, check->rows->len);
+	for(i = 0; i < check->rows->len; i++)
+	{
+		if(order[i] < 0 || (guint)order[i] >= check->rows->len
+				|| moved[order[i]])
+		{
+			check->error = -error_set_code(1, "%u: %s", i,
+					"Invalid order");
+			break;
+		}
+		moved[order[i]] = TRUE;
+		g_ptr_array_add(rows, g_ptr_array_index(check->rows,
+					order[i]));
+	}
+	g_free(moved);
+	if(i < check->rows->len)
+	{
+		g_ptr_array_free(rows, TRUE);
+		return;
+	}
+	g_ptr_array_free(check->rows, TRUE);
+	check->rows = rows;
+}
+
+
+/* memory */
+static size_t _memory(void)
+{
+#ifdef __GLIBC__
+# if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33)
+	struct mallinfo2 mi = mallinfo2();
+# else
+	struct mallinfo mi = mallinfo();
+# endif
+
+	return mi.uordblks + mi.hblkhd;
+#else
+	/* XXX not supported */
+	return 0;
+#endif
+}
+
+
+/* now */
+static double _now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1000000000.0;
+}
+
+
+/* test */
+static int _test(char const * name, int res)
+{
+	printf("%s: %s: %s\n", PROGNAME_TASKSTORE, name, (res == 0) ? "PASS"
+			: "FAIL");
+	if(res == 0)
+		return 0;
+	error_print(PROGNAME_TASKSTORE);
+	return 1;
+}
+
+
+/* usage */
+static int _usage(void)
+{
+	fputs("Usage: " PROGNAME_TASKSTORE " [-n count]\n"
+"  -n	Number of tasks to generate (default: 100000)\n", stderr);
+	return 1;
+}
+
+
+/* public */
+/* functions */
+/* main */
+int main(int argc, char * argv[])
+{
+	int ret;
+	int o;
+	size_t count = 100000;
+	char * p;
+	Task ** tasks;
+	size_t i;
+
+	while((o = getopt(argc, argv, "n:")) != -1)
+		switch(o)
+		{
+			case 'n':
+				count = strtoul(optarg, &p, 10);
+				if(optarg[0] == '\0' || *p != '\0')
+					return _usage();
+				break;
+			default:
+				return _usage();
+		}
+	if(optind != argc)
+		return _usage();
+	/* the rows are checked before being measured */
+	if((tasks = _taskstore_corpus(TASKSTORE_CHECK_COUNT)) == NULL)
+		return error_print(PROGNAME_TASKSTORE);
+	ret = _check(tasks, TASKSTORE_CHECK_COUNT);
+	for(i = 0; i < TASKSTORE_CHECK_COUNT; i++)
+		task_delete(tasks[i]);
+	free(tasks);
+	if(ret != 0)
+		return 2;
+	return (_taskstore(count) == 0) ? 0 : 2;
+}
@@ -34,9 +34,22 @@
 #include <stdlib.h>
 #include <Desktop/Mailer/plugin.h>
 
+#include "../src/arena.c"
+#include "../src/bulkedit.c"
+#include "../src/datecache.c"
+#include "../src/exchange.c"
+#include "../src/filter.c"
+#include "../src/journal.c"
+#include "../src/loader.c"
 #include "../src/priority.c"
+#include "../src/search.c"
+#include "../src/snapshot.c"
 #include "../src/task.c"
 #include "../src/taskedit.c"
+#include "../src/taskstore.c"
+#include "../src/trace.c"
+#include "../src/viewedit.c"
+#include "../src/writer.c"
 #include "../src/auditor.c"
 
 